@@ -27,6 +27,7 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/tcp-socket-factory.h"
 #include "bulk-send-application.h"
@@ -64,6 +65,13 @@ BulkSendApplication::GetTypeId (void)
                    TypeIdValue (TcpSocketFactory::GetTypeId ()),
                    MakeTypeIdAccessor (&BulkSendApplication::m_tid),
                    MakeTypeIdChecker ())
+    .AddAttribute ("VirtualPayload",
+                   "Only send byte counts when the socket supports it: the "
+                   "socket does not store the data, and the receiver reads "
+                   "zero-filled data.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&BulkSendApplication::m_virtualPayload),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Tx", "A new packet is created and is sent",
                      MakeTraceSourceAccessor (&BulkSendApplication::m_txTrace),
                      "ns3::Packet::TracedCallback")
@@ -75,7 +83,8 @@ BulkSendApplication::GetTypeId (void)
 BulkSendApplication::BulkSendApplication ()
   : m_socket (0),
     m_connected (false),
-    m_totBytes (0)
+    m_totBytes (0),
+    m_virtualPayload (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -128,6 +137,15 @@ void BulkSendApplication::StartApplication (void) // Called at time specified by
                           "In other words, use TCP instead of UDP.");
         }
 
+      // A socket keeping byte counts only does not hold on to the packets,
+      // so the same packet can be sent over and over
+      m_virtualPacket = 0;
+      if (m_virtualPayload
+          && m_socket->SetAttributeFailSafe ("VirtualPayload", BooleanValue (true)))
+        {
+          m_virtualPacket = Create<Packet> (m_sendSize);
+        }
+
       if (Inet6SocketAddress::IsMatchingType (m_peer))
         {
           m_socket->Bind6 ();
@@ -182,7 +200,15 @@ void BulkSendApplication::SendData (void)
           toSend = std::min (m_sendSize, m_maxBytes - m_totBytes);
         }
       NS_LOG_LOGIC ("sending packet at " << Simulator::Now ());
-      Ptr<Packet> packet = Create<Packet> (toSend);
+      Ptr<Packet> packet;
+      if (m_virtualPacket != 0 && toSend == m_sendSize)
+        {
+          packet = m_virtualPacket;
+        }
+      else
+        {
+          packet = Create<Packet> (toSend);
+        }
       m_txTrace (packet);
       int actual = m_socket->Send (packet);
       if (actual > 0)
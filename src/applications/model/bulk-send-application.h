@@ -64,6 +64,10 @@ class Socket;
  * For example, TCP sockets can be used, but
  * UDP sockets can not be used.
  *
+ * When the VirtualPayload attribute is set and the socket supports it
+ * (see TcpSocketBase::SetVirtualPayload), the socket only counts the bytes
+ * sent, and the same packet is sent over and over instead of a new one
+ * being created each time.
  */
 class BulkSendApplication : public Application
 {
@@ -118,6 +122,8 @@ private:
   uint32_t        m_maxBytes;     //!< Limit total number of bytes sent
   uint32_t        m_totBytes;     //!< Total bytes sent so far
   TypeId          m_tid;          //!< The type of protocol to use.
+  bool            m_virtualPayload; //!< Whether to send byte counts only
+  Ptr<Packet>     m_virtualPacket;  //!< The packet sent, if the socket keeps byte counts only
 
   /// Traced Callback: sent packets
   TracedCallback<Ptr<const Packet> > m_txTrace;
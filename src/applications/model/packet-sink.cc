@@ -30,6 +30,7 @@
 #include "ns3/packet.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/boolean.h"
 #include "packet-sink.h"
 
 namespace ns3 {
@@ -55,6 +56,12 @@ PacketSink::GetTypeId (void)
                    TypeIdValue (UdpSocketFactory::GetTypeId ()),
                    MakeTypeIdAccessor (&PacketSink::m_tid),
                    MakeTypeIdChecker ())
+    .AddAttribute ("VirtualPayload",
+                   "Only receive byte counts when the socket supports it: "
+                   "the data read is zero-filled.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PacketSink::m_virtualPayload),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Rx",
                      "A packet has been received",
                      MakeTraceSourceAccessor (&PacketSink::m_rxTrace),
@@ -68,6 +75,7 @@ PacketSink::PacketSink ()
   NS_LOG_FUNCTION (this);
   m_socket = 0;
   m_totalRx = 0;
+  m_virtualPayload = false;
 }
 
 PacketSink::~PacketSink()
@@ -114,6 +122,11 @@ void PacketSink::StartApplication ()    // Called at time specified by Start
   if (!m_socket)
     {
       m_socket = Socket::CreateSocket (GetNode (), m_tid);
+      if (m_virtualPayload)
+        {
+          // Inherited by the sockets of the accepted connections
+          m_socket->SetAttributeFailSafe ("VirtualPayload", BooleanValue (true));
+        }
       m_socket->Bind (m_local);
       m_socket->Listen ();
       m_socket->ShutdownSend ();
@@ -27,8 +27,11 @@
 #include "pointer.h"
 #include "assert.h"
 #include "log.h"
+#include "boolean.h"
+#include "uinteger.h"
 
 #include <cmath>
+#include <iostream>
 
 
 /**
@@ -53,6 +56,17 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("EnableProfiler",
+                   "Measure the wall-clock time spent in each function and "
+                   "node, and print it at Simulator::Destroy.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DefaultSimulatorImpl::m_profile),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ProfilerRows",
+                   "The maximum number of functions and nodes printed.",
+                   UintegerValue (20),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::m_profileRows),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -73,6 +87,8 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_unscheduledEvents = 0;
   m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
+  m_profile = false;
+  m_profileRows = 20;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
@@ -98,6 +114,10 @@ void
 DefaultSimulatorImpl::Destroy ()
 {
   NS_LOG_FUNCTION (this);
+  if (m_profile)
+    {
+      m_profiler.Print (std::clog, m_profileRows);
+    }
   while (!m_destroyEvents.empty ()) 
     {
       Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
@@ -146,7 +166,14 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (m_profile)
+    {
+      m_profiler.Invoke (next.impl, next.key.m_context);
+    }
+  else
+    {
+      next.impl->Invoke ();
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -414,4 +441,10 @@ DefaultSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+const EventProfiler &
+DefaultSimulatorImpl::GetProfiler (void) const
+{
+  return m_profiler;
+}
+
 } // namespace ns3
@@ -24,6 +24,7 @@
 #include "simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 #include "system-thread.h"
 #include "ns3/system-mutex.h"
 
@@ -43,6 +44,11 @@ namespace ns3 {
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * When the "EnableProfiler" attribute is set, the events are run through
+ * an EventProfiler, and the functions and the nodes ranked by the
+ * wall-clock time spent in their events are printed to std::clog by
+ * Simulator::Destroy.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -78,6 +84,12 @@ public:
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
 
+  /**
+   * Get the profile of the events run so far.
+   * \returns The profiler, which is empty if profiling is not enabled.
+   */
+  const EventProfiler &GetProfiler (void) const;
+
 private:
   virtual void DoDispose (void);
 
@@ -132,6 +144,13 @@ private:
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+
+  /** Whether the events are run through the profiler. */
+  bool m_profile;
+  /** Maximum number of rows of the tables of the profile. */
+  uint32_t m_profileRows;
+  /** The profile of the events. */
+  EventProfiler m_profiler;
 };
 
 } // namespace ns3
@@ -20,6 +20,7 @@
 
 #include "event-impl.h"
 #include "log.h"
+#include <new>
 
 /**
  * \file
@@ -31,6 +32,34 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/** Granularity of the size classes, in bytes. */
+const std::size_t POOL_ALIGN = 16;
+/** Number of size classes; larger events use the system allocator. */
+const std::size_t POOL_CLASSES = 8;
+/**
+ * Maximum number of free blocks kept per size class and thread, above
+ * which freed blocks are returned to the system allocator.
+ */
+const uint32_t POOL_MAX_FREE = 4096;
+
+/** A free block, linked into the free list of its size class. */
+struct FreeBlock
+{
+  FreeBlock *m_next; //!< Next free block of the same size class
+};
+
+#if defined (__GNUC__)
+/** Free lists of the current thread, by size class. */
+__thread FreeBlock *g_freeLists[POOL_CLASSES];
+/** Length of the free lists of the current thread, by size class. */
+__thread uint32_t g_nFree[POOL_CLASSES];
+#define EVENT_IMPL_POOL 1
+#endif
+
+} // anonymous namespace
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -66,4 +95,73 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+const void *
+EventImpl::GetFunction (void) const
+{
+  return 0;
+}
+
+const void *
+EventImpl::GetMethodAddress (const void *method, std::size_t size, const void *object)
+{
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+  // A pointer to member function holds the address of the code, or one
+  // plus the offset of the method in the virtual table, followed by the
+  // adjustment of the this pointer.
+  uintptr_t words[2];
+  if (size != sizeof (words))
+    {
+      return 0;
+    }
+  std::memcpy (words, method, sizeof (words));
+  if ((words[0] & 1) == 0)
+    {
+      return reinterpret_cast<const void *> (words[0]);
+    }
+  const char *self = static_cast<const char *> (object) + words[1];
+  const char *vtable = *reinterpret_cast<const char * const *> (self);
+  return *reinterpret_cast<const void * const *> (vtable + words[0] - 1);
+#else
+  return 0;
+#endif
+}
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+#ifdef EVENT_IMPL_POOL
+  std::size_t sizeClass = (size - 1) / POOL_ALIGN;
+  if (sizeClass < POOL_CLASSES)
+    {
+      FreeBlock *block = g_freeLists[sizeClass];
+      if (block != 0)
+        {
+          g_freeLists[sizeClass] = block->m_next;
+          g_nFree[sizeClass]--;
+          return block;
+        }
+      // Allocate the whole block, to be reusable by any event of this class
+      return ::operator new ((sizeClass + 1) * POOL_ALIGN);
+    }
+#endif
+  return ::operator new (size);
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+#ifdef EVENT_IMPL_POOL
+  std::size_t sizeClass = (size - 1) / POOL_ALIGN;
+  if (sizeClass < POOL_CLASSES && g_nFree[sizeClass] < POOL_MAX_FREE)
+    {
+      FreeBlock *block = static_cast<FreeBlock *> (p);
+      block->m_next = g_freeLists[sizeClass];
+      g_freeLists[sizeClass] = block;
+      g_nFree[sizeClass]++;
+      return;
+    }
+#endif
+  ::operator delete (p);
+}
+
 } // namespace ns3
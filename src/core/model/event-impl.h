@@ -21,6 +21,9 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +43,12 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are allocated from per-thread free lists of fixed size blocks,
+ * one list per size class, so that scheduling and running an event
+ * does not call the system allocator in the steady state. A block
+ * freed by another thread than the one which allocated it is simply
+ * recycled by the freeing thread.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -66,6 +75,61 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Get the function run by this event, to identify the event in
+   * profiles.
+   *
+   * \returns The address of the code of the function or method bound by
+   *          MakeEvent(), or 0 if it is not known.
+   */
+  virtual const void *GetFunction (void) const;
+
+  /**
+   * Get the address of the code of a function.
+   *
+   * \tparam F \deduced The function pointer type.
+   * \param [in] function The function.
+   * \returns The address of the code of the function.
+   */
+  template <typename F>
+  static const void *GetFunctionAddress (F function)
+  {
+    const void *address = 0;
+    std::memcpy (&address, &function, std::min (sizeof (address), sizeof (function)));
+    return address;
+  }
+
+  /**
+   * Get the address of the code of a method, resolving virtual methods
+   * through the virtual table of the object.
+   *
+   * This relies on the representation of pointers to member functions
+   * of the Itanium C++ ABI, and returns 0 on other platforms.
+   *
+   * \param [in] method The pointer to member function.
+   * \param [in] size The size of the pointer to member function.
+   * \param [in] object The object the method is called on, converted to
+   *        the class of the method.
+   * \returns The address of the code of the method, or 0 if it is not known.
+   */
+  static const void *GetMethodAddress (const void *method, std::size_t size,
+                                       const void *object);
+
+  /**
+   * Allocate the memory of an event from the free list of its size class.
+   *
+   * \param [in] size The size of the event, in bytes.
+   * \returns The memory of the event.
+   */
+  static void *operator new (std::size_t size);
+  /**
+   * Return the memory of an event to the free list of its size class.
+   *
+   * \param [in] p The memory of the event.
+   * \param [in] size The size of the event, in bytes.
+   */
+  static void operator delete (void *p, std::size_t size);
+
 protected:
   /**
    * Implementation for Invoke().
@@ -0,0 +1,276 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "event-impl.h"
+#include "log.h"
+#include "ns3/core-config.h"
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+#ifdef HAVE_DLFCN_H
+#include <dlfcn.h>
+#endif
+#if (__GNUC__ >= 3)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * Implementation of class ns3::EventProfiler.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+namespace {
+
+/**
+ * Demangle a C++ symbol.
+ * \param [in] mangled The mangled symbol.
+ * \returns The demangled symbol, or the mangled one if it is not valid.
+ */
+std::string
+Demangle (const char *mangled)
+{
+  std::string name = mangled;
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, NULL, NULL, &status);
+  if (status == 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+#endif
+  return name;
+}
+
+/** Order of the rows of a table, by decreasing time. */
+struct CostOrder
+{
+  /**
+   * Constructor.
+   * \param [in] ns The time of each row.
+   */
+  CostOrder (const std::vector<uint64_t> &ns)
+    : m_ns (ns)
+  {
+  }
+  /**
+   * Compare two rows.
+   * \param [in] a The first row.
+   * \param [in] b The second row.
+   * \returns Whether the first row comes first.
+   */
+  bool operator () (uint32_t a, uint32_t b) const
+  {
+    return m_ns[a] > m_ns[b] || (m_ns[a] == m_ns[b] && a < b);
+  }
+  const std::vector<uint64_t> &m_ns;  //!< Time of each row
+};
+
+} // anonymous namespace
+
+EventProfiler::EventProfiler ()
+  : m_count (0),
+    m_ns (0)
+{
+  NS_LOG_FUNCTION (this);
+  Cost zero = { 0, 0, 0, false };
+  m_noContext = zero;
+  m_last = m_functions.end ();
+}
+
+uint64_t
+EventProfiler::GetNanoseconds (void)
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec now;
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t> (now.tv_sec) * 1000000000 + now.tv_nsec;
+#else
+  return static_cast<uint64_t> (std::clock ()) * (1000000000 / CLOCKS_PER_SEC);
+#endif
+}
+
+void
+EventProfiler::Invoke (EventImpl *event, uint32_t context)
+{
+  if (event->IsCancelled ())
+    {
+      return;
+    }
+
+  // Read before the event runs: the function of a member event may be
+  // found through the vtable of an object which the event deletes
+  const void *function = event->GetFunction ();
+  const void *key = function != 0 ? function : &typeid (*event);
+
+  uint64_t start = GetNanoseconds ();
+  event->Invoke ();
+  uint64_t ns = GetNanoseconds () - start;
+
+  // Most events call the same few functions in turn, so the last entry
+  // is checked before searching the map
+  if (m_last == m_functions.end () || m_last->first != key)
+    {
+      m_last = m_functions.find (key);
+      if (m_last == m_functions.end ())
+        {
+          Cost cost = { 0, 0, &typeid (*event), function != 0 };
+          m_last = m_functions.insert (std::make_pair (key, cost)).first;
+        }
+    }
+  m_last->second.m_count++;
+  m_last->second.m_ns += ns;
+
+  Cost *cost = &m_noContext;
+  if (context != 0xffffffff)
+    {
+      if (context >= m_contexts.size ())
+        {
+          Cost zero = { 0, 0, 0, false };
+          m_contexts.resize (context + 1, zero);
+        }
+      cost = &m_contexts[context];
+    }
+  cost->m_count++;
+  cost->m_ns += ns;
+
+  m_count++;
+  m_ns += ns;
+}
+
+uint64_t
+EventProfiler::GetFunctionCount (const void *function) const
+{
+  Functions::const_iterator i = m_functions.find (function);
+  return i == m_functions.end () ? 0 : i->second.m_count;
+}
+
+uint64_t
+EventProfiler::GetContextCount (uint32_t context) const
+{
+  if (context == 0xffffffff)
+    {
+      return m_noContext.m_count;
+    }
+  return context < m_contexts.size () ? m_contexts[context].m_count : 0;
+}
+
+std::string
+EventProfiler::GetFunctionName (const void *function)
+{
+#ifdef HAVE_DLFCN_H
+  Dl_info info;
+  if (dladdr (function, &info) != 0 && info.dli_sname != 0)
+    {
+      return Demangle (info.dli_sname);
+    }
+#endif
+  std::ostringstream oss;
+  oss << function;
+  return oss.str ();
+}
+
+void
+EventProfiler::PrintTable (std::ostream &os, std::string title,
+                           const std::vector<std::string> &names,
+                           const std::vector<Cost> &costs, uint32_t maxRows) const
+{
+  std::vector<uint64_t> ns;
+  std::vector<uint32_t> rows;
+  for (uint32_t i = 0; i < costs.size (); ++i)
+    {
+      ns.push_back (costs[i].m_ns);
+      rows.push_back (i);
+    }
+  std::sort (rows.begin (), rows.end (), CostOrder (ns));
+
+  os << std::setw (5) << "Rank" << std::setw (12) << "Events"
+     << std::setw (16) << "Time (ns)" << std::setw (8) << "Share"
+     << std::setw (12) << "Mean (ns)" << "  " << title << std::endl;
+  for (uint32_t r = 0; r < rows.size () && r < maxRows; ++r)
+    {
+      const Cost &cost = costs[rows[r]];
+      double share = m_ns > 0 ? 100.0 * cost.m_ns / m_ns : 0;
+      os << std::setw (5) << r + 1 << std::setw (12) << cost.m_count
+         << std::setw (16) << cost.m_ns
+         << std::setw (7) << std::fixed << std::setprecision (1) << share << "%"
+         << std::setw (12) << cost.m_ns / std::max<uint64_t> (cost.m_count, 1)
+         << "  " << names[rows[r]] << std::endl;
+    }
+}
+
+void
+EventProfiler::Print (std::ostream &os, uint32_t maxRows) const
+{
+  NS_LOG_FUNCTION (this << &os << maxRows);
+
+  std::ios::fmtflags flags = os.flags ();
+  std::streamsize precision = os.precision ();
+
+  os << "Event profile: " << m_count << " events, " << m_ns << " ns" << std::endl;
+
+  std::vector<std::string> names;
+  std::vector<Cost> costs;
+  for (Functions::const_iterator i = m_functions.begin (); i != m_functions.end (); ++i)
+    {
+      if (i->second.m_known)
+        {
+          names.push_back (GetFunctionName (i->first));
+        }
+      else
+        {
+          names.push_back ("event " + Demangle (i->second.m_type->name ()));
+        }
+      costs.push_back (i->second);
+    }
+  PrintTable (os, "Function", names, costs, maxRows);
+
+  names.clear ();
+  costs.clear ();
+  for (uint32_t i = 0; i < m_contexts.size (); ++i)
+    {
+      if (m_contexts[i].m_count > 0)
+        {
+          std::ostringstream oss;
+          oss << "node " << i;
+          names.push_back (oss.str ());
+          costs.push_back (m_contexts[i]);
+        }
+    }
+  if (m_noContext.m_count > 0)
+    {
+      names.push_back ("no context");
+      costs.push_back (m_noContext);
+    }
+  PrintTable (os, "Context", names, costs, maxRows);
+
+  os.flags (flags);
+  os.precision (precision);
+}
+
+} // namespace ns3
@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <map>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::EventProfiler.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Measures the wall-clock time spent running events, by function
+ * and by context.
+ *
+ * Each event run through Invoke() is timed with a monotonic clock, and
+ * its cost is added to the function it calls, as returned by
+ * EventImpl::GetFunction(), and to its context, which is the node id for
+ * the events of the nodes. Events whose function is not known are
+ * accounted for by the type of the event. The names of the functions are
+ * only looked up by Print(), so that the cost of profiling an event is
+ * the one of reading the clock twice and updating two counters.
+ */
+class EventProfiler
+{
+public:
+  /** Constructor. */
+  EventProfiler ();
+
+  /**
+   * Run an event, and add its cost to its function and context.
+   *
+   * \param [in] event The event.
+   * \param [in] context The context of the event.
+   */
+  void Invoke (EventImpl *event, uint32_t context);
+
+  /**
+   * Print the functions and the contexts ranked by decreasing time.
+   *
+   * \param [in,out] os The output stream.
+   * \param [in] maxRows The maximum number of rows of each table.
+   */
+  void Print (std::ostream &os, uint32_t maxRows) const;
+
+  /**
+   * Get the number of events run by a function.
+   *
+   * \param [in] function The address of the code of the function.
+   * \returns The number of events.
+   */
+  uint64_t GetFunctionCount (const void *function) const;
+
+  /**
+   * Get the number of events run in a context.
+   *
+   * \param [in] context The context.
+   * \returns The number of events.
+   */
+  uint64_t GetContextCount (uint32_t context) const;
+
+  /**
+   * Get the name of a function, from the symbols of the program.
+   *
+   * \param [in] function The address of the code of the function.
+   * \returns The demangled name of the function, or its address if it
+   *          is not found.
+   */
+  static std::string GetFunctionName (const void *function);
+
+private:
+  /** Cost of a function or of a context. */
+  struct Cost
+  {
+    uint64_t m_count;                 //!< Number of events run
+    uint64_t m_ns;                    //!< Wall-clock time, in nanoseconds
+    const std::type_info *m_type;     //!< Type of the last event run
+    bool m_known;                     //!< Whether the function is known
+  };
+
+  /** Container of the costs by function or event type. */
+  typedef std::map<const void *, Cost> Functions;
+
+  /**
+   * Get the current time of a monotonic clock.
+   * \returns The time, in nanoseconds.
+   */
+  static uint64_t GetNanoseconds (void);
+
+  /**
+   * Print a ranked table of costs.
+   *
+   * \param [in,out] os The output stream.
+   * \param [in] title The title of the last column.
+   * \param [in] names The names of the rows.
+   * \param [in] costs The costs of the rows.
+   * \param [in] maxRows The maximum number of rows.
+   */
+  void PrintTable (std::ostream &os, std::string title,
+                   const std::vector<std::string> &names,
+                   const std::vector<Cost> &costs, uint32_t maxRows) const;
+
+  Functions m_functions;              //!< Costs by function or event type
+  Functions::iterator m_last;         //!< Last function run
+  std::vector<Cost> m_contexts;       //!< Costs by context
+  Cost m_noContext;                   //!< Cost of the events without context
+  uint64_t m_count;                   //!< Number of events run
+  uint64_t m_ns;                      //!< Wall-clock time, in nanoseconds
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
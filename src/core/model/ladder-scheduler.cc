@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+namespace {
+
+/** Maximum number of rungs. */
+const uint32_t MAX_RUNGS = 8;
+/** Maximum number of buckets in a rung. */
+const uint32_t MAX_BUCKETS = 1 << 16;
+/** Number of events of a bucket above which it is split into a child rung. */
+const uint32_t SPLIT_THRESHOLD = 50;
+
+} // anonymous namespace
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topStart (0),
+    m_rungs (MAX_RUNGS),
+    m_nRungs (0),
+    m_qSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+LadderScheduler::IsLater (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return b < a;
+}
+
+LadderScheduler::Bucket *
+LadderScheduler::Locate (uint64_t ts)
+{
+  if (ts >= m_topStart)
+    {
+      return &m_top;
+    }
+  // Each rung covers the time range of the current bucket of the previous one
+  for (uint32_t i = 0; i < m_nRungs; ++i)
+    {
+      Rung &rung = m_rungs[i];
+      if (ts < rung.m_start)
+        {
+          break;
+        }
+      uint64_t index = (ts - rung.m_start) / rung.m_width;
+      if (index >= rung.m_current)
+        {
+          NS_ASSERT (index < rung.m_buckets.size ());
+          return &rung.m_buckets[index];
+        }
+    }
+  return 0;
+}
+
+LadderScheduler::Rung &
+LadderScheduler::AddRung (uint64_t start, uint64_t span, uint32_t nEvents)
+{
+  NS_LOG_FUNCTION (this << start << span << nEvents);
+  NS_ASSERT (m_nRungs < MAX_RUNGS);
+  uint64_t nBuckets = std::min (std::max (nEvents, 1U), MAX_BUCKETS);
+  Rung &rung = m_rungs[m_nRungs++];
+  rung.m_start = start;
+  rung.m_width = (span - 1) / nBuckets + 1;
+  rung.m_current = 0;
+  // Buckets of a rung no longer in use are empty, and keep their capacity
+  rung.m_buckets.resize ((span - 1) / rung.m_width + 1);
+  NS_LOG_LOGIC ("rung " << m_nRungs - 1 << " width=" << rung.m_width << " buckets=" << rung.m_buckets.size ());
+  return rung;
+}
+
+void
+LadderScheduler::Distribute (Rung &rung, Bucket &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      rung.m_buckets[(i->key.m_ts - rung.m_start) / rung.m_width].push_back (*i);
+    }
+  events.clear ();
+}
+
+void
+LadderScheduler::Refill (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (m_bottom.empty ())
+    {
+      if (m_nRungs == 0)
+        {
+          // Build the first rung from the top
+          NS_ASSERT (!m_top.empty ());
+          uint64_t minTs = m_top.front ().key.m_ts;
+          uint64_t maxTs = minTs;
+          for (Bucket::const_iterator i = m_top.begin (); i != m_top.end (); ++i)
+            {
+              minTs = std::min (minTs, i->key.m_ts);
+              maxTs = std::max (maxTs, i->key.m_ts);
+            }
+          Rung &rung = AddRung (minTs, maxTs - minTs + 1, m_top.size ());
+          m_topStart = rung.m_start + rung.m_width * rung.m_buckets.size ();
+          Distribute (rung, m_top);
+        }
+
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.m_current < rung.m_buckets.size ()
+             && rung.m_buckets[rung.m_current].empty ())
+        {
+          rung.m_current++;
+        }
+      if (rung.m_current == rung.m_buckets.size ())
+        {
+          m_nRungs--;
+          continue;
+        }
+
+      Bucket &bucket = rung.m_buckets[rung.m_current];
+      uint64_t bucketStart = rung.m_start + rung.m_current * rung.m_width;
+      rung.m_current++;
+      if (bucket.size () > SPLIT_THRESHOLD && rung.m_width > 1 && m_nRungs < MAX_RUNGS)
+        {
+          // m_rungs never reallocates, so rung and bucket remain valid
+          Rung &child = AddRung (bucketStart, rung.m_width, bucket.size ());
+          Distribute (child, bucket);
+        }
+      else
+        {
+          m_bottom.swap (bucket);
+          std::sort (m_bottom.begin (), m_bottom.end (), IsLater);
+        }
+    }
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  Bucket *bucket = Locate (ev.key.m_ts);
+  if (bucket != 0)
+    {
+      bucket->push_back (ev);
+    }
+  else
+    {
+      m_bottom.insert (std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, IsLater), ev);
+    }
+  m_qSize++;
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_bottom.empty ())
+    {
+      // Refilling the bottom does not change the set of events
+      const_cast<LadderScheduler *> (this)->Refill ();
+    }
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_bottom.empty ())
+    {
+      Refill ();
+    }
+  Scheduler::Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  m_qSize--;
+  NS_LOG_LOGIC ("remove ts=" << ev.key.m_ts << ", key=" << ev.key.m_uid);
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  Bucket *bucket = Locate (ev.key.m_ts);
+  if (bucket != 0)
+    {
+      for (Bucket::iterator i = bucket->begin (); i != bucket->end (); ++i)
+        {
+          if (i->key.m_uid == ev.key.m_uid)
+            {
+              NS_ASSERT (ev.impl == i->impl);
+              // Buckets are not sorted
+              *i = bucket->back ();
+              bucket->pop_back ();
+              m_qSize--;
+              return;
+            }
+        }
+    }
+  else
+    {
+      Bucket::iterator i = std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, IsLater);
+      if (i != m_bottom.end () && i->key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (ev.impl == i->impl);
+          m_bottom.erase (i);
+          m_qSize--;
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+} // namespace ns3
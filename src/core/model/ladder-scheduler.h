@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * "Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Tang, Goh and Thng (2005).
+ *
+ * Events are kept in three tiers:
+ *   - Top: an unsorted vector of the far-future events, i.e. those
+ *     scheduled after the time range covered by the rungs.
+ *   - Rungs: arrays of unsorted buckets. The first rung is built from the
+ *     top when the rungs are empty, with as many buckets as events (up to
+ *     a limit) over the time range of the top events, so the bucket width
+ *     adapts to the event distribution. A bucket holding more than a few
+ *     events is split into a child rung covering the bucket time range.
+ *   - Bottom: a sorted vector of the earliest events, from which events
+ *     are removed.
+ *
+ * Events are stored by value in vectors, whose capacity is reused when
+ * buckets are emptied and rungs rebuilt, so inserting and removing an
+ * event does not allocate memory in the steady state. Insertion and
+ * removal take constant amortized time for most event distributions.
+ *
+ * Removing a specific event, which the simulator only does for
+ * Simulator::Remove, is linear in the number of events of the top.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Unsorted container of events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** An array of buckets of equal width. */
+  struct Rung
+  {
+    uint64_t m_start;              //!< Time stamp of the start of the first bucket
+    uint64_t m_width;              //!< Duration of a bucket, in dimensionless time units
+    uint32_t m_current;            //!< Index of the first bucket not yet dequeued
+    std::vector<Bucket> m_buckets; //!< The buckets
+  };
+
+  /**
+   * Compare (greater than) two events, to keep the bottom sorted with
+   * the earliest event at its end.
+   *
+   * \param [in] a The first event.
+   * \param [in] b The second event.
+   * \returns \c true if \c a is later than \c b
+   */
+  static bool IsLater (const Scheduler::Event &a, const Scheduler::Event &b);
+
+  /**
+   * Find the top or rung bucket holding the events of a time stamp.
+   *
+   * \param [in] ts The time stamp.
+   * \returns The bucket, or 0 if the events belong to the bottom.
+   */
+  Bucket *Locate (uint64_t ts);
+
+  /**
+   * Add a rung covering a time range.
+   *
+   * \param [in] start The start of the time range.
+   * \param [in] span The duration of the time range.
+   * \param [in] nEvents The number of events to store in the rung.
+   * \returns The new rung.
+   */
+  Rung &AddRung (uint64_t start, uint64_t span, uint32_t nEvents);
+
+  /**
+   * Move events into the buckets of a rung.
+   *
+   * \param [in] rung The rung.
+   * \param [in,out] events The events, cleared on return.
+   */
+  void Distribute (Rung &rung, Bucket &events);
+
+  /** Move the earliest bucket of events to the bottom, if it is empty. */
+  void Refill (void);
+
+  /** Far-future events. */
+  Bucket m_top;
+  /** Time stamp from which events go to the top. */
+  uint64_t m_topStart;
+  /** The rungs, of which only the first m_nRungs are in use. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** Earliest events, sorted with the earliest last. */
+  Bucket m_bottom;
+  /** Number of events in queue. */
+  uint32_t m_qSize;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -52,6 +52,10 @@ protected:
     {
       (*m_function)();
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventImpl::GetFunctionAddress (m_function);
+    }
 private:
     F m_function;
   } *ev = new EventFunctionImpl0 (f);
@@ -302,6 +302,28 @@ struct EventMemberImplObjTraits<T *>
   }
 };
 
+/**
+ * \ingroup makeeventmemptr
+ * Helper for the MakeEvent functions which take a class method.
+ *
+ * This helper gets the address of the code of the method called on an
+ * object, converting the object to the class of the method first.
+ *
+ * \tparam M \deduced The method signature.
+ * \tparam C \deduced The class of the method.
+ * \tparam T \deduced The class type of the object.
+ * \param [in] method The method.
+ * \param [in] obj The object the method is called on.
+ * \returns The address of the code of the method, or 0 if it is not known.
+ */
+template <typename M, typename C, typename T>
+const void *
+EventMemberImplGetFunction (M C::*method, T &obj)
+{
+  const C &self = obj;
+  return EventImpl::GetMethodAddress (&method, sizeof (method), &self);
+}
+
 template <typename MEM, typename OBJ>
 EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
 {
@@ -322,6 +344,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)();
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
   } *ev = new EventMemberImpl0 (obj, mem_ptr);
@@ -352,6 +378,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1);
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -383,6 +413,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2);
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -416,6 +450,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -451,6 +489,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -489,6 +531,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -523,6 +569,10 @@ private:
     {
       (*m_function)(m_a1);
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventImpl::GetFunctionAddress (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
   } *ev = new EventFunctionImpl1 (f, a1);
@@ -553,6 +603,10 @@ private:
     {
       (*m_function)(m_a1, m_a2);
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventImpl::GetFunctionAddress (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -586,6 +640,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventImpl::GetFunctionAddress (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -621,6 +679,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventImpl::GetFunctionAddress (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -658,6 +720,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void *GetFunction (void) const
+    {
+      return EventImpl::GetFunctionAddress (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -102,6 +102,7 @@ Object::Object ()
 {
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
+  m_aggregates->cache = 0;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object () 
@@ -124,7 +125,13 @@ Object::~Object ()
   // delete the aggregate list
   if (m_aggregates->n == 0)
     {
-      std::free (m_aggregates);
+      FreeAggregates (m_aggregates);
+    }
+  else if (m_aggregates->cache != 0)
+    {
+      // the cache may point to this object
+      delete [] m_aggregates->cache;
+      m_aggregates->cache = 0;
     }
   m_aggregates = 0;
 }
@@ -136,6 +143,7 @@ Object::Object (const Object &o)
     m_getObjectCount (0)
 {
   m_aggregates->n = 1;
+  m_aggregates->cache = 0;
   m_aggregates->buffer[0] = this;
 }
 void
@@ -152,6 +160,36 @@ Object::DoGetObject (TypeId tid) const
   NS_ASSERT (CheckLoose ());
 
   uint32_t n = m_aggregates->n;
+  uint16_t uid = tid.GetUid ();
+  struct CacheEntry *entry = 0;
+  // A single object is quickly checked, only cache the lookups of aggregates
+  if (n > 1)
+    {
+      if (m_aggregates->cache == 0)
+        {
+          m_aggregates->cache = new struct CacheEntry[CACHE_SIZE] ();
+        }
+      entry = &m_aggregates->cache[uid & (CACHE_SIZE - 1)];
+      if (entry->tid == uid)
+        {
+          Object *current = entry->object;
+          if (current != 0)
+            {
+              // Keep the aggregate array sorted by the number of accesses,
+              // as below, so that the fast path of GetObject finds the
+              // objects looked up most often
+              current->m_getObjectCount++;
+              uint32_t i = 0;
+              while (m_aggregates->buffer[i] != current)
+                {
+                  i++;
+                }
+              UpdateSortedArray (m_aggregates, i);
+            }
+          return current;
+        }
+    }
+
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
     {
@@ -174,11 +212,29 @@ Object::DoGetObject (TypeId tid) const
           // then, update the sort
           UpdateSortedArray (m_aggregates, i);
           // finally, return the match
+          if (entry != 0)
+            {
+              entry->tid = uid;
+              entry->object = current;
+            }
           return const_cast<Object *> (current);
         }
     }
+  if (entry != 0)
+    {
+      entry->tid = uid;
+      entry->object = 0;
+    }
   return 0;
 }
+
+void
+Object::FreeAggregates (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  delete [] aggregates->cache;
+  std::free (aggregates);
+}
 void
 Object::Initialize (void)
 {
@@ -264,6 +320,8 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  // the new list starts with an empty cache
+  aggregates->cache = 0;
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
@@ -307,8 +365,8 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
-  std::free (a);
-  std::free (b);
+  FreeAggregates (a);
+  FreeAggregates (b);
 }
 /**
  * This function must be implemented in the stack that needs to notify
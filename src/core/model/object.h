@@ -316,6 +316,20 @@ private:
   friend class AggregateIterator;
   friend struct ObjectDeleter;
 
+  /** The number of entries in the cache of the DoGetObject() lookups. */
+  static const uint32_t CACHE_SIZE = 16;
+
+  /**
+   * A result of DoGetObject(), stored at the index given by the low bits
+   * of the TypeId uid, which are dense.
+   */
+  struct CacheEntry {
+    /** The uid of the TypeId looked up, or 0 if the entry is unused. */
+    uint16_t tid;
+    /** The matching Object, or 0 if none of the aggregates matches. */
+    Object *object;
+  };
+
   /**
    * The list of Objects aggregated to this one.
    *
@@ -331,13 +345,27 @@ private:
   struct Aggregates {
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /** The cache of the DoGetObject() lookups, or 0 before the first one. */
+    struct CacheEntry *cache;
     /** The array of Objects. */
     Object *buffer[1];
   };
 
+  /**
+   * Free a list of aggregates and its cache.
+   *
+   * \param [in] aggregates The list of aggregated Objects.
+   */
+  static void FreeAggregates (struct Aggregates *aggregates);
+
   /**
    * Find an Object of TypeId tid in the aggregates of this Object.
    *
+   * The result is cached in the list of aggregates, so that it is
+   * found in constant time by the next lookups of the same TypeId
+   * until another Object is aggregated.  Like the sort of the list, the
+   * cache makes the lookups on one aggregate unsafe from several threads.
+   *
    * \param [in] tid The TypeId we're looking for
    * \return The matching Object, if it is found
    */
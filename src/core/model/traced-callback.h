@@ -21,13 +21,15 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <stdint.h>
+#include <vector>
 #include "callback.h"
 
 /**
  * \file
  * \ingroup tracing
- * ns3::TracedCallback declaration and template implementation.
+ * ns3::TracedCallback and ns3::OptionalTracedCallback declaration and
+ * template implementation.
  */
 
 namespace ns3 {
@@ -46,6 +48,17 @@ namespace ns3 {
  * calling one of the \c operator() forms with the appropriate
  * number of arguments.
  *
+ * The chain is stored in a contiguous array, so that calling a
+ * TracedCallback with no Callback connected only compares two
+ * pointers.  A Callback may connect and disconnect Callbacks, itself
+ * included, while the chain runs: the Callbacks it connects are
+ * invoked after it in the same call, and the ones it disconnects are
+ * not invoked from then on, while the others are all invoked once.
+ *
+ * A trace source which is rarely connected and is invoked on a hot
+ * path can be declared as an OptionalTracedCallback instead, which
+ * \c --disable-tracing compiles out.
+ *
  * \tparam T1 \explicit Type of the first argument to the functor.
  * \tparam T2 \explicit Type of the second argument to the functor.
  * \tparam T3 \explicit Type of the third argument to the functor.
@@ -234,10 +247,113 @@ private:
    * \tparam T7 \deduced Type of the seventh argument to the functor.
    * \tparam T8 \deduced Type of the eighth argument to the functor.
    */
-  typedef std::list<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
-  /** The chain of Callbacks. */
+  typedef std::vector<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
+  /**
+   * The chain of Callbacks. A Callback disconnected while the chain runs
+   * is only reset to null, and erased by a later Disconnect, so that the
+   * indexes of the other Callbacks do not change during the call.
+   */
   CallbackList m_callbackList;
+  /** Number of calls of the chain in progress. */
+  mutable uint32_t m_invoking;
+};
+
+/**
+ * \ingroup tracing
+ * \brief A TracedCallback which can be compiled out.
+ *
+ * An OptionalTracedCallback is a TracedCallback, unless ns-3 is
+ * configured with \c --disable-tracing, which defines
+ * \c NS3_TRACING_DISABLE. It then stores no chain of Callbacks,
+ * calling it compiles to nothing, and connecting a Callback to it is a
+ * fatal error, after the signature of the Callback is checked, so that
+ * a script depending on the trace source does not silently see no
+ * events.
+ *
+ * Only the trace sources which are invoked on a hot path and which no
+ * model or helper connects are declared as OptionalTracedCallback, e.g.
+ * most of the sources of PointToPointNetDevice. The other trace sources
+ * keep working with \c --disable-tracing.
+ *
+ * \tparam T1 \explicit Type of the first argument to the functor.
+ * \tparam T2 \explicit Type of the second argument to the functor.
+ * \tparam T3 \explicit Type of the third argument to the functor.
+ * \tparam T4 \explicit Type of the fourth argument to the functor.
+ * \tparam T5 \explicit Type of the fifth argument to the functor.
+ * \tparam T6 \explicit Type of the sixth argument to the functor.
+ * \tparam T7 \explicit Type of the seventh argument to the functor.
+ * \tparam T8 \explicit Type of the eighth argument to the functor.
+ */
+template<typename T1 = empty, typename T2 = empty,
+         typename T3 = empty, typename T4 = empty,
+         typename T5 = empty, typename T6 = empty,
+         typename T7 = empty, typename T8 = empty>
+class OptionalTracedCallback
+#ifndef NS3_TRACING_DISABLE
+  : public TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>
+{
+};
+#else /* NS3_TRACING_DISABLE */
+{
+public:
+  /**
+   * Check the signature of a Callback and fail: the source is compiled out.
+   *
+   * \param [in] callback Callback to connect.
+   */
+  void ConnectWithoutContext (const CallbackBase & callback)
+  {
+    Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> cb;
+    if (!cb.Assign (callback))
+      NS_FATAL_ERROR_NO_MSG();
+    NS_FATAL_ERROR ("cannot connect a trace sink: the source is compiled out (--disable-tracing)");
+  }
+  /**
+   * Check the signature of a Callback and fail: the source is compiled out.
+   *
+   * \param [in] callback Callback to connect.
+   * \param [in] path Context string to provide when invoking the Callback.
+   */
+  void Connect (const CallbackBase & callback, std::string path)
+  {
+    Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
+    if (!cb.Assign (callback))
+      NS_FATAL_ERROR ("when connecting to " << path);
+    NS_FATAL_ERROR ("cannot connect to " << path << ": the source is compiled out (--disable-tracing)");
+  }
+  /**
+   * Do nothing: no Callback can be connected.
+   *
+   * \param [in] callback Callback to remove from the chain.
+   */
+  void DisconnectWithoutContext (const CallbackBase & callback)
+  {
+  }
+  /**
+   * Do nothing: no Callback can be connected.
+   *
+   * \param [in] callback Callback to remove from the chain.
+   * \param [in] path Context path which was used to connect the Callback.
+   */
+  void Disconnect (const CallbackBase & callback, std::string path)
+  {
+  }
+  /**
+   * \name Functors which do nothing.
+   */
+  /**@{*/
+  void operator() (void) const {}
+  void operator() (T1 a1) const {}
+  void operator() (T1 a1, T2 a2) const {}
+  void operator() (T1 a1, T2 a2, T3 a3) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const {}
+  /**@}*/
 };
+#endif /* NS3_TRACING_DISABLE */
 
 } // namespace ns3
 
@@ -253,7 +369,7 @@ template<typename T1, typename T2,
          typename T5, typename T6,
          typename T7, typename T8>
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback ()
-  : m_callbackList () 
+  : m_invoking (0)
 {
 }
 template<typename T1, typename T2,
@@ -291,7 +407,15 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::DisconnectWithoutContext (const Callbac
   for (typename CallbackList::iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); /* empty */)
     {
-      if ((*i).IsEqual (callback))
+      if (m_invoking > 0)
+        {
+          if (!(*i).IsNull () && (*i).IsEqual (callback))
+            {
+              *i = Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> ();
+            }
+          i++;
+        }
+      else if ((*i).IsNull () || (*i).IsEqual (callback))
         {
           i = m_callbackList.erase (i);
         }
@@ -321,11 +445,19 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  m_invoking++;
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)();
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i]();
+        }
     }
+  m_invoking--;
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -334,11 +466,19 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1);
+      return;
     }
+  m_invoking++;
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i](a1);
+        }
+    }
+  m_invoking--;
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -347,11 +487,19 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2);
+      return;
     }
+  m_invoking++;
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i](a1, a2);
+        }
+    }
+  m_invoking--;
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -360,11 +508,19 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2, a3);
+      return;
     }
+  m_invoking++;
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i](a1, a2, a3);
+        }
+    }
+  m_invoking--;
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -373,11 +529,19 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  m_invoking++;
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2, a3, a4);
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i](a1, a2, a3, a4);
+        }
     }
+  m_invoking--;
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -386,11 +550,19 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2, a3, a4, a5);
+      return;
     }
+  m_invoking++;
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i](a1, a2, a3, a4, a5);
+        }
+    }
+  m_invoking--;
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -399,11 +571,19 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2, a3, a4, a5, a6);
+      return;
     }
+  m_invoking++;
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i](a1, a2, a3, a4, a5, a6);
+        }
+    }
+  m_invoking--;
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -412,11 +592,19 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7);
+      return;
+    }
+  m_invoking++;
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i](a1, a2, a3, a4, a5, a6, a7);
+        }
     }
+  m_invoking--;
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -425,11 +613,19 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  m_invoking++;
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7, a8);
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i](a1, a2, a3, a4, a5, a6, a7, a8);
+        }
     }
+  m_invoking--;
 }
 
 } // namespace ns3
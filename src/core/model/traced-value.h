@@ -30,7 +30,8 @@
 /**
  * \file
  * \ingroup tracing
- * ns3::TracedValue declaration and template implementation.
+ * ns3::TracedValue and ns3::OptionalTracedValue declaration and template
+ * implementation.
  */
 
 
@@ -104,6 +105,10 @@ namespace TracedValueCallback {
  * and will define Connect/DisconnectWithoutContext methods to work
  * with MakeTraceSourceAccessor.
  *
+ * A value which is rarely traced and is changed on a hot path can be
+ * declared as an OptionalTracedValue instead, which \c --disable-tracing
+ * compiles down to the underlying value.
+ *
  * \tparam T \explicit The type of the underlying value being traced.
  */
 template <typename T>
@@ -767,6 +772,205 @@ TracedValue<T> operator ! (const TracedValue<T> &lhs) {
 
 /**@}*/  // \ingroup tracing
 
+/**
+ * \ingroup tracing
+ * \brief A TracedValue which can be compiled out.
+ *
+ * An OptionalTracedValue is a TracedValue, unless ns-3 is configured
+ * with \c --disable-tracing, which defines \c NS3_TRACING_DISABLE. It
+ * then holds only the underlying value, setting it is a plain
+ * assignment, and connecting a Callback to it is a fatal error, as for
+ * an OptionalTracedCallback.
+ *
+ * Only the values which are changed on a hot path and which no model
+ * or helper traces are declared as OptionalTracedValue, e.g. some of
+ * the sequence numbers and windows of TcpSocketBase.
+ *
+ * \tparam T \explicit The type of the underlying value being traced.
+ */
+template <typename T>
+class OptionalTracedValue
+#ifndef NS3_TRACING_DISABLE
+  : public TracedValue<T>
+{
+public:
+  /** Default constructor. */
+  OptionalTracedValue ()
+    : TracedValue<T> () {}
+  /**
+   * Construct from an explicit variable.
+   * \param [in] v The variable to trace.
+   */
+  OptionalTracedValue (const T &v)
+    : TracedValue<T> (v) {}
+  /**
+   * Copy from a variable type compatible with this underlying type.
+   * \tparam U \deduced Type of the other variable.
+   * \param [in] other The other variable to copy.
+   */
+  template <typename U>
+  OptionalTracedValue (const U &other)
+    : TracedValue<T> (other) {}
+  /**
+   * Assign a value, which invokes the Callback.
+   * \param [in] v The new value.
+   * \return This OptionalTracedValue.
+   */
+  OptionalTracedValue &operator = (const T &v) {
+    TracedValue<T>::Set (v);
+    return *this;
+  }
+};
+#else /* NS3_TRACING_DISABLE */
+{
+public:
+  /** Default constructor. */
+  OptionalTracedValue ()
+    : m_v () {}
+  /**
+   * Construct from an explicit variable.
+   * \param [in] v The initial value.
+   */
+  OptionalTracedValue (const T &v)
+    : m_v (v) {}
+  /**
+   * Copy from a variable type compatible with this underlying type.
+   * \tparam U \deduced Type of the other variable.
+   * \param [in] other The other variable to copy.
+   */
+  template <typename U>
+  OptionalTracedValue (const U &other)
+    : m_v ((T)other) {}
+  /**
+   * Cast to the underlying type.
+   * \returns The underlying value.
+   */
+  operator T () const {
+    return m_v;
+  }
+  /**
+   * Assign a value.
+   * \param [in] v The new value.
+   * \return This OptionalTracedValue.
+   */
+  OptionalTracedValue &operator = (const T &v) {
+    m_v = v;
+    return *this;
+  }
+  /**
+   * Check the signature of a Callback and fail: the value is compiled out.
+   * \param [in] cb The Callback to connect.
+   */
+  void ConnectWithoutContext (const CallbackBase &cb) {
+    OptionalTracedCallback<T,T> ().ConnectWithoutContext (cb);
+  }
+  /**
+   * Check the signature of a Callback and fail: the value is compiled out.
+   * \param [in] cb The Callback to connect.
+   * \param [in] path The context to bind to the user callback.
+   */
+  void Connect (const CallbackBase &cb, std::string path) {
+    OptionalTracedCallback<T,T> ().Connect (cb, path);
+  }
+  /**
+   * Do nothing: no Callback can be connected.
+   * \param [in] cb The Callback to disconnect.
+   */
+  void DisconnectWithoutContext (const CallbackBase &cb) {
+  }
+  /**
+   * Do nothing: no Callback can be connected.
+   * \param [in] cb The Callback to disconnect.
+   * \param [in] path The context to bind to the user callback.
+   */
+  void Disconnect (const CallbackBase &cb, std::string path) {
+  }
+  /**
+   * Set the value of the underlying variable.
+   * \param [in] v The new value.
+   */
+  void Set (const T &v) {
+    m_v = v;
+  }
+  /**
+   * Get the underlying value.
+   * \returns The value.
+   */
+  T Get (void) const {
+    return m_v;
+  }
+  /**
+   * Increment, decrement and compound assignment operators.
+   * \returns This OptionalTracedValue, or its old value.
+   */
+  /**@{*/
+  OptionalTracedValue &operator++ () {
+    ++m_v;
+    return *this;
+  }
+  OptionalTracedValue &operator-- () {
+    --m_v;
+    return *this;
+  }
+  OptionalTracedValue operator++ (int) {
+    OptionalTracedValue old (*this);
+    m_v++;
+    return old;
+  }
+  OptionalTracedValue operator-- (int) {
+    OptionalTracedValue old (*this);
+    m_v--;
+    return old;
+  }
+  template <typename U>
+  OptionalTracedValue &operator += (const U &rhs) {
+    m_v += rhs;
+    return *this;
+  }
+  template <typename U>
+  OptionalTracedValue &operator -= (const U &rhs) {
+    m_v -= rhs;
+    return *this;
+  }
+  /**@}*/
+
+private:
+  /** The underlying value. */
+  T m_v;
+};
+
+/**
+ * Output streamer for OptionalTracedValue.
+ *
+ * \tparam T \deduced The underlying type of the OptionalTracedValue.
+ * \param [in,out] os The output stream.
+ * \param [in] rhs The OptionalTracedValue to stream.
+ * \returns The stream.
+ */
+template <typename T>
+std::ostream& operator << (std::ostream& os, const OptionalTracedValue<T>& rhs)
+{
+  return os << rhs.Get ();
+}
+
+/**
+ * Addition operator for OptionalTracedValue, as for TracedValue: the
+ * member operators of the underlying type, e.g. SequenceNumber, do not
+ * apply to the OptionalTracedValue itself.
+ *
+ * \tparam T \deduced The underlying type held by the OptionalTracedValue.
+ * \tparam U \deduced The type of the other operand.
+ * \param [in] lhs The left-hand side.
+ * \param [in] rhs The right-hand side.
+ * \returns The result of doing the operator on the underlying values.
+ */
+template <typename T, typename U>
+T operator + (const OptionalTracedValue<T> &lhs, const U &rhs)
+{
+  return lhs.Get () + rhs;
+}
+#endif /* NS3_TRACING_DISABLE */
+
 } // namespace ns3
 
 #endif /* TRACED_VALUE_H */
@@ -357,6 +357,15 @@ AggregateObjectTestCase::DoRun (void)
 
   baseA = baseB->GetObject<BaseA> ();
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
+
+  //
+  // A type which was not found in the aggregation must be found once an
+  // Object of that type is aggregated.
+  //
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<DerivedA> (), 0, "Unexpectedly found a DerivedA through baseB");
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  baseB->AggregateObject (derivedA);
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<DerivedA> (), derivedA, "Cannot GetObject (through baseB) for the new DerivedA Object");
 }
 
 // ===========================================================================
@@ -23,6 +23,9 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/boolean.h"
 
 using namespace ns3;
 
@@ -459,6 +462,77 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SimulatorProfilerTestCase : public TestCase
+{
+public:
+  SimulatorProfilerTestCase ();
+  virtual void Virtual (void);
+  void NonVirtual (uint32_t count);
+private:
+  virtual void DoRun (void);
+};
+
+SimulatorProfilerTestCase::SimulatorProfilerTestCase ()
+  : TestCase ("Check the event profiler of the default simulator")
+{
+}
+
+void
+SimulatorProfilerTestCase::Virtual (void)
+{
+}
+
+void
+SimulatorProfilerTestCase::NonVirtual (uint32_t count)
+{
+  if (count > 0)
+    {
+      Simulator::ScheduleWithContext (count, MicroSeconds (1), &SimulatorProfilerTestCase::NonVirtual, this, count - 1);
+    }
+}
+
+static void
+ProfiledFunction (void)
+{
+}
+
+void
+SimulatorProfilerTestCase::DoRun (void)
+{
+  Ptr<DefaultSimulatorImpl> impl = CreateObject<DefaultSimulatorImpl> ();
+  impl->SetAttribute ("EnableProfiler", BooleanValue (true));
+  Simulator::SetImplementation (impl);
+
+  Simulator::Schedule (MicroSeconds (1), &SimulatorProfilerTestCase::Virtual, this);
+  Simulator::Schedule (MicroSeconds (2), &SimulatorProfilerTestCase::Virtual, this);
+  Simulator::ScheduleWithContext (3, MicroSeconds (1), &SimulatorProfilerTestCase::NonVirtual, this, 2);
+  Simulator::Schedule (MicroSeconds (3), &ProfiledFunction);
+  EventId cancelled = Simulator::Schedule (MicroSeconds (4), &ProfiledFunction);
+  Simulator::Cancel (cancelled);
+  Simulator::Run ();
+
+  const EventProfiler &profiler = impl->GetProfiler ();
+  void (SimulatorProfilerTestCase::*nonVirtual) (uint32_t) = &SimulatorProfilerTestCase::NonVirtual;
+  const void *nonVirtualAddress = EventImpl::GetMethodAddress (&nonVirtual, sizeof (nonVirtual), this);
+  if (nonVirtualAddress != 0)
+    {
+      void (SimulatorProfilerTestCase::*virt) (void) = &SimulatorProfilerTestCase::Virtual;
+      const void *virtualAddress = EventImpl::GetMethodAddress (&virt, sizeof (virt), this);
+      NS_TEST_EXPECT_MSG_EQ (profiler.GetFunctionCount (virtualAddress), 2, "Wrong number of virtual method events");
+      NS_TEST_EXPECT_MSG_EQ (profiler.GetFunctionCount (nonVirtualAddress), 3, "Wrong number of method events");
+      NS_TEST_EXPECT_MSG_NE (EventProfiler::GetFunctionName (virtualAddress).find ("SimulatorProfilerTestCase::Virtual"),
+                             std::string::npos, "Virtual method not found");
+    }
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetFunctionCount (EventImpl::GetFunctionAddress (&ProfiledFunction)), 1,
+                         "Cancelled events are not profiled");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetContextCount (3), 1, "Wrong number of events in context 3");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetContextCount (1), 1, "Wrong number of events in context 1");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetContextCount (0), 0, "Wrong number of events in context 0");
+
+  impl->SetAttribute ("EnableProfiler", BooleanValue (false));
+  Simulator::Destroy ();
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +549,8 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorProfilerTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
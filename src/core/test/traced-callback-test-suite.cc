@@ -18,6 +18,7 @@
 
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
 
 using namespace ns3;
 
@@ -108,6 +109,192 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class ReentrantTracedCallbackTestCase : public TestCase
+{
+public:
+  ReentrantTracedCallbackTestCase ();
+  virtual ~ReentrantTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbOne (void);
+  void CbTwo (void);
+  void CbThree (void);
+  void ConnectTwo (void);
+  void DisconnectSelf (void);
+  void DisconnectOne (void);
+  void DisconnectThree (void);
+
+  TracedCallback<> m_trace;
+  uint32_t m_one;
+  uint32_t m_two;
+  uint32_t m_three;
+};
+
+ReentrantTracedCallbackTestCase::ReentrantTracedCallbackTestCase ()
+  : TestCase ("Check connecting and disconnecting Callbacks from inside a Callback")
+{
+}
+
+void
+ReentrantTracedCallbackTestCase::CbOne (void)
+{
+  m_one++;
+}
+
+void
+ReentrantTracedCallbackTestCase::CbTwo (void)
+{
+  m_two++;
+}
+
+void
+ReentrantTracedCallbackTestCase::CbThree (void)
+{
+  m_three++;
+}
+
+void
+ReentrantTracedCallbackTestCase::ConnectTwo (void)
+{
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::ConnectTwo, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbTwo, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::DisconnectSelf (void)
+{
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::DisconnectSelf, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::DisconnectOne (void)
+{
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbOne, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::DisconnectThree (void)
+{
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbThree, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::DoRun (void)
+{
+  //
+  // A Callback connected by a Callback is invoked after it, in the same call.
+  //
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbOne, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::ConnectTwo, this));
+  m_one = m_two = m_three = 0;
+  m_trace ();
+  NS_TEST_ASSERT_MSG_EQ (m_one, 1, "Callback CbOne not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 1, "Callback CbTwo connected during the call not called");
+  m_trace ();
+  NS_TEST_ASSERT_MSG_EQ (m_one, 2, "Callback CbOne not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 2, "Callback CbTwo not called once");
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbOne, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbTwo, this));
+
+  //
+  // A Callback which disconnects itself does not prevent the next ones
+  // from being called.
+  //
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::DisconnectSelf, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbOne, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbTwo, this));
+  m_one = m_two = m_three = 0;
+  m_trace ();
+  NS_TEST_ASSERT_MSG_EQ (m_one, 1, "Callback CbOne after a disconnected Callback not called");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 1, "Callback CbTwo after a disconnected Callback not called");
+  m_trace ();
+  NS_TEST_ASSERT_MSG_EQ (m_one, 2, "Callback CbOne not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 2, "Callback CbTwo not called once");
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbOne, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbTwo, this));
+
+  //
+  // A Callback which disconnects an earlier one does not shift the
+  // next ones, and a Callback disconnected before its turn is not called.
+  //
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbOne, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::DisconnectOne, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbTwo, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::DisconnectThree, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbThree, this));
+  m_one = m_two = m_three = 0;
+  m_trace ();
+  NS_TEST_ASSERT_MSG_EQ (m_one, 1, "Callback CbOne not called before being disconnected");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 1, "Callback CbTwo after a disconnected Callback not called");
+  NS_TEST_ASSERT_MSG_EQ (m_three, 0, "Callback CbThree called after being disconnected");
+  m_trace ();
+  NS_TEST_ASSERT_MSG_EQ (m_one, 1, "Callback CbOne called after being disconnected");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 2, "Callback CbTwo not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_three, 0, "Callback CbThree called after being disconnected");
+}
+
+#ifndef NS3_TRACING_DISABLE
+class OptionalTracedCallbackTestCase : public TestCase
+{
+public:
+  OptionalTracedCallbackTestCase ();
+  virtual ~OptionalTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void Cb (uint8_t a, double b);
+  void ValueCb (uint32_t oldValue, uint32_t newValue);
+
+  uint32_t m_calls;
+  uint32_t m_value;
+};
+
+OptionalTracedCallbackTestCase::OptionalTracedCallbackTestCase ()
+  : TestCase ("Check that the optional trace sources are traced when tracing is enabled")
+{
+}
+
+void
+OptionalTracedCallbackTestCase::Cb (uint8_t a, double b)
+{
+  m_calls++;
+}
+
+void
+OptionalTracedCallbackTestCase::ValueCb (uint32_t oldValue, uint32_t newValue)
+{
+  m_calls++;
+  m_value = newValue;
+}
+
+void
+OptionalTracedCallbackTestCase::DoRun (void)
+{
+  OptionalTracedCallback<uint8_t, double> trace;
+  trace.ConnectWithoutContext (MakeCallback (&OptionalTracedCallbackTestCase::Cb, this));
+  m_calls = 0;
+  trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, 1, "Callback Cb not called");
+  trace.DisconnectWithoutContext (MakeCallback (&OptionalTracedCallbackTestCase::Cb, this));
+  trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, 1, "Callback Cb unexpectedly called");
+
+  OptionalTracedValue<uint32_t> value;
+  value.ConnectWithoutContext (MakeCallback (&OptionalTracedCallbackTestCase::ValueCb, this));
+  m_calls = 0;
+  value = 3;
+  value += 2;
+  value++;
+  NS_TEST_ASSERT_MSG_EQ (m_calls, 3, "Callback ValueCb not called on each change");
+  NS_TEST_ASSERT_MSG_EQ (m_value, 6, "Callback ValueCb called with a bad value");
+  value = 6;
+  NS_TEST_ASSERT_MSG_EQ (m_calls, 3, "Callback ValueCb called without a change");
+}
+#endif /* NS3_TRACING_DISABLE */
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -118,6 +305,10 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ReentrantTracedCallbackTestCase, TestCase::QUICK);
+#ifndef NS3_TRACING_DISABLE
+  AddTestCase (new OptionalTracedCallbackTestCase, TestCase::QUICK);
+#endif /* NS3_TRACING_DISABLE */
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
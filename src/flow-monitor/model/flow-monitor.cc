@@ -21,7 +21,9 @@
 #include "flow-monitor.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/double.h"
+#include "ns3/string.h"
 #include <fstream>
 #include <sstream>
 
@@ -72,6 +74,15 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("ExportFileName", ("The CSV file where the stats of the flows that changed are appended "
+                                      "every ExportInterval, or empty to disable the export."),
+                   StringValue (""),
+                   MakeStringAccessor (&FlowMonitor::m_exportFileName),
+                   MakeStringChecker ())
+    .AddAttribute ("ExportInterval", ("The time between two exports of the stats of the flows that changed."),
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&FlowMonitor::m_exportInterval),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -83,7 +94,9 @@ FlowMonitor::GetInstanceTypeId (void) const
 }
 
 FlowMonitor::FlowMonitor ()
-  : m_enabled (false)
+  : m_oldestPacket (0),
+    m_newestPacket (0),
+    m_enabled (false)
 {
   // m_histogramBinWidth=DEFAULT_BIN_WIDTH;
 }
@@ -102,38 +115,129 @@ FlowMonitor::DoDispose (void)
       m_flowProbes[i]->Dispose ();
       m_flowProbes[i] = 0;
     }
+  Simulator::Cancel (m_exportEvent);
+  // the last changes are exported now if the monitor is disposed of
+  // before the simulation is destroyed, and were exported already otherwise
+  if (!Simulator::IsExpired (m_finalExportEvent))
+    {
+      Simulator::Cancel (m_finalExportEvent);
+      ExportChangedFlows ();
+    }
+  if (m_exportFile.is_open ())
+    {
+      m_exportFile.close ();
+    }
   Object::DoDispose ();
 }
 
 inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow (FlowId flowId)
 {
-  FlowStatsContainerI iter;
-  iter = m_flowStats.find (flowId);
-  if (iter == m_flowStats.end ())
-    {
-      FlowMonitor::FlowStats &ref = m_flowStats[flowId];
-      ref.delaySum = Seconds (0);
-      ref.jitterSum = Seconds (0);
-      ref.lastDelay = Seconds (0);
-      ref.txBytes = 0;
-      ref.rxBytes = 0;
-      ref.txPackets = 0;
-      ref.rxPackets = 0;
-      ref.lostPackets = 0;
-      ref.timesForwarded = 0;
-      ref.delayHistogram.SetDefaultBinWidth (m_delayBinWidth);
-      ref.jitterHistogram.SetDefaultBinWidth (m_jitterBinWidth);
-      ref.packetSizeHistogram.SetDefaultBinWidth (m_packetSizeBinWidth);
-      ref.flowInterruptionsHistogram.SetDefaultBinWidth (m_flowInterruptionsBinWidth);
-      return ref;
+  if (!m_exportFileName.empty ())
+    {
+      NotifyFlowChanged (flowId);
+    }
+  if (flowId < m_flowStatsIndex.size () && m_flowStatsIndex[flowId] != 0)
+    {
+      return *m_flowStatsIndex[flowId];
+    }
+  FlowMonitor::FlowStats &ref = m_flowStats[flowId];
+  ref.delaySum = Seconds (0);
+  ref.jitterSum = Seconds (0);
+  ref.lastDelay = Seconds (0);
+  ref.txBytes = 0;
+  ref.rxBytes = 0;
+  ref.txPackets = 0;
+  ref.rxPackets = 0;
+  ref.lostPackets = 0;
+  ref.timesForwarded = 0;
+  ref.delayHistogram.SetDefaultBinWidth (m_delayBinWidth);
+  ref.jitterHistogram.SetDefaultBinWidth (m_jitterBinWidth);
+  ref.packetSizeHistogram.SetDefaultBinWidth (m_packetSizeBinWidth);
+  ref.flowInterruptionsHistogram.SetDefaultBinWidth (m_flowInterruptionsBinWidth);
+  // flow ids are allocated sequentially by the classifiers, so the index stays dense
+  if (flowId >= m_flowStatsIndex.size ())
+    {
+      m_flowStatsIndex.resize (flowId + 1, 0);
+    }
+  m_flowStatsIndex[flowId] = &ref;
+  return ref;
+}
+
+size_t
+FlowMonitor::TrackedPacketKeyHash::operator() (uint64_t key) const
+{
+  // packet ids are sequential within a flow, mix in the flow id
+  return static_cast<size_t> (key ^ ((key >> 32) * 0x9e3779b1U));
+}
+
+inline uint64_t
+FlowMonitor::GetKey (FlowId flowId, FlowPacketId packetId)
+{
+  return (static_cast<uint64_t> (flowId) << 32) | packetId;
+}
+
+FlowMonitor::TrackedPacket&
+FlowMonitor::AddTrackedPacket (FlowId flowId, FlowPacketId packetId)
+{
+  uint64_t key = GetKey (flowId, packetId);
+  std::pair<TrackedPacketMap::iterator, bool> inserted =
+    m_trackedPackets.insert (std::make_pair (key, TrackedPacket ()));
+  TrackedPacket &tracked = inserted.first->second;
+  if (!inserted.second)
+    {
+      // the same packet reported again, it becomes the most recently seen one
+      UnlinkTrackedPacket (tracked);
+    }
+  tracked.key = key;
+  LinkTrackedPacket (tracked);
+  return tracked;
+}
+
+void
+FlowMonitor::RemoveTrackedPacket (TrackedPacketMap::iterator tracked)
+{
+  UnlinkTrackedPacket (tracked->second);
+  m_trackedPackets.erase (tracked);
+}
+
+void
+FlowMonitor::UnlinkTrackedPacket (TrackedPacket &tracked)
+{
+  if (tracked.older != 0)
+    {
+      tracked.older->newer = tracked.newer;
+    }
+  else
+    {
+      m_oldestPacket = tracked.newer;
+    }
+  if (tracked.newer != 0)
+    {
+      tracked.newer->older = tracked.older;
     }
   else
     {
-      return iter->second;
+      m_newestPacket = tracked.older;
     }
 }
 
+void
+FlowMonitor::LinkTrackedPacket (TrackedPacket &tracked)
+{
+  // the simulation time never decreases, so appending keeps the list ordered
+  tracked.older = m_newestPacket;
+  tracked.newer = 0;
+  if (m_newestPacket != 0)
+    {
+      m_newestPacket->newer = &tracked;
+    }
+  else
+    {
+      m_oldestPacket = &tracked;
+    }
+  m_newestPacket = &tracked;
+}
 
 void
 FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
@@ -143,7 +247,7 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  TrackedPacket &tracked = AddTrackedPacket (flowId, packetId);
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
@@ -170,8 +274,7 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
     {
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetKey (flowId, packetId));
   if (tracked == m_trackedPackets.end ())
     {
       NS_LOG_WARN ("Received packet forward report (flowId=" << flowId << ", packetId=" << packetId
@@ -181,6 +284,8 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
 
   tracked->second.timesForwarded++;
   tracked->second.lastSeenTime = Simulator::Now ();
+  UnlinkTrackedPacket (tracked->second);
+  LinkTrackedPacket (tracked->second);
 
   Time delay = (Simulator::Now () - tracked->second.firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
@@ -194,7 +299,7 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     {
       return;
     }
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetKey (flowId, packetId));
   if (tracked == m_trackedPackets.end ())
     {
       NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
@@ -247,7 +352,7 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
   NS_LOG_DEBUG ("ReportLastTx: removing tracked packet (flowId="
                 << flowId << ", packetId=" << packetId << ").");
 
-  m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
+  RemoveTrackedPacket (tracked); // we don't need to track this packet anymore
 }
 
 void
@@ -272,14 +377,14 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
   stats.bytesDropped[reasonCode] += packetSize;
   NS_LOG_DEBUG ("++stats.packetsDropped[" << reasonCode<< "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetKey (flowId, packetId));
   if (tracked != m_trackedPackets.end ())
     {
       // we don't need to track this packet anymore
       // FIXME: this will not necessarily be true with broadcast/multicast
       NS_LOG_DEBUG ("ReportDrop: removing tracked packet (flowId="
                     << flowId << ", packetId=" << packetId << ").");
-      m_trackedPackets.erase (tracked);
+      RemoveTrackedPacket (tracked);
     }
 }
 
@@ -295,23 +400,18 @@ FlowMonitor::CheckForLostPackets (Time maxDelay)
 {
   Time now = Simulator::Now ();
 
-  for (TrackedPacketMap::iterator iter = m_trackedPackets.begin ();
-       iter != m_trackedPackets.end (); )
+  // the packets are ordered by the last time they were seen, so the
+  // lost ones are at the start of the list
+  while (m_oldestPacket != 0 && now - m_oldestPacket->lastSeenTime >= maxDelay)
     {
-      if (now - iter->second.lastSeenTime >= maxDelay)
-        {
-          // packet is considered lost, add it to the loss statistics
-          FlowStatsContainerI flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
-
-          // we won't track it anymore
-          m_trackedPackets.erase (iter++);
-        }
-      else
-        {
-          iter++;
-        }
+      // packet is considered lost, add it to the loss statistics
+      uint64_t key = m_oldestPacket->key;
+      GetStatsForFlow (static_cast<FlowId> (key >> 32)).lostPackets++;
+
+      // we won't track it anymore
+      TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
+      NS_ASSERT (tracked != m_trackedPackets.end ());
+      RemoveTrackedPacket (tracked);
     }
 }
 
@@ -328,11 +428,64 @@ FlowMonitor::PeriodicCheckForLostPackets ()
   Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
 }
 
+void
+FlowMonitor::NotifyFlowChanged (FlowId flowId)
+{
+  if (flowId >= m_flowChanged.size ())
+    {
+      m_flowChanged.resize (flowId + 1, false);
+    }
+  if (!m_flowChanged[flowId])
+    {
+      m_flowChanged[flowId] = true;
+      m_changedFlows.push_back (flowId);
+    }
+}
+
+void
+FlowMonitor::ExportChangedFlows ()
+{
+  if (!m_exportFile.is_open ())
+    {
+      m_exportFile.open (m_exportFileName.c_str (), std::ios::out);
+      NS_ABORT_MSG_UNLESS (m_exportFile.is_open (), "Unable to open " << m_exportFileName);
+      m_exportFile << "time,flowId,txBytes,rxBytes,txPackets,rxPackets,lostPackets,"
+                   << "timesForwarded,delaySum,jitterSum\n";
+    }
+  double now = Simulator::Now ().GetSeconds ();
+  for (std::vector<FlowId>::const_iterator iter = m_changedFlows.begin ();
+       iter != m_changedFlows.end (); iter++)
+    {
+      const FlowStats &stats = *m_flowStatsIndex[*iter];
+      m_exportFile << now << "," << *iter
+                   << "," << stats.txBytes << "," << stats.rxBytes
+                   << "," << stats.txPackets << "," << stats.rxPackets
+                   << "," << stats.lostPackets << "," << stats.timesForwarded
+                   << "," << stats.delaySum.GetSeconds ()
+                   << "," << stats.jitterSum.GetSeconds () << "\n";
+      m_flowChanged[*iter] = false;
+    }
+  m_changedFlows.clear ();
+}
+
+void
+FlowMonitor::PeriodicExport ()
+{
+  ExportChangedFlows ();
+  m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+}
+
 void
 FlowMonitor::NotifyConstructionCompleted ()
 {
   Object::NotifyConstructionCompleted ();
   Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
+  if (!m_exportFileName.empty ())
+    {
+      m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+      // the last changes are exported at the time the simulation ends
+      m_finalExportEvent = Simulator::ScheduleDestroy (&FlowMonitor::ExportChangedFlows, this);
+    }
 }
 
 void
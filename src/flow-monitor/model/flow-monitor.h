@@ -23,6 +23,8 @@
 
 #include <vector>
 #include <map>
+#include <fstream>
+#include <string>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
@@ -31,6 +33,7 @@
 #include "ns3/histogram.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/sgi-hashmap.h"
 
 namespace ns3 {
 
@@ -46,6 +49,13 @@ namespace ns3 {
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * The packets in flight are kept in a hash table, and also in a list
+ * ordered by the last time each packet was seen, so that checking for
+ * lost packets only visits the packets that are lost.  When the
+ * ExportFileName attribute is set, the statistics of the flows that
+ * changed are also appended to a CSV file every ExportInterval, while
+ * the simulation runs.
+ *
  */
 class FlowMonitor : public Object
 {
@@ -270,14 +280,29 @@ private:
     Time firstSeenTime; //!< absolute time when the packet was first seen by a probe
     Time lastSeenTime; //!< absolute time when the packet was last seen by a probe
     uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
+    uint64_t key; //!< key of the packet in m_trackedPackets
+    TrackedPacket *older; //!< packet seen just before this one, or 0
+    TrackedPacket *newer; //!< packet seen just after this one, or 0
+  };
+
+  /// Hash function of the keys of the tracked packets
+  struct TrackedPacketKeyHash
+  {
+    /// \param key the key of a tracked packet
+    /// \returns the hash of the key
+    size_t operator() (uint64_t key) const;
   };
 
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
+  /// FlowId --> FlowStats in m_flowStats, or 0 if the flow has no stats yet
+  std::vector<FlowStats *> m_flowStatsIndex;
 
-  /// (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+  /// (FlowId,PacketId), as returned by GetKey --> TrackedPacket
+  typedef sgi::hash_map<uint64_t, TrackedPacket, TrackedPacketKeyHash> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets; //!< Tracked packets
+  TrackedPacket *m_oldestPacket; //!< tracked packet seen the longest time ago, or 0
+  TrackedPacket *m_newestPacket; //!< tracked packet seen most recently, or 0
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
 
@@ -293,13 +318,54 @@ private:
   double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
   Time m_flowInterruptionsMinTime; //!< Flow interruptions minimum time
 
+  std::string m_exportFileName; //!< CSV file of the periodic export, or empty
+  Time m_exportInterval;        //!< Time between two exports
+  std::ofstream m_exportFile;   //!< The CSV file of the periodic export
+  std::vector<FlowId> m_changedFlows; //!< Flows changed since the last export
+  std::vector<bool> m_flowChanged;    //!< FlowId --> whether the flow is in m_changedFlows
+  EventId m_exportEvent;        //!< Next periodic export
+  EventId m_finalExportEvent;   //!< Export when the simulator is destroyed
+
   /// Get the stats for a given flow
   /// \param flowId the Flow identification
   /// \returns the stats of the flow
   FlowStats& GetStatsForFlow (FlowId flowId);
 
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet ID
+  /// \returns the key of the packet in m_trackedPackets
+  static uint64_t GetKey (FlowId flowId, FlowPacketId packetId);
+
+  /// Start tracking a packet, as the most recently seen one
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet ID
+  /// \returns the tracked packet
+  TrackedPacket& AddTrackedPacket (FlowId flowId, FlowPacketId packetId);
+
+  /// Stop tracking a packet
+  /// \param tracked the tracked packet
+  void RemoveTrackedPacket (TrackedPacketMap::iterator tracked);
+
+  /// Remove a tracked packet from the list ordered by the last seen time
+  /// \param tracked the tracked packet
+  void UnlinkTrackedPacket (TrackedPacket &tracked);
+
+  /// Append a tracked packet to the list ordered by the last seen time
+  /// \param tracked the tracked packet
+  void LinkTrackedPacket (TrackedPacket &tracked);
+
   /// Periodic function to check for lost packets and prune statistics
   void PeriodicCheckForLostPackets ();
+
+  /// Note that the stats of a flow changed since the last export
+  /// \param flowId the Flow identification
+  void NotifyFlowChanged (FlowId flowId);
+
+  /// Append the stats of the flows changed since the last export to the CSV file
+  void ExportChangedFlows ();
+
+  /// Periodic function to export the stats of the changed flows
+  void PeriodicExport ();
 };
 
 
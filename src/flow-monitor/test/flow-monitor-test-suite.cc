@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * A probe which only reports the packets the test schedules.
+ */
+class TestFlowProbe : public FlowProbe
+{
+public:
+  /**
+   * \param monitor The monitor.
+   */
+  TestFlowProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+class FlowMonitorLossTestCase : public TestCase
+{
+public:
+  FlowMonitorLossTestCase ();
+  virtual void DoRun (void);
+};
+
+FlowMonitorLossTestCase::FlowMonitorLossTestCase ()
+  : TestCase ("Expire the lost packets and export the changed flows")
+{
+}
+
+void
+FlowMonitorLossTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("flow-monitor.csv");
+  Ptr<FlowMonitor> monitor = CreateObjectWithAttributes<FlowMonitor> (
+      "MaxPerHopDelay", TimeValue (Seconds (2)),
+      "ExportFileName", StringValue (filename));
+  Ptr<FlowProbe> probe = Create<TestFlowProbe> (monitor);
+  monitor->StartRightNow ();
+
+  Simulator::Schedule (Seconds (0.1), &FlowMonitor::ReportFirstTx, monitor, probe, 1, 1, 100);
+  Simulator::Schedule (Seconds (0.1), &FlowMonitor::ReportFirstTx, monitor, probe, 1, 2, 100);
+  Simulator::Schedule (Seconds (0.1), &FlowMonitor::ReportFirstTx, monitor, probe, 2, 1, 100);
+  Simulator::Schedule (Seconds (0.2), &FlowMonitor::ReportLastRx, monitor, probe, 1, 1, 100);
+  // seen again, so lost one second later than the packet of flow 1
+  Simulator::Schedule (Seconds (1.5), &FlowMonitor::ReportForwarding, monitor, probe, 2, 1, 100);
+  Simulator::Stop (Seconds (4.5));
+  Simulator::Run ();
+
+  const FlowMonitor::FlowStatsContainer &stats = monitor->GetFlowStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.size (), 2, "Bad number of flows");
+  NS_TEST_EXPECT_MSG_EQ (stats.find (1)->second.rxPackets, 1, "Bad received packets");
+  NS_TEST_EXPECT_MSG_EQ (stats.find (1)->second.lostPackets, 1, "Bad lost packets");
+  NS_TEST_EXPECT_MSG_EQ (stats.find (2)->second.lostPackets, 1, "Bad lost packets");
+
+  Simulator::Destroy ();
+  monitor->Dispose ();
+
+  // the flows are exported when they change: first the transmissions,
+  // then each loss, after the periodic check of the same second
+  std::ifstream is (filename.c_str ());
+  std::ostringstream oss;
+  oss << is.rdbuf ();
+  std::string expected =
+    "time,flowId,txBytes,rxBytes,txPackets,rxPackets,lostPackets,timesForwarded,delaySum,jitterSum\n"
+    "1,1,200,100,2,1,0,0,0.1,0\n"
+    "1,2,100,0,1,0,0,0,0,0\n"
+    "3,1,200,100,2,1,1,0,0.1,0\n"
+    "4,2,100,0,1,0,1,0,0,0\n";
+  NS_TEST_EXPECT_MSG_EQ (oss.str (), expected, "Bad export");
+}
+
+class FlowMonitorTestSuite : public TestSuite
+{
+public:
+  FlowMonitorTestSuite ();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite ()
+  : TestSuite ("flow-monitor", UNIT)
+{
+  AddTestCase (new FlowMonitorLossTestCase, TestCase::QUICK);
+}
+
+static FlowMonitorTestSuite g_flowMonitorTestSuite;
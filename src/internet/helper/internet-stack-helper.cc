@@ -719,7 +719,7 @@ Ipv4L3ProtocolDropSinkWithoutContext (
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << "\n";
 }
 
 /**
@@ -743,7 +743,7 @@ Ipv4L3ProtocolTxSinkWithoutContext (
       return;
     }
 
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << "\n";
 }
 
 /**
@@ -767,7 +767,7 @@ Ipv4L3ProtocolRxSinkWithoutContext (
       return;
     }
 
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << "\n";
 }
 
 /**
@@ -809,7 +809,7 @@ Ipv4L3ProtocolDropSinkWithContext (
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *p << std::endl;
 #else
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " "  << *p << std::endl;
+  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " "  << *p << "\n";
 #endif
 }
 
@@ -840,7 +840,7 @@ Ipv4L3ProtocolTxSinkWithContext (
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *packet << std::endl;
 #else
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " "  << *packet << std::endl;
+  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " "  << *packet << "\n";
 #endif
 }
 
@@ -871,7 +871,7 @@ Ipv4L3ProtocolRxSinkWithContext (
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *packet << std::endl;
 #else
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " "  << *packet << std::endl;
+  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " "  << *packet << "\n";
 #endif
 }
 
@@ -1057,7 +1057,7 @@ Ipv6L3ProtocolDropSinkWithoutContext (
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << "\n";
 }
 
 /**
@@ -1081,7 +1081,7 @@ Ipv6L3ProtocolTxSinkWithoutContext (
       return;
     }
 
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << "\n";
 }
 
 /**
@@ -1105,7 +1105,7 @@ Ipv6L3ProtocolRxSinkWithoutContext (
       return;
     }
 
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
+  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << "\n";
 }
 
 /**
@@ -1147,7 +1147,7 @@ Ipv6L3ProtocolDropSinkWithContext (
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *p << std::endl;
 #else
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << "\n";
 #endif
 }
 
@@ -1178,7 +1178,7 @@ Ipv6L3ProtocolTxSinkWithContext (
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *packet << std::endl;
 #else
-  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " " << *packet << std::endl;
+  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " " << *packet << "\n";
 #endif
 }
 
@@ -1209,7 +1209,7 @@ Ipv6L3ProtocolRxSinkWithContext (
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *packet << std::endl;
 #else
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *packet << std::endl;
+  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *packet << "\n";
 #endif
 }
 
@@ -39,6 +39,7 @@
 #include "global-route-manager-impl.h"
 #include "candidate-queue.h"
 #include "ipv4-global-routing.h"
+#include "ipv4-l3-protocol.h"
 
 namespace ns3 {
 
@@ -578,6 +579,11 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
         {
           continue;
         }
+      Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol> ();
+      if (ipv4 != 0)
+        {
+          ipv4->FlushRouteCache ();
+        }
       Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
       uint32_t j = 0;
       uint32_t nRoutes = gr->GetNRoutes ();
@@ -711,9 +717,11 @@ GlobalRouteManagerImpl::InitializeRoutes ()
       Ptr<GlobalRouter> rtr = 
         node->GetObject<GlobalRouter> ();
 
-      uint32_t systemId = MpiInterface::GetSystemId ();
-      // Ignore nodes that are not assigned to our systemId (distributed sim)
-      if (node->GetSystemId () != systemId) 
+      // Ignore nodes that are not assigned to our systemId (distributed sim).
+      // Without MPI, system ids partition the nodes across the threads of
+      // MultithreadedSimulatorImpl, and all the nodes are routed.
+      if (MpiInterface::IsEnabled ()
+          && node->GetSystemId () != MpiInterface::GetSystemId ())
         {
           continue;
         }
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <algorithm>
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
 #include "ns3/log.h"
@@ -27,7 +28,8 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
-  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
+  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152),
+    m_sequence (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -35,36 +37,162 @@ Ipv4EndPointDemux::Ipv4EndPointDemux ()
 Ipv4EndPointDemux::~Ipv4EndPointDemux ()
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  EndPoints endPoints = GetAllEndPoints ();
+  m_localPorts.clear ();
+  m_connections.clear ();
+  m_wildcards.clear ();
+  for (EndPointsI i = endPoints.begin (); i != endPoints.end (); i++) 
     {
       Ipv4EndPoint *endPoint = *i;
       delete endPoint;
     }
-  m_endPoints.clear ();
 }
 
 bool
-Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+Ipv4EndPointDemux::ConnectionKey::operator== (const ConnectionKey &other) const
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  return localPort == other.localPort
+         && peerAddress == other.peerAddress
+         && peerPort == other.peerPort;
+}
+
+size_t
+Ipv4EndPointDemux::ConnectionKeyHash::operator() (const ConnectionKey &key) const
+{
+  size_t hash = key.peerAddress.Get ();
+  hash = hash * 31 + key.peerPort;
+  hash = hash * 31 + key.localPort;
+  return hash;
+}
+
+bool
+Ipv4EndPointDemux::IsConnected (Ipv4EndPoint *endPoint)
+{
+  return endPoint->GetPeerPort () != 0
+         && endPoint->GetPeerAddress () != Ipv4Address::GetAny ();
+}
+
+Ipv4EndPointDemux::ConnectionKey
+Ipv4EndPointDemux::GetConnectionKey (Ipv4EndPoint *endPoint)
+{
+  ConnectionKey key;
+  key.localPort = endPoint->GetLocalPort ();
+  key.peerAddress = endPoint->GetPeerAddress ();
+  key.peerPort = endPoint->GetPeerPort ();
+  return key;
+}
+
+uint64_t
+Ipv4EndPointDemux::Remove (IndexedEndPoints &endPoints, Ipv4EndPoint *endPoint)
+{
+  for (IndexedEndPoints::iterator i = endPoints.begin (); i != endPoints.end (); i++)
     {
-      if ((*i)->GetLocalPort  () == port) 
+      if (i->second == endPoint)
         {
-          return true;
+          uint64_t sequence = i->first;
+          endPoints.erase (i);
+          return sequence;
         }
     }
-  return false;
+  NS_ASSERT_MSG (false, "End point not indexed");
+  return 0;
+}
+
+void
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint64_t sequence = m_sequence++;
+  endPoint->m_demux = this;
+  m_localPorts[endPoint->GetLocalPort ()].push_back (std::make_pair (sequence, endPoint));
+  Index (endPoint, sequence);
+}
+
+void
+Ipv4EndPointDemux::Index (Ipv4EndPoint *endPoint, uint64_t sequence)
+{
+  NS_LOG_FUNCTION (this << endPoint << sequence);
+  if (IsConnected (endPoint))
+    {
+      m_connections[GetConnectionKey (endPoint)].push_back (std::make_pair (sequence, endPoint));
+    }
+  else
+    {
+      m_wildcards[endPoint->GetLocalPort ()].push_back (std::make_pair (sequence, endPoint));
+    }
+}
+
+uint64_t
+Ipv4EndPointDemux::Unindex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint64_t sequence;
+  if (IsConnected (endPoint))
+    {
+      ConnectionIndex::iterator i = m_connections.find (GetConnectionKey (endPoint));
+      NS_ASSERT (i != m_connections.end ());
+      sequence = Remove (i->second, endPoint);
+      if (i->second.empty ())
+        {
+          m_connections.erase (i);
+        }
+    }
+  else
+    {
+      PortIndex::iterator i = m_wildcards.find (endPoint->GetLocalPort ());
+      NS_ASSERT (i != m_wildcards.end ());
+      sequence = Remove (i->second, endPoint);
+      if (i->second.empty ())
+        {
+          m_wildcards.erase (i);
+        }
+    }
+  return sequence;
+}
+
+Ipv4EndPointDemux::IndexedEndPoints
+Ipv4EndPointDemux::GetCandidates (uint16_t dport, Ipv4Address saddr, uint16_t sport)
+{
+  NS_LOG_FUNCTION (this << dport << saddr << sport);
+  IndexedEndPoints candidates;
+  // A connected end point can only match a packet coming from its peer
+  ConnectionKey key;
+  key.localPort = dport;
+  key.peerAddress = saddr;
+  key.peerPort = sport;
+  ConnectionIndex::const_iterator i = m_connections.find (key);
+  if (i != m_connections.end ())
+    {
+      candidates.insert (candidates.end (), i->second.begin (), i->second.end ());
+    }
+  PortIndex::const_iterator j = m_wildcards.find (dport);
+  if (j != m_wildcards.end ())
+    {
+      candidates.insert (candidates.end (), j->second.begin (), j->second.end ());
+    }
+  std::sort (candidates.begin (), candidates.end ());
+  return candidates;
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_localPorts.find (port) != m_localPorts.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  PortIndex::const_iterator i = m_localPorts.find (port);
+  if (i == m_localPorts.end ())
+    {
+      return false;
+    }
+  for (IndexedEndPoints::const_iterator j = i->second.begin (); j != i->second.end (); j++) 
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr) 
+      if (j->second->GetLocalAddress () == addr) 
         {
           return true;
         }
@@ -83,8 +211,8 @@ Ipv4EndPointDemux::Allocate (void)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_sequence << "<< endpoints allocated.");
   return endPoint;
 }
 
@@ -99,8 +227,8 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_sequence << "<< endpoints allocated.");
   return endPoint;
 }
 
@@ -122,8 +250,8 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address, uint16_t port)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_sequence << "<< endpoints allocated.");
   return endPoint;
 }
 
@@ -132,23 +260,40 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
+  endPoint->SetPeer (peerAddress, peerPort);
+
+  // Only the end points in the same bucket may have the same four-tuple
+  IndexedEndPoints *endPoints = 0;
+  if (IsConnected (endPoint))
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress) 
+      ConnectionIndex::iterator i = m_connections.find (GetConnectionKey (endPoint));
+      endPoints = (i != m_connections.end ()) ? &i->second : 0;
+    }
+  else
+    {
+      PortIndex::iterator i = m_wildcards.find (localPort);
+      endPoints = (i != m_wildcards.end ()) ? &i->second : 0;
+    }
+  if (endPoints != 0)
+    {
+      for (IndexedEndPoints::const_iterator i = endPoints->begin (); i != endPoints->end (); i++) 
         {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
+          if (i->second->GetLocalPort () == localPort &&
+              i->second->GetLocalAddress () == localAddress &&
+              i->second->GetPeerPort () == peerPort &&
+              i->second->GetPeerAddress () == peerAddress) 
+            {
+              NS_LOG_WARN ("No way we can allocate this end-point.");
+              /* no way we can allocate this end-point. */
+              delete endPoint;
+              return 0;
+            }
         }
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
-  endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
 
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  NS_LOG_DEBUG ("Now have >>" << m_sequence << "<< endpoints allocated.");
 
   return endPoint;
 }
@@ -157,15 +302,18 @@ void
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  if (endPoint->m_demux != this)
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
+    }
+  Unindex (endPoint);
+  PortIndex::iterator i = m_localPorts.find (endPoint->GetLocalPort ());
+  Remove (i->second, endPoint);
+  if (i->second.empty ())
+    {
+      m_localPorts.erase (i);
     }
+  delete endPoint;
 }
 
 /*
@@ -175,12 +323,17 @@ Ipv4EndPointDemux::EndPoints
 Ipv4EndPointDemux::GetAllEndPoints (void)
 {
   NS_LOG_FUNCTION (this);
-  EndPoints ret;
+  IndexedEndPoints endPoints;
+  for (PortIndex::const_iterator i = m_localPorts.begin (); i != m_localPorts.end (); i++)
+    {
+      endPoints.insert (endPoints.end (), i->second.begin (), i->second.end ());
+    }
+  std::sort (endPoints.begin (), endPoints.end ());
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  EndPoints ret;
+  for (IndexedEndPoints::const_iterator i = endPoints.begin (); i != endPoints.end (); i++)
     {
-      Ipv4EndPoint* endP = *i;
-      ret.push_back (endP);
+      ret.push_back (i->second);
     }
   return ret;
 }
@@ -204,9 +357,30 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  IndexedEndPoints candidates = GetCandidates (dport, saddr, sport);
+  if (candidates.empty ())
+    {
+      return retval1;
+    }
+
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
+  for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
+    {
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+          daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+        {
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
+        }
+    }
+  bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+  NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
+
+  for (IndexedEndPoints::const_iterator i = candidates.begin (); i != candidates.end (); i++) 
     {
-      Ipv4EndPoint* endP = *i;
+      Ipv4EndPoint* endP = i->second;
 
       NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
                                                  << " daddr=" << endP->GetLocalAddress ()
@@ -239,20 +413,6 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
               continue;
             }
         }
-      bool subnetDirected = false;
-      Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
-      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
-        {
-          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
-              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
-            {
-              subnetDirected = true;
-              incomingInterfaceAddr = addr.GetLocal ();
-            }
-        }
-      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
-      NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
       bool localAddressMatchesWildCard = 
         endP->GetLocalAddress () == Ipv4Address::GetAny ();
       bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
@@ -324,35 +484,53 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport);
 
+  // An exact match is a connected end point, unless the source is a wildcard
+  if (sport != 0 && saddr != Ipv4Address::GetAny ())
+    {
+      IndexedEndPoints candidates = GetCandidates (dport, saddr, sport);
+      for (IndexedEndPoints::const_iterator i = candidates.begin (); i != candidates.end (); i++)
+        {
+          if (i->second->GetLocalAddress () == daddr &&
+              i->second->GetPeerPort () == sport &&
+              i->second->GetPeerAddress () == saddr) 
+            {
+              return i->second;
+            }
+        }
+    }
+
+  PortIndex::const_iterator port = m_localPorts.find (dport);
+  if (port == m_localPorts.end ())
+    {
+      return 0;
+    }
+
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
   uint32_t genericity = 3;
   Ipv4EndPoint *generic = 0;
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (IndexedEndPoints::const_iterator j = port->second.begin (); j != port->second.end (); j++) 
     {
-      if ((*i)->GetLocalPort () != dport) 
-        {
-          continue;
-        }
-      if ((*i)->GetLocalAddress () == daddr &&
-          (*i)->GetPeerPort () == sport &&
-          (*i)->GetPeerAddress () == saddr) 
+      Ipv4EndPoint *endPoint = j->second;
+      if (endPoint->GetLocalAddress () == daddr &&
+          endPoint->GetPeerPort () == sport &&
+          endPoint->GetPeerAddress () == saddr) 
         {
           /* this is an exact match. */
-          return *i;
+          return endPoint;
         }
       uint32_t tmp = 0;
-      if ((*i)->GetLocalAddress () == Ipv4Address::GetAny ()) 
+      if (endPoint->GetLocalAddress () == Ipv4Address::GetAny ()) 
         {
           tmp++;
         }
-      if ((*i)->GetPeerAddress () == Ipv4Address::GetAny ()) 
+      if (endPoint->GetPeerAddress () == Ipv4Address::GetAny ()) 
         {
           tmp++;
         }
       if (tmp < genericity) 
         {
-          generic = (*i);
+          generic = endPoint;
           genericity = tmp;
         }
     }
@@ -23,7 +23,10 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
+#include <utility>
 #include "ns3/ipv4-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "ipv4-interface.h"
 
 namespace ns3 {
@@ -38,6 +41,12 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * Endpoints whose peer address and port are both set are looked up in a
+ * hash table keyed by local port, peer address and peer port; the other
+ * (wildcard) endpoints, such as listening sockets, in a hash table keyed by
+ * local port. A lookup therefore only considers the endpoints that may match
+ * the packet, however many connections the node has.
  */
 
 class Ipv4EndPointDemux {
@@ -161,6 +170,111 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief An endpoint and the order in which it was allocated.
+   */
+  typedef std::pair<uint64_t, Ipv4EndPoint *> IndexedEndPoint;
+
+  /**
+   * \brief Container of indexed endpoints.
+   */
+  typedef std::vector<IndexedEndPoint> IndexedEndPoints;
+
+  /**
+   * \brief Local port, peer address and peer port of a connected endpoint.
+   */
+  struct ConnectionKey
+  {
+    uint16_t localPort;      //!< local port
+    Ipv4Address peerAddress; //!< peer address
+    uint16_t peerPort;       //!< peer port
+
+    /**
+     * \brief Equality operator.
+     * \param other the key to compare to
+     * \returns true if the keys are equal
+     */
+    bool operator== (const ConnectionKey &other) const;
+  };
+
+  /**
+   * \brief Hash function of ConnectionKey.
+   */
+  struct ConnectionKeyHash : public std::unary_function<ConnectionKey, size_t>
+  {
+    /**
+     * \brief Returns the hash of a key.
+     * \param key the key
+     * \returns the hash of the key
+     */
+    size_t operator() (const ConnectionKey &key) const;
+  };
+
+  /**
+   * \brief Connected endpoints, indexed by local port, peer address and peer port.
+   */
+  typedef sgi::hash_map<ConnectionKey, IndexedEndPoints, ConnectionKeyHash> ConnectionIndex;
+
+  /**
+   * \brief Endpoints indexed by local port.
+   */
+  typedef sgi::hash_map<uint16_t, IndexedEndPoints> PortIndex;
+
+  /**
+   * \brief Checks if an endpoint is in the connection index.
+   * \param endPoint the endpoint
+   * \returns true if both the peer address and the peer port of the endpoint are set
+   */
+  static bool IsConnected (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Get the key of a connected endpoint.
+   * \param endPoint the endpoint
+   * \returns the key of the endpoint in the connection index
+   */
+  static ConnectionKey GetConnectionKey (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Removes an endpoint from a container of indexed endpoints.
+   * \param endPoints the container
+   * \param endPoint the endpoint to remove
+   * \returns the allocation order of the endpoint
+   */
+  static uint64_t Remove (IndexedEndPoints &endPoints, Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Adds a newly allocated endpoint to the demux.
+   * \param endPoint the endpoint
+   */
+  void Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Adds an endpoint to the connection or wildcard index.
+   * \param endPoint the endpoint
+   * \param sequence the allocation order of the endpoint
+   */
+  void Index (Ipv4EndPoint *endPoint, uint64_t sequence);
+
+  /**
+   * \brief Removes an endpoint from the connection or wildcard index.
+   *
+   * Called before the peer of the endpoint changes.
+   *
+   * \param endPoint the endpoint
+   * \returns the allocation order of the endpoint
+   */
+  uint64_t Unindex (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Get the endpoints which may match a packet, in allocation order.
+   * \param dport destination port of the packet
+   * \param saddr source address of the packet
+   * \param sport source port of the packet
+   * \returns the connected endpoints matching the packet and the wildcard endpoints on dport
+   */
+  IndexedEndPoints GetCandidates (uint16_t dport, Ipv4Address saddr, uint16_t sport);
 
   /**
    * \brief Allocate an ephemeral port.
@@ -184,9 +298,24 @@ private:
   uint16_t m_portFirst;
 
   /**
-   * \brief A list of IPv4 end points.
+   * \brief Allocation order of the next end point.
+   */
+  uint64_t m_sequence;
+
+  /**
+   * \brief All the IPv4 end points, by local port.
+   */
+  PortIndex m_localPorts;
+
+  /**
+   * \brief The connected IPv4 end points.
+   */
+  ConnectionIndex m_connections;
+
+  /**
+   * \brief The wildcard IPv4 end points, by local port.
    */
-  EndPoints m_endPoints;
+  PortIndex m_wildcards;
 };
 
 } // namespace ns3
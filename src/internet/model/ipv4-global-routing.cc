@@ -17,6 +17,7 @@
 //
 
 #include <vector>
+#include <algorithm>
 #include <iomanip>
 #include "ns3/names.h"
 #include "ns3/log.h"
@@ -58,7 +59,8 @@ Ipv4GlobalRouting::GetTypeId (void)
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_respondToInterfaceEvents (false),
+    m_routeSequence (0)
 {
   NS_LOG_FUNCTION (this);
 
@@ -79,6 +81,8 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  m_hostIndex[dest].push_back (route);
+  m_candidateCache.clear ();
 }
 
 void 
@@ -89,6 +93,8 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  m_hostIndex[dest].push_back (route);
+  m_candidateCache.clear ();
 }
 
 void 
@@ -104,6 +110,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  IndexRoute (m_networkIndex, route);
 }
 
 void 
@@ -117,6 +124,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  IndexRoute (m_networkIndex, route);
 }
 
 void 
@@ -132,9 +140,92 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  IndexRoute (m_ASexternalIndex, route);
 }
 
 
+void
+Ipv4GlobalRouting::IndexRoute (PrefixIndex &index, Ipv4RoutingTableEntry *route)
+{
+  NS_LOG_FUNCTION (this << &index << route);
+  Ipv4Mask mask = route->GetDestNetworkMask ();
+  Ipv4Address network = route->GetDestNetwork ().CombineMask (mask);
+  index[mask.Get ()][network].push_back (std::make_pair (m_routeSequence++, route));
+  m_candidateCache.clear ();
+}
+
+void
+Ipv4GlobalRouting::UnindexRoute (PrefixIndex &index, Ipv4RoutingTableEntry *route)
+{
+  NS_LOG_FUNCTION (this << &index << route);
+  Ipv4Mask mask = route->GetDestNetworkMask ();
+  Ipv4Address network = route->GetDestNetwork ().CombineMask (mask);
+  PrefixIndex::iterator i = index.find (mask.Get ());
+  NS_ASSERT (i != index.end ());
+  NetworkIndex::iterator j = i->second.find (network);
+  NS_ASSERT (j != i->second.end ());
+  for (IndexedRoutes::iterator k = j->second.begin (); k != j->second.end (); k++)
+    {
+      if (k->second == route)
+        {
+          j->second.erase (k);
+          break;
+        }
+    }
+  if (j->second.empty ())
+    {
+      i->second.erase (j);
+      if (i->second.empty ())
+        {
+          index.erase (i);
+        }
+    }
+  m_candidateCache.clear ();
+}
+
+void
+Ipv4GlobalRouting::LookupPrefixIndex (const PrefixIndex &index, Ipv4Address dest, RouteVec &routes) const
+{
+  NS_LOG_FUNCTION (this << &index << dest);
+  // one hash lookup per distinct network mask; the matches are then put
+  // back in the order in which the routes were added to the routing table
+  IndexedRoutes matches;
+  for (PrefixIndex::const_iterator i = index.begin (); i != index.end (); i++)
+    {
+      NetworkIndex::const_iterator j = i->second.find (dest.CombineMask (Ipv4Mask (i->first)));
+      if (j != i->second.end ())
+        {
+          matches.insert (matches.end (), j->second.begin (), j->second.end ());
+        }
+    }
+  std::sort (matches.begin (), matches.end ());
+  routes.clear ();
+  for (IndexedRoutes::const_iterator k = matches.begin (); k != matches.end (); k++)
+    {
+      routes.push_back (k->second);
+    }
+}
+
+const Ipv4GlobalRouting::RouteCandidates &
+Ipv4GlobalRouting::GetRouteCandidates (Ipv4Address dest)
+{
+  NS_LOG_FUNCTION (this << dest);
+  CandidateCache::iterator i = m_candidateCache.find (dest);
+  if (i != m_candidateCache.end ())
+    {
+      return i->second;
+    }
+  RouteCandidates &candidates = m_candidateCache[dest];
+  HostIndex::const_iterator j = m_hostIndex.find (dest);
+  if (j != m_hostIndex.end ())
+    {
+      candidates.hostRoutes = j->second;
+    }
+  LookupPrefixIndex (m_networkIndex, dest, candidates.networkRoutes);
+  LookupPrefixIndex (m_ASexternalIndex, dest, candidates.externalRoutes);
+  return candidates;
+}
+
 Ptr<Ipv4Route>
 Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
 {
@@ -142,75 +233,62 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   NS_LOG_LOGIC ("Looking for route for destination " << dest);
   Ptr<Ipv4Route> rtentry = 0;
   // store all available routes that bring packets to their destination
-  typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
-  RouteVec_t allRoutes;
+  RouteVec allRoutes;
+  const RouteCandidates &candidates = GetRouteCandidates (dest);
 
-  NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  NS_LOG_LOGIC ("Number of matching host routes = " << candidates.hostRoutes.size ());
+  for (RouteVec::const_iterator i = candidates.hostRoutes.begin ();
+       i != candidates.hostRoutes.end ();
+       i++)
     {
       NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest ().IsEqual (dest)) 
+      if (oif != 0)
         {
-          if (oif != 0)
+          if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
             {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
-                {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
-                  continue;
-                }
+              NS_LOG_LOGIC ("Not on requested interface, skipping");
+              continue;
             }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
         }
+      allRoutes.push_back (*i);
+      NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i);
     }
   if (allRoutes.size () == 0) // if no host route is found
     {
-      NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      NS_LOG_LOGIC ("Number of matching network routes = " << candidates.networkRoutes.size ());
+      for (RouteVec::const_iterator j = candidates.networkRoutes.begin ();
+           j != candidates.networkRoutes.end ();
+           j++)
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
+          if (oif != 0)
             {
-              if (oif != 0)
+              if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
+                  NS_LOG_LOGIC ("Not on requested interface, skipping");
+                  continue;
                 }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
             }
+          allRoutes.push_back (*j);
+          NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
         }
     }
   if (allRoutes.size () == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
+      for (RouteVec::const_iterator k = candidates.externalRoutes.begin ();
+           k != candidates.externalRoutes.end ();
            k++)
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
+          NS_LOG_LOGIC ("Found external route" << *k);
+          if (oif != 0)
             {
-              NS_LOG_LOGIC ("Found external route" << *k);
-              if (oif != 0)
+              if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
+                  NS_LOG_LOGIC ("Not on requested interface, skipping");
+                  continue;
                 }
-              allRoutes.push_back (*k);
-              break;
             }
+          allRoutes.push_back (*k);
+          break;
         }
     }
   if (allRoutes.size () > 0 ) // if route(s) is found
@@ -318,6 +396,13 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           if (tmp  == index)
             {
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
+              RouteVec &hostRoutes = m_hostIndex[(*i)->GetDest ()];
+              hostRoutes.erase (std::find (hostRoutes.begin (), hostRoutes.end (), *i));
+              if (hostRoutes.empty ())
+                {
+                  m_hostIndex.erase ((*i)->GetDest ());
+                }
+              m_candidateCache.clear ();
               delete *i;
               m_hostRoutes.erase (i);
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
@@ -335,6 +420,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
+          UnindexRoute (m_networkIndex, *j);
           delete *j;
           m_networkRoutes.erase (j);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -351,6 +437,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
+          UnindexRoute (m_ASexternalIndex, *k);
           delete *k;
           m_ASexternalRoutes.erase (k);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -391,6 +478,10 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostIndex.clear ();
+  m_networkIndex.clear ();
+  m_ASexternalIndex.clear ();
+  m_candidateCache.clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -21,6 +21,8 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <map>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -28,6 +30,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/sgi-hashmap.h"
 
 namespace ns3 {
 
@@ -63,6 +66,13 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * Besides the lists of host, network and external routes, which define the
+ * order of the routing table, routes are indexed by destination: host routes
+ * in a hash table, network and external routes in one hash table per distinct
+ * network mask. The routes matching a destination, i.e. its ECMP candidates,
+ * are cached per destination until the routing table changes, so the lookup
+ * cost of RouteInput and RouteOutput does not grow with the number of routes.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -258,12 +268,69 @@ private:
   /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
   typedef std::list<Ipv4RoutingTableEntry *>::iterator ASExternalRoutesI;
 
+  /// container of Ipv4RoutingTableEntry matching a destination, in routing table order
+  typedef std::vector<Ipv4RoutingTableEntry *> RouteVec;
+
+  /// Routes matching a destination
+  struct RouteCandidates
+  {
+    RouteVec hostRoutes;     //!< Matching host routes
+    RouteVec networkRoutes;  //!< Matching network routes
+    RouteVec externalRoutes; //!< Matching external routes
+  };
+
+  /// container of routes with the sequence number giving their routing table order
+  typedef std::vector<std::pair<uint32_t, Ipv4RoutingTableEntry *> > IndexedRoutes;
+  /// routes with the same network mask, indexed by destination network
+  typedef sgi::hash_map<Ipv4Address, IndexedRoutes, Ipv4AddressHash> NetworkIndex;
+  /// routes indexed by network mask, then by destination network
+  typedef std::map<uint32_t, NetworkIndex> PrefixIndex;
+  /// host routes indexed by destination
+  typedef sgi::hash_map<Ipv4Address, RouteVec, Ipv4AddressHash> HostIndex;
+  /// route candidates cached per destination
+  typedef sgi::hash_map<Ipv4Address, RouteCandidates, Ipv4AddressHash> CandidateCache;
+
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
+  /**
+   * \brief Get the routes matching a destination, from the cache if possible
+   * \param dest the destination
+   * \return the routes matching dest, in routing table order
+   */
+  const RouteCandidates &GetRouteCandidates (Ipv4Address dest);
+
+  /**
+   * \brief Add a network or external route to a prefix index
+   * \param index the prefix index
+   * \param route the route
+   */
+  void IndexRoute (PrefixIndex &index, Ipv4RoutingTableEntry *route);
+
+  /**
+   * \brief Remove a network or external route from a prefix index
+   * \param index the prefix index
+   * \param route the route
+   */
+  void UnindexRoute (PrefixIndex &index, Ipv4RoutingTableEntry *route);
+
+  /**
+   * \brief Get the routes of a prefix index matching a destination
+   * \param index the prefix index
+   * \param dest the destination
+   * \param routes the matching routes, in routing table order
+   */
+  void LookupPrefixIndex (const PrefixIndex &index, Ipv4Address dest, RouteVec &routes) const;
+
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  HostIndex m_hostIndex;               //!< Routes to hosts, by destination
+  PrefixIndex m_networkIndex;          //!< Routes to networks, by mask and network
+  PrefixIndex m_ASexternalIndex;       //!< External routes, by mask and network
+  uint32_t m_routeSequence;            //!< Sequence number of the next route added
+  CandidateCache m_candidateCache;     //!< Routes matching each destination looked up
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
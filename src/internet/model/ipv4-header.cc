@@ -41,6 +41,7 @@ Ipv4Header::Ipv4Header ()
     m_fragmentOffset (0),
     m_checksum (0),
     m_goodChecksum (true),
+    m_checksumValid (false),
     m_headerSize(5*4)
 {
 }
@@ -57,6 +58,7 @@ Ipv4Header::SetPayloadSize (uint16_t size)
 {
   NS_LOG_FUNCTION (this << size);
   m_payloadSize = size;
+  m_checksumValid = false;
 }
 uint16_t
 Ipv4Header::GetPayloadSize (void) const
@@ -76,6 +78,7 @@ Ipv4Header::SetIdentification (uint16_t identification)
 {
   NS_LOG_FUNCTION (this << identification);
   m_identification = identification;
+  m_checksumValid = false;
 }
 
 void 
@@ -83,6 +86,7 @@ Ipv4Header::SetTos (uint8_t tos)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (tos));
   m_tos = tos;
+  m_checksumValid = false;
 }
 
 void
@@ -91,6 +95,7 @@ Ipv4Header::SetDscp (DscpType dscp)
   NS_LOG_FUNCTION (this << dscp);
   m_tos &= 0x3; // Clear out the DSCP part, retain 2 bits of ECN
   m_tos |= dscp;
+  m_checksumValid = false;
 }
 
 void
@@ -99,6 +104,7 @@ Ipv4Header::SetEcn (EcnType ecn)
   NS_LOG_FUNCTION (this << ecn);
   m_tos &= 0xFC; // Clear out the ECN part, retain 6 bits of DSCP
   m_tos |= ecn;
+  m_checksumValid = false;
 }
 
 Ipv4Header::DscpType 
@@ -201,12 +207,14 @@ Ipv4Header::SetMoreFragments (void)
 {
   NS_LOG_FUNCTION (this);
   m_flags |= MORE_FRAGMENTS;
+  m_checksumValid = false;
 }
 void
 Ipv4Header::SetLastFragment (void)
 {
   NS_LOG_FUNCTION (this);
   m_flags &= ~MORE_FRAGMENTS;
+  m_checksumValid = false;
 }
 bool 
 Ipv4Header::IsLastFragment (void) const
@@ -220,12 +228,14 @@ Ipv4Header::SetDontFragment (void)
 {
   NS_LOG_FUNCTION (this);
   m_flags |= DONT_FRAGMENT;
+  m_checksumValid = false;
 }
 void 
 Ipv4Header::SetMayFragment (void)
 {
   NS_LOG_FUNCTION (this);
   m_flags &= ~DONT_FRAGMENT;
+  m_checksumValid = false;
 }
 bool 
 Ipv4Header::IsDontFragment (void) const
@@ -241,6 +251,7 @@ Ipv4Header::SetFragmentOffset (uint16_t offsetBytes)
   // check if the user is trying to set an invalid offset
   NS_ABORT_MSG_IF ((offsetBytes & 0x7), "offsetBytes must be multiple of 8 bytes");
   m_fragmentOffset = offsetBytes;
+  m_checksumValid = false;
 }
 uint16_t 
 Ipv4Header::GetFragmentOffset (void) const
@@ -259,6 +270,19 @@ void
 Ipv4Header::SetTtl (uint8_t ttl)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (ttl));
+  if (m_checksumValid)
+    {
+      // Update the checksum of the word holding the TTL and the protocol,
+      // read in little endian order, as per equation 3 of RFC 1624.
+      uint16_t oldWord = m_ttl | (m_protocol << 8);
+      uint16_t newWord = ttl | (m_protocol << 8);
+      uint32_t sum = static_cast<uint16_t> (~m_checksum);
+      sum += static_cast<uint16_t> (~oldWord);
+      sum += newWord;
+      while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+      m_checksum = ~sum;
+    }
   m_ttl = ttl;
 }
 uint8_t 
@@ -279,6 +303,7 @@ Ipv4Header::SetProtocol (uint8_t protocol)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (protocol));
   m_protocol = protocol;
+  m_checksumValid = false;
 }
 
 void 
@@ -286,6 +311,7 @@ Ipv4Header::SetSource (Ipv4Address source)
 {
   NS_LOG_FUNCTION (this << source);
   m_source = source;
+  m_checksumValid = false;
 }
 Ipv4Address
 Ipv4Header::GetSource (void) const
@@ -299,6 +325,7 @@ Ipv4Header::SetDestination (Ipv4Address dst)
 {
   NS_LOG_FUNCTION (this << dst);
   m_destination = dst;
+  m_checksumValid = false;
 }
 Ipv4Address
 Ipv4Header::GetDestination (void) const
@@ -405,11 +432,18 @@ Ipv4Header::Serialize (Buffer::Iterator start) const
   i.WriteU8 (frag);
   i.WriteU8 (m_ttl);
   i.WriteU8 (m_protocol);
-  i.WriteHtonU16 (0);
+  if (m_calcChecksum && m_checksumValid)
+    {
+      i.WriteU16 (m_checksum);
+    }
+  else
+    {
+      i.WriteHtonU16 (0);
+    }
   i.WriteHtonU32 (m_source.Get ());
   i.WriteHtonU32 (m_destination.Get ());
 
-  if (m_calcChecksum) 
+  if (m_calcChecksum && !m_checksumValid)
     {
       i = start;
       uint16_t checksum = i.CalculateIpChecksum (20);
@@ -454,6 +488,7 @@ Ipv4Header::Deserialize (Buffer::Iterator start)
   m_source.Set (i.ReadNtohU32 ());
   m_destination.Set (i.ReadNtohU32 ());
   m_headerSize = headerSize;
+  m_checksumValid = false;
 
   if (m_calcChecksum) 
     {
@@ -462,6 +497,9 @@ Ipv4Header::Deserialize (Buffer::Iterator start)
       NS_LOG_LOGIC ("checksum=" <<checksum);
 
       m_goodChecksum = (checksum == 0);
+      // A good checksum stays valid, and is updated when only the TTL
+      // changes, unless there were options, which are not serialized.
+      m_checksumValid = m_goodChecksum && headerSize == 5*4;
     }
   return GetSerializedSize ();
 }
@@ -73,6 +73,17 @@ Ipv4L3Protocol::GetTypeId (void)
                    TimeValue (Seconds (30)),
                    MakeTimeAccessor (&Ipv4L3Protocol::m_fragmentExpirationTimeout),
                    MakeTimeChecker ())
+    .AddAttribute ("RouteCache",
+                   "Cache the route of each destination forwarded by the "
+                   "routing protocol, per input interface, and forward the "
+                   "next packets to this destination without calling the "
+                   "routing protocol. The cache is flushed when an interface "
+                   "or an address changes; it must not be used with routing "
+                   "protocols which route the packets of a destination "
+                   "differently, e.g., with per-packet ECMP.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4L3Protocol::m_routeCacheEnabled),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Tx",
                      "Send ipv4 packet to outgoing interface.",
                      MakeTraceSourceAccessor (&Ipv4L3Protocol::m_txTrace),
@@ -112,6 +123,7 @@ Ipv4L3Protocol::GetTypeId (void)
 }
 
 Ipv4L3Protocol::Ipv4L3Protocol()
+  : m_routeCacheInterface (-1)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -206,6 +218,14 @@ Ipv4L3Protocol::SetRoutingProtocol (Ptr<Ipv4RoutingProtocol> routingProtocol)
   NS_LOG_FUNCTION (this << routingProtocol);
   m_routingProtocol = routingProtocol;
   m_routingProtocol->SetIpv4 (this);
+  FlushRouteCache ();
+}
+
+void
+Ipv4L3Protocol::FlushRouteCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_routeCaches.clear ();
 }
 
 
@@ -225,6 +245,7 @@ Ipv4L3Protocol::DoDispose (void)
       *i = 0;
     }
   m_protocols.clear ();
+  m_routeCaches.clear ();
 
   for (Ipv4InterfaceList::iterator i = m_interfaces.begin (); i != m_interfaces.end (); ++i)
     {
@@ -531,13 +552,29 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
       socket->ForwardUp (packet, ipHeader, ipv4Interface);
     }
 
+  if (m_routeCacheEnabled)
+    {
+      if (interface < m_routeCaches.size ())
+        {
+          RouteCache_t::const_iterator route = m_routeCaches[interface].find (ipHeader.GetDestination ());
+          if (route != m_routeCaches[interface].end ())
+            {
+              NS_LOG_LOGIC ("Forwarding with the cached route");
+              DoIpForward (route->second, packet, ipHeader);
+              return;
+            }
+        }
+      m_routeCacheInterface = interface;
+    }
+
   NS_ASSERT_MSG (m_routingProtocol != 0, "Need a routing protocol object to process packets");
-  if (!m_routingProtocol->RouteInput (packet, ipHeader, device,
-                                      MakeCallback (&Ipv4L3Protocol::IpForward, this),
-                                      MakeCallback (&Ipv4L3Protocol::IpMulticastForward, this),
-                                      MakeCallback (&Ipv4L3Protocol::LocalDeliver, this),
-                                      MakeCallback (&Ipv4L3Protocol::RouteInputError, this)
-                                      ))
+  bool routed = m_routingProtocol->RouteInput (packet, ipHeader, device,
+                                               MakeCallback (&Ipv4L3Protocol::IpForward, this),
+                                               MakeCallback (&Ipv4L3Protocol::IpMulticastForward, this),
+                                               MakeCallback (&Ipv4L3Protocol::LocalDeliver, this),
+                                               MakeCallback (&Ipv4L3Protocol::RouteInputError, this));
+  m_routeCacheInterface = -1;
+  if (!routed)
     {
       NS_LOG_WARN ("No route found for forwarding packet.  Drop.");
       m_dropTrace (ipHeader, packet, DROP_NO_ROUTE, m_node->GetObject<Ipv4> (), interface);
@@ -805,7 +842,7 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   Ptr<Ipv4Interface> outInterface = GetInterface (interface);
   NS_LOG_LOGIC ("Send via NetDevice ifIndex " << outDev->GetIfIndex () << " ipv4InterfaceIndex " << interface);
 
-  if (!route->GetGateway ().IsEqual (Ipv4Address ("0.0.0.0")))
+  if (!route->GetGateway ().IsEqual (Ipv4Address::GetAny ()))
     {
       if (outInterface->IsUp ())
         {
@@ -906,10 +943,26 @@ void
 Ipv4L3Protocol::IpForward (Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ipv4Header &header)
 {
   NS_LOG_FUNCTION (this << rtentry << p << header);
+  // Only the routes given while Receive calls the routing protocol are
+  // cached, not those of packets the routing protocol queued.
+  if (m_routeCacheInterface >= 0)
+    {
+      if (static_cast<uint32_t> (m_routeCacheInterface) >= m_routeCaches.size ())
+        {
+          m_routeCaches.resize (m_routeCacheInterface + 1);
+        }
+      m_routeCaches[m_routeCacheInterface][header.GetDestination ()] = rtentry;
+    }
+  DoIpForward (rtentry, p->Copy (), header);
+}
+
+void
+Ipv4L3Protocol::DoIpForward (Ptr<Ipv4Route> rtentry, Ptr<Packet> packet, const Ipv4Header &header)
+{
+  NS_LOG_FUNCTION (this << rtentry << packet << header);
   NS_LOG_LOGIC ("Forwarding logic for node: " << m_node->GetId ());
   // Forwarding
   Ipv4Header ipHeader = header;
-  Ptr<Packet> packet = p->Copy ();
   int32_t interface = GetInterfaceForDevice (rtentry->GetOutputDevice ());
   ipHeader.SetTtl (ipHeader.GetTtl () - 1);
   if (ipHeader.GetTtl () == 0)
@@ -999,6 +1052,7 @@ Ipv4L3Protocol::AddAddress (uint32_t i, Ipv4InterfaceAddress address)
   NS_LOG_FUNCTION (this << i << address);
   Ptr<Ipv4Interface> interface = GetInterface (i);
   bool retVal = interface->AddAddress (address);
+  FlushRouteCache ();
   if (m_routingProtocol != 0)
     {
       m_routingProtocol->NotifyAddAddress (i, address);
@@ -1030,6 +1084,7 @@ Ipv4L3Protocol::RemoveAddress (uint32_t i, uint32_t addressIndex)
   Ipv4InterfaceAddress address = interface->RemoveAddress (addressIndex);
   if (address != Ipv4InterfaceAddress ())
     {
+      FlushRouteCache ();
       if (m_routingProtocol != 0)
         {
           m_routingProtocol->NotifyRemoveAddress (i, address);
@@ -1053,6 +1108,7 @@ Ipv4L3Protocol::RemoveAddress (uint32_t i, Ipv4Address address)
   Ipv4InterfaceAddress ifAddr = interface->RemoveAddress (address);
   if (ifAddr != Ipv4InterfaceAddress ())
     {
+      FlushRouteCache ();
       if (m_routingProtocol != 0)
         {
           m_routingProtocol->NotifyRemoveAddress (i, ifAddr);
@@ -1121,6 +1177,7 @@ Ipv4L3Protocol::SetMetric (uint32_t i, uint16_t metric)
   NS_LOG_FUNCTION (this << i << metric);
   Ptr<Ipv4Interface> interface = GetInterface (i);
   interface->SetMetric (metric);
+  FlushRouteCache ();
 }
 
 uint16_t
@@ -1160,6 +1217,7 @@ Ipv4L3Protocol::SetUp (uint32_t i)
   if (interface->GetDevice ()->GetMtu () >= 68)
     {
       interface->SetUp ();
+      FlushRouteCache ();
 
       if (m_routingProtocol != 0)
         {
@@ -1178,6 +1236,7 @@ Ipv4L3Protocol::SetDown (uint32_t ifaceIndex)
   NS_LOG_FUNCTION (this << ifaceIndex);
   Ptr<Ipv4Interface> interface = GetInterface (ifaceIndex);
   interface->SetDown ();
+  FlushRouteCache ();
 
   if (m_routingProtocol != 0)
     {
@@ -1200,6 +1259,7 @@ Ipv4L3Protocol::SetForwarding (uint32_t i, bool val)
   NS_LOG_FUNCTION (this << i);
   Ptr<Ipv4Interface> interface = GetInterface (i);
   interface->SetForwarding (val);
+  FlushRouteCache ();
 }
 
 Ptr<NetDevice>
@@ -1218,6 +1278,7 @@ Ipv4L3Protocol::SetIpForward (bool forward)
     {
       (*i)->SetForwarding (forward);
     }
+  FlushRouteCache ();
 }
 
 bool 
@@ -114,6 +114,14 @@ public:
   void SetRoutingProtocol (Ptr<Ipv4RoutingProtocol> routingProtocol);
   Ptr<Ipv4RoutingProtocol> GetRoutingProtocol (void) const;
 
+  /**
+   * \brief Flush the routes cached for forwarding, see the RouteCache attribute.
+   *
+   * It must be called after changing the routes of the routing protocol
+   * without changing the interfaces or addresses.
+   */
+  void FlushRouteCache (void);
+
   Ptr<Socket> CreateRawSocket (void);
   void DeleteRawSocket (Ptr<Socket> socket);
 
@@ -349,6 +357,17 @@ private:
              Ptr<const Packet> p, 
              const Ipv4Header &header);
 
+  /**
+   * \brief Forward a packet which is not shared.
+   * \param rtentry route
+   * \param packet packet to forward
+   * \param header IPv4 header to add to the packet
+   */
+  void
+  DoIpForward (Ptr<Ipv4Route> rtentry,
+               Ptr<Packet> packet,
+               const Ipv4Header &header);
+
   /**
    * \brief Forward a multicast packet.
    * \param mrtentry route
@@ -439,6 +458,10 @@ private:
    * \brief Container of the IPv4 L4 instances.
    */
    typedef std::list<Ptr<IpL4Protocol> > L4List_t;
+  /**
+   * \brief Container of the forwarding routes, by destination.
+   */
+  typedef std::map<Ipv4Address, Ptr<Ipv4Route> > RouteCache_t;
 
   bool m_ipForward;      //!< Forwarding packets (i.e. router mode) state.
   bool m_weakEsModel;    //!< Weak ES model state
@@ -448,6 +471,9 @@ private:
   uint8_t m_defaultTtl;  //!< Default TTL
   std::map<std::pair<uint64_t, uint8_t>, uint16_t> m_identification; //!< Identification (for each {src, dst, proto} tuple)
   Ptr<Node> m_node; //!< Node attached to stack.
+  bool m_routeCacheEnabled; //!< Forward packets with the cached routes
+  std::vector<RouteCache_t> m_routeCaches; //!< Cached routes, by input interface
+  int32_t m_routeCacheInterface; //!< Input interface of the packet being routed, or -1
 
   /// Trace of sent packets
   TracedCallback<const Ipv4Header &, Ptr<const Packet>, uint32_t> m_sendOutgoingTrace;
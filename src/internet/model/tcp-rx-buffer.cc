@@ -52,7 +52,8 @@ TcpRxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpRxBuffer::TcpRxBuffer (uint32_t n)
-  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0)
+  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0),
+    m_virtualPayload (false)
 {
 }
 
@@ -156,16 +157,21 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
+  // Remove overlapped bytes from packet. Runs are disjoint, so only the run
+  // holding headSeq, if any, may end after headSeq and start before it
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      --i;
+    }
   while (i != m_data.end () && i->first <= tailSeq)
     {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
+      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second.m_size);
       if (lastByteSeq > headSeq)
         {
           if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
+            { // Rare case: Existing run is embedded fully in the new packet
+              m_size -= i->second.m_size;
               m_data.erase (i++);
               continue;
             }
@@ -186,31 +192,61 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       NS_LOG_LOGIC ("Nothing to buffer");
       return false; // Nothing to buffer anyway
     }
+  uint32_t length = tailSeq - headSeq;
+  if (m_virtualPayload)
+    {
+      p = 0;
+    }
   else
     {
       uint32_t start = headSeq - tcph.GetSequenceNumber ();
-      uint32_t length = tailSeq - headSeq;
       p = p->CreateFragment (start, length);
       NS_ASSERT (length == p->GetSize ());
     }
-  // Insert packet into buffer
   NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
-  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
-  // Update variables
-  m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << length);
+  m_size += length;             // Occupancy
+
+  // Insert packet into buffer, appending it to the run ending at headSeq
+  // and the run starting at tailSeq to it
+  BufIterator next = m_data.lower_bound (headSeq);
+  BufIterator run = next;
+  if (run != m_data.begin ())
+    {
+      --run;
+    }
+  if (run != next && run->first + SequenceNumber32 (run->second.m_size) == headSeq)
     {
-      if (i->first < m_nextRxSeq)
+      if (p != 0)
         {
-          continue;
+          run->second.m_packet->AddAtEnd (p);
         }
-      else if (i->first > m_nextRxSeq)
+      run->second.m_size += length;
+    }
+  else
+    {
+      Run newRun;
+      newRun.m_size = length;
+      newRun.m_packet = p;
+      run = m_data.insert (next, std::make_pair (headSeq, newRun));
+    }
+  if (next != m_data.end () && next->first == tailSeq)
+    {
+      if (next->second.m_packet != 0)
         {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+          run->second.m_packet->AddAtEnd (next->second.m_packet);
+        }
+      run->second.m_size += next->second.m_size;
+      m_data.erase (next);
+    }
+  NS_LOG_LOGIC ("Run of seqno=" << run->first << " has now len=" << run->second.m_size);
+
+  // Update variables
+  SequenceNumber32 runEnd = run->first + SequenceNumber32 (run->second.m_size);
+  if (run->first <= m_nextRxSeq && runEnd > m_nextRxSeq)
+    {
+      m_availBytes += runEnd - m_nextRxSeq.Get ();
+      m_nextRxSeq = runEnd;
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -229,32 +265,36 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   NS_LOG_LOGIC ("Requested to extract " << extractSize << " bytes from TcpRxBuffer of size=" << m_size);
   if (extractSize == 0) return 0;  // No contiguous block to return
   NS_ASSERT (m_data.size ()); // At least we have something to extract
-  Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
-  BufIterator i;
-  while (extractSize)
-    { // Check the buffered data for delivery
-      i = m_data.begin ();
-      NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
-      // Check if we send the whole pkt or just a partial
-      uint32_t pktSize = i->second->GetSize ();
-      if (pktSize <= extractSize)
-        { // Whole packet is extracted
-          outPkt->AddAtEnd (i->second);
-          m_data.erase (i);
-          m_size -= pktSize;
-          m_availBytes -= pktSize;
-          extractSize -= pktSize;
-        }
-      else
-        { // Partial is extracted and done
-          outPkt->AddAtEnd (i->second->CreateFragment (0, extractSize));
-          m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
-          m_data.erase (i);
-          m_size -= extractSize;
-          m_availBytes -= extractSize;
-          extractSize = 0;
+  // The data available to read is the head of the first run
+  BufIterator i = m_data.begin ();
+  NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
+  Ptr<Packet> outPkt; // The packet that contains all the data to return
+  uint32_t pktSize = i->second.m_size;
+  if (m_virtualPayload)
+    { // Only the byte count is kept
+      outPkt = Create<Packet> (std::min (pktSize, extractSize));
+      if (pktSize > extractSize)
+        {
+          Run &rest = m_data[i->first + SequenceNumber32 (extractSize)];
+          rest.m_size = pktSize - extractSize;
         }
+      m_data.erase (i);
+    }
+  else if (pktSize <= extractSize)
+    { // Whole run is extracted
+      outPkt = i->second.m_packet;
+      m_data.erase (i);
+    }
+  else
+    { // Partial is extracted and done
+      outPkt = i->second.m_packet->CreateFragment (0, extractSize);
+      Run &rest = m_data[i->first + SequenceNumber32 (extractSize)];
+      rest.m_size = pktSize - extractSize;
+      rest.m_packet = i->second.m_packet->CreateFragment (extractSize, pktSize - extractSize);
+      m_data.erase (i);
     }
+  m_size -= outPkt->GetSize ();
+  m_availBytes -= outPkt->GetSize ();
   if (outPkt->GetSize () == 0)
     {
       NS_LOG_LOGIC ("Nothing extracted.");
@@ -265,4 +305,18 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   return outPkt;
 }
 
+void
+TcpRxBuffer::SetVirtualPayload (bool virtualPayload)
+{
+  NS_LOG_FUNCTION (this << virtualPayload);
+  NS_ASSERT_MSG (m_size == 0, "The payload mode can only be changed while the buffer is empty");
+  m_virtualPayload = virtualPayload;
+}
+
+bool
+TcpRxBuffer::IsVirtualPayload (void) const
+{
+  return m_virtualPayload;
+}
+
 } //namepsace ns3
@@ -36,6 +36,17 @@ class Packet;
  *
  * \brief class for the reordering buffer that keeps the data from lower layer, i.e.
  *        TcpL4Protocol, sent to the application
+ *
+ * The data is kept as runs of contiguous bytes, one packet per run, in a map
+ * indexed by the sequence number of their first byte. A segment adjacent to
+ * a run is appended to it, so runs are never contiguous with each other: the
+ * in-sequence data is always the first run, the holes are the gaps between
+ * runs, and a packet is merged with its neighbours in O(log n). Extract
+ * returns the first run as is when the application reads all of it.
+ *
+ * With a virtual payload, the runs only keep their number of bytes, so
+ * merging and splitting them is arithmetic, and Extract returns a
+ * zero-filled packet of the extracted size.
  */
 class TcpRxBuffer : public Object
 {
@@ -124,16 +135,38 @@ public:
    * \returns a packet
    */
   Ptr<Packet> Extract (uint32_t maxSize);
+
+  /**
+   * Set whether only the number of bytes of the data is kept, instead of
+   * the payload of the segments received. Supposed to be called only when
+   * the buffer is empty.
+   *
+   * \param virtualPayload Whether the payload is virtual
+   */
+  void SetVirtualPayload (bool virtualPayload);
+
+  /**
+   * Returns whether only the number of bytes of the data is kept
+   * \returns true if the payload is virtual
+   */
+  bool IsVirtualPayload (void) const;
 public:
+  /// a run of contiguous bytes
+  struct Run
+  {
+    uint32_t m_size;       //!< Number of bytes of the run
+    Ptr<Packet> m_packet;  //!< The bytes of the run, or 0 with a virtual payload
+  };
   /// container for data stored in the buffer
-  typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
+  typedef std::map<SequenceNumber32, Run>::iterator BufIterator;
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //!< Seqnum of the FIN packet
   bool m_gotFin;                             //!< Did I received FIN packet?
   uint32_t m_size;                           //!< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
-  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  std::map<SequenceNumber32, Run> m_data;    //!< Runs of contiguous data, by first byte (may be empty)
+  bool m_virtualPayload;                     //!< Whether only the number of bytes is kept
 };
 
 } //namepsace ns3
@@ -39,6 +39,7 @@
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/pointer.h"
 #include "ns3/trace-source-accessor.h"
 #include "tcp-socket-base.h"
@@ -118,6 +119,13 @@ TcpSocketBase::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&TcpSocketBase::GetRxBuffer),
                    MakePointerChecker<TcpRxBuffer> ())
+    .AddAttribute ("VirtualPayload",
+                   "Only count the bytes of the data, instead of storing "
+                   "the payload. The application reads zero-filled data.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::SetVirtualPayload,
+                                        &TcpSocketBase::GetVirtualPayload),
+                   MakeBooleanChecker ())
     .AddTraceSource ("RTO",
                      "Retransmission timeout",
                      MakeTraceSourceAccessor (&TcpSocketBase::m_rto),
@@ -2453,6 +2461,20 @@ TcpSocketBase::GetSndBufSize (void) const
   return m_txBuffer->MaxBufferSize ();
 }
 
+void
+TcpSocketBase::SetVirtualPayload (bool virtualPayload)
+{
+  NS_LOG_FUNCTION (this << virtualPayload);
+  m_txBuffer->SetVirtualPayload (virtualPayload);
+  m_rxBuffer->SetVirtualPayload (virtualPayload);
+}
+
+bool
+TcpSocketBase::GetVirtualPayload (void) const
+{
+  return m_txBuffer->IsVirtualPayload ();
+}
+
 void
 TcpSocketBase::SetRcvBufSize (uint32_t size)
 {
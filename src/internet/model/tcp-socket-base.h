@@ -166,6 +166,25 @@ public:
    */
   Ptr<TcpRxBuffer> GetRxBuffer (void) const;
 
+  /**
+   * \brief Set whether only the number of bytes of the data is kept in the
+   * Tx and Rx buffers, instead of the payload.
+   *
+   * The packets written by the application are then only counted, the
+   * segments sent carry a zero-filled payload, and the packets read by
+   * the application are zero-filled. Supposed to be called before any
+   * data is sent or received.
+   *
+   * \param virtualPayload Whether the payload is virtual
+   */
+  void SetVirtualPayload (bool virtualPayload);
+
+  /**
+   * \brief Get whether only the number of bytes of the data is kept.
+   * \return true if the payload is virtual
+   */
+  bool GetVirtualPayload (void) const;
+
 
   // Necessary implementations of null functions from ns3::Socket
   virtual enum SocketErrno GetErrno (void) const;    // returns m_errno
@@ -737,7 +756,7 @@ protected:
   Ptr<RttEstimator> m_rtt; //!< Round trip time estimator
 
   // Rx and Tx buffer management
-  TracedValue<SequenceNumber32> m_nextTxSequence; //!< Next seqnum to be sent (SND.NXT), ReTx pushes it back
+  OptionalTracedValue<SequenceNumber32> m_nextTxSequence; //!< Next seqnum to be sent (SND.NXT), ReTx pushes it back
   TracedValue<SequenceNumber32> m_highTxMark;     //!< Highest seqno ever sent, regardless of ReTx
   Ptr<TcpRxBuffer>              m_rxBuffer;       //!< Rx buffer (reordering buffer)
   Ptr<TcpTxBuffer>              m_txBuffer;       //!< Tx buffer
@@ -755,8 +774,8 @@ protected:
   // Window management
   uint32_t              m_segmentSize; //!< Segment size
   uint16_t              m_maxWinSize;  //!< Maximum window size to advertise
-  TracedValue<uint32_t> m_rWnd;        //!< Receiver window (RCV.WND in RFC793)
-  TracedValue<SequenceNumber32> m_highRxMark;     //!< Highest seqno received
+  OptionalTracedValue<uint32_t> m_rWnd; //!< Receiver window (RCV.WND in RFC793)
+  OptionalTracedValue<SequenceNumber32> m_highRxMark; //!< Highest seqno received
   TracedValue<SequenceNumber32> m_highRxAckMark;  //!< Highest ack received
 
   // Congestion control
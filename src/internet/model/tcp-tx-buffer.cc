@@ -57,7 +57,8 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_tailOffset (0),
+    m_virtualPayload (false)
 {
 }
 
@@ -111,8 +112,12 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          if (!m_virtualPayload)
+            {
+              m_data.push_back (std::make_pair (m_tailOffset, p));
+            }
           m_size += p->GetSize ();
+          m_tailOffset += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
       return true;
@@ -143,64 +148,53 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
       return Create<Packet> (); // Empty packet returned
     }
   if (m_data.size () == 0)
-    { // No actual data, just return dummy-data packet of correct size
+    { // No actual data (or virtual payload), just return dummy-data packet of correct size
       return Create<Packet> (s);
     }
 
-  // Extract data from the buffer and return
-  uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
-  Ptr<Packet> outPacket;
+  // Find the packet holding the first byte
+  uint64_t offset = m_tailOffset - m_size + (seq - m_firstByteSeq.Get ());
+  BufIterator i = std::upper_bound (m_data.begin (), m_data.end (), offset, StartsAfter);
+  NS_ASSERT (i != m_data.begin ());
+  --i;
   NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+
+  uint32_t packetOffset = offset - i->first;
+  uint32_t fragmentLength = i->second->GetSize () - packetOffset;
+  NS_LOG_LOGIC ("First byte found at stream offset " << offset << " in packet of stream offset " << i->first
+                                                     << ", packet len=" << i->second->GetSize ());
+  if (fragmentLength >= s)
+    { // Data to be copied falls entirely in this packet
+      return i->second->CreateFragment (packetOffset, s);
+    }
+  // This packet only fulfills part of the request
+  Ptr<Packet> outPacket = i->second->CreateFragment (packetOffset, fragmentLength);
+  uint32_t remaining = s - fragmentLength;
+  for (++i; i != m_data.end (); ++i)
     {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
-        }
-      else if (count + pktSize >= offset + s)
+      uint32_t pktSize = i->second->GetSize ();
+      if (pktSize >= remaining)
         { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
-                                                      << ", packet len=" << pktSize);
-          uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
-          outPacket->AddAtEnd (endFragment);
+          NS_LOG_LOGIC ("Last byte found in packet of stream offset " << i->first << ", packet len=" << pktSize);
+          outPacket->AddAtEnd (i->second->CreateFragment (0, remaining));
           NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
           break;
         }
-      else
-        {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-        }
-      count += pktSize;
+      NS_LOG_LOGIC ("Appending to output the packet of stream offset " << i->first << " len=" << pktSize);
+      outPacket->AddAtEnd (i->second);
+      remaining -= pktSize;
+      NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
     }
   NS_ASSERT (outPacket->GetSize () == s);
   return outPacket;
 }
 
+bool
+TcpTxBuffer::StartsAfter (uint64_t offset, const BufItem &item)
+{
+  return offset < item.first;
+}
+
 void
 TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
 {
@@ -217,26 +211,34 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   // Cases do not need to scan the buffer
   if (m_firstByteSeq >= seq) return;
 
-  // Scan the buffer and discard packets
+  if (m_virtualPayload)
+    { // Only the byte count is kept
+      m_size -= std::min<uint32_t> (seq - m_firstByteSeq.Get (), m_size);
+      m_firstByteSeq = seq;
+      return;
+    }
+
+  // Discard packets from the front of the buffer
   uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
   uint32_t pktSize;
   NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
+  while (!m_data.empty () && offset > 0)
     {
-      if (offset > (*i)->GetSize ())
+      BufItem &front = m_data.front ();
+      pktSize = front.second->GetSize ();
+      if (offset >= pktSize)
         { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
           m_size -= pktSize;
           offset -= pktSize;
           m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
+          m_data.pop_front ();
           NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
         }
-      else if (offset > 0)
+      else
         { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
+          pktSize -= offset;
+          front.second = front.second->CreateFragment (offset, pktSize);
+          front.first += offset;
           m_size -= offset;
           m_firstByteSeq += offset;
           NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
@@ -253,4 +255,18 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   NS_ASSERT (m_firstByteSeq == seq);
 }
 
+void
+TcpTxBuffer::SetVirtualPayload (bool virtualPayload)
+{
+  NS_LOG_FUNCTION (this << virtualPayload);
+  NS_ASSERT_MSG (m_size == 0, "The payload mode can only be changed while the buffer is empty");
+  m_virtualPayload = virtualPayload;
+}
+
+bool
+TcpTxBuffer::IsVirtualPayload (void) const
+{
+  return m_virtualPayload;
+}
+
 } // namepsace ns3
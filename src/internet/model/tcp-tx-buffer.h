@@ -21,7 +21,8 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
-#include <list>
+#include <deque>
+#include <utility>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
@@ -36,6 +37,16 @@ class Packet;
  *
  * \brief class for keeping the data sent by the application to the TCP socket, i.e.
  *        the sending buffer.
+ *
+ * The packets written by the application are kept in a deque together with
+ * the stream offset of their first byte, so the packet holding a given
+ * sequence number is found by binary search and acknowledged packets are
+ * removed from the front in constant time. The cost of sending a segment
+ * therefore does not grow with the number of packets buffered.
+ *
+ * With a virtual payload, only the number of bytes written is kept: the
+ * packets written by the application are dropped, and segments are
+ * created with a zero-filled payload of the requested size.
  */
 class TcpTxBuffer : public Object
 {
@@ -127,14 +138,43 @@ public:
    */
   void DiscardUpTo (const SequenceNumber32& seq);
 
+  /**
+   * Set whether only the number of bytes of the data is kept, instead of
+   * the packets written by the application. Supposed to be called only
+   * when the buffer is empty.
+   *
+   * \param virtualPayload Whether the payload is virtual
+   */
+  void SetVirtualPayload (bool virtualPayload);
+
+  /**
+   * Returns whether only the number of bytes of the data is kept
+   * \returns true if the payload is virtual
+   */
+  bool IsVirtualPayload (void) const;
+
 private:
+  /// a packet of the buffer and the stream offset of its first byte
+  typedef std::pair<uint64_t, Ptr<Packet> > BufItem;
   /// container for data stored in the buffer
-  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+  typedef std::deque<BufItem> BufData;
+  /// iterator to the data stored in the buffer
+  typedef BufData::iterator BufIterator;
+
+  /**
+   * \brief Compares a stream offset to the first byte of a packet of the buffer
+   * \param offset the stream offset
+   * \param item the packet of the buffer
+   * \returns true if the packet starts after offset
+   */
+  static bool StartsAfter (uint64_t offset, const BufItem &item);
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
-  std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+  uint64_t m_tailOffset;                        //!< Stream offset of the byte following the data
+  BufData m_data;                               //!< Corresponding data (may be empty)
+  bool m_virtualPayload;                        //!< Whether only the number of bytes is kept
 };
 
 } // namepsace ns3
@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-interface-address.h"
+
+namespace ns3 {
+
+/**
+ * \brief Checks that Ipv4EndPointDemux finds the most specific endpoint
+ * of a packet: the connected endpoint matching its four-tuple, else the
+ * endpoint listening on its destination address and port, else the
+ * endpoint listening on any address; also after endpoints are
+ * deallocated or connected.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Looks a packet up, and checks that the endpoint of an exact
+   * four-tuple is found by SimpleLookup too.
+   * \param daddr destination address of the packet
+   * \param dport destination port of the packet
+   * \param saddr source address of the packet
+   * \param sport source port of the packet
+   * \param expected the endpoint expected, or 0 if none is
+   * \param msg the message of the failures
+   */
+  void CheckLookup (Ipv4Address daddr, uint16_t dport, Ipv4Address saddr, uint16_t sport,
+                    Ipv4EndPoint *expected, std::string msg);
+
+  Ipv4EndPointDemux *m_demux;       //!< The demux tested
+  Ptr<Ipv4Interface> m_interface;   //!< The incoming interface of the packets
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Check the endpoint found by Ipv4EndPointDemux"),
+    m_demux (0)
+{
+}
+
+void
+Ipv4EndPointDemuxTestCase::CheckLookup (Ipv4Address daddr, uint16_t dport,
+                                        Ipv4Address saddr, uint16_t sport,
+                                        Ipv4EndPoint *expected, std::string msg)
+{
+  Ipv4EndPointDemux::EndPoints endPoints = m_demux->Lookup (daddr, dport, saddr, sport, m_interface);
+  NS_TEST_ASSERT_MSG_EQ (endPoints.size (), (expected != 0 ? 1 : 0), msg << ": wrong number of endpoints");
+  if (expected != 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (endPoints.front (), expected, msg << ": wrong endpoint");
+    }
+  // SimpleLookup returns the least generic endpoint of the port otherwise
+  if (expected != 0 && expected->GetLocalAddress () == daddr
+      && expected->GetPeerAddress () == saddr && expected->GetPeerPort () == sport)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_demux->SimpleLookup (daddr, dport, saddr, sport), expected,
+                             msg << ": wrong endpoint of SimpleLookup");
+    }
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv4Address local ("10.1.1.1");
+  Ipv4Address other ("10.1.2.1");
+  Ipv4Address peer ("10.1.3.1");
+  m_interface = CreateObject<Ipv4Interface> ();
+  m_interface->AddAddress (Ipv4InterfaceAddress (local, Ipv4Mask ("255.255.255.0")));
+  m_demux = new Ipv4EndPointDemux ();
+
+  Ipv4EndPoint *wildcard = m_demux->Allocate (80);
+  Ipv4EndPoint *listening = m_demux->Allocate (local, 80);
+  Ipv4EndPoint *connected = m_demux->Allocate (local, 80, peer, 1000);
+  NS_TEST_ASSERT_MSG_NE (wildcard, 0, "Endpoint on any address not allocated");
+  NS_TEST_ASSERT_MSG_NE (listening, 0, "Endpoint on the local address not allocated");
+  NS_TEST_ASSERT_MSG_NE (connected, 0, "Connected endpoint not allocated");
+  NS_TEST_ASSERT_MSG_EQ (m_demux->Allocate (local, 80), 0, "Duplicate endpoint allocated");
+  NS_TEST_ASSERT_MSG_EQ (m_demux->Allocate (local, 80, peer, 1000), 0, "Duplicate four-tuple allocated");
+
+  // many connections on the same port, with the same peer address
+  std::vector<Ipv4EndPoint *> connections;
+  for (uint16_t port = 2000; port < 2100; port++)
+    {
+      connections.push_back (m_demux->Allocate (local, 80, peer, port));
+    }
+
+  CheckLookup (local, 80, peer, 1000, connected, "Exact four-tuple");
+  CheckLookup (local, 80, peer, 1001, listening, "Other peer port");
+  CheckLookup (local, 80, other, 1000, listening, "Other peer address");
+  CheckLookup (other, 80, peer, 1000, wildcard, "Other local address");
+  CheckLookup (local, 81, peer, 1000, 0, "Other local port");
+  for (uint16_t i = 0; i < connections.size (); i++)
+    {
+      CheckLookup (local, 80, peer, 2000 + i, connections[i], "Connection on the same port");
+    }
+
+  // the endpoints left are still found after DeAllocate
+  for (uint16_t i = 0; i < connections.size (); i += 2)
+    {
+      m_demux->DeAllocate (connections[i]);
+    }
+  for (uint16_t i = 0; i < connections.size (); i++)
+    {
+      CheckLookup (local, 80, peer, 2000 + i, (i % 2 != 0) ? connections[i] : listening,
+                   "Connection after DeAllocate");
+    }
+  m_demux->DeAllocate (connected);
+  CheckLookup (local, 80, peer, 1000, listening, "Four-tuple of a deallocated endpoint");
+  m_demux->DeAllocate (listening);
+  CheckLookup (local, 80, peer, 1000, wildcard, "Address of a deallocated endpoint");
+  CheckLookup (local, 80, peer, 2001, connections[1], "Connection after DeAllocate");
+  m_demux->DeAllocate (wildcard);
+  CheckLookup (local, 80, peer, 1000, 0, "Port of the deallocated endpoints");
+  NS_TEST_ASSERT_MSG_EQ (m_demux->LookupPortLocal (80), true, "Port of the connections not found");
+  for (uint16_t i = 1; i < connections.size (); i += 2)
+    {
+      m_demux->DeAllocate (connections[i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_demux->LookupPortLocal (80), false, "Port of the deallocated endpoints found");
+
+  // an endpoint is found by its four-tuple once connected
+  Ipv4EndPoint *client = m_demux->Allocate (local, 81);
+  CheckLookup (local, 81, peer, 1000, client, "Endpoint not connected yet");
+  client->SetPeer (peer, 1000);
+  CheckLookup (local, 81, peer, 1000, client, "Endpoint connected");
+  CheckLookup (local, 81, peer, 1001, 0, "Other peer port of a connected endpoint");
+
+  delete m_demux;
+  m_demux = 0;
+  m_interface = 0;
+}
+
+static class Ipv4EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  Ipv4EndPointDemuxTestSuite ()
+    : TestSuite ("ipv4-end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+  }
+
+} g_ipv4EndPointDemuxTestSuite;
+
+} // namespace ns3
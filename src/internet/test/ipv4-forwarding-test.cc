@@ -68,18 +68,20 @@ AddInternetStack (Ptr<Node> node)
 class Ipv4ForwardingTest : public TestCase
 {
   Ptr<Packet> m_receivedPacket;
+  bool m_routeCache;
   void DoSendData (Ptr<Socket> socket, std::string to);
   void SendData (Ptr<Socket> socket, std::string to);
 
 public:
   virtual void DoRun (void);
-  Ipv4ForwardingTest ();
+  Ipv4ForwardingTest (bool routeCache);
 
   void ReceivePkt (Ptr<Socket> socket);
 };
 
-Ipv4ForwardingTest::Ipv4ForwardingTest ()
-  : TestCase ("UDP socket implementation") 
+Ipv4ForwardingTest::Ipv4ForwardingTest (bool routeCache)
+  : TestCase (routeCache ? "UDP socket implementation with route cache" : "UDP socket implementation"),
+    m_routeCache (routeCache)
 {
 }
 
@@ -131,6 +133,7 @@ Ipv4ForwardingTest::DoRun (void)
   // Forwarding Node
   Ptr<Node> fwNode = CreateObject<Node> ();
   AddInternetStack (fwNode);
+  fwNode->GetObject<Ipv4L3Protocol> ()->SetAttribute ("RouteCache", BooleanValue (m_routeCache));
   Ptr<SimpleNetDevice> fwDev1, fwDev2;
   { // first interface
     fwDev1 = CreateObject<SimpleNetDevice> ();
@@ -199,6 +202,13 @@ Ipv4ForwardingTest::DoRun (void)
   m_receivedPacket->RemoveAllByteTags ();
   m_receivedPacket = 0;
 
+  // Second packet, forwarded with the cached route if any
+  SendData (txSocket, "10.0.0.2");
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->GetSize (), 123, "IPv4 Forwarding on");
+
+  m_receivedPacket->RemoveAllByteTags ();
+  m_receivedPacket = 0;
+
   Ptr<Ipv4> ipv4 = fwNode->GetObject<Ipv4> ();
   ipv4->SetAttribute("IpForward", BooleanValue (false));
   SendData (txSocket, "10.0.0.2");
@@ -216,6 +226,7 @@ class Ipv4ForwardingTestSuite : public TestSuite
 public:
   Ipv4ForwardingTestSuite () : TestSuite ("ipv4-forwarding", UNIT)
   {
-    AddTestCase (new Ipv4ForwardingTest, TestCase::QUICK);
+    AddTestCase (new Ipv4ForwardingTest (false), TestCase::QUICK);
+    AddTestCase (new Ipv4ForwardingTest (true), TestCase::QUICK);
   }
 } g_ipv4forwardingTestSuite;
@@ -21,6 +21,7 @@
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-global-routing.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/node.h"
 #include "ns3/node-container.h"
@@ -420,6 +421,94 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
 }
 
 
+class Ipv4GlobalRoutingLookupTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingLookupTestCase ();
+  virtual ~Ipv4GlobalRoutingLookupTestCase ();
+
+private:
+  Ipv4Address GetGateway (Ptr<Ipv4GlobalRouting> routing, std::string dest, Ptr<NetDevice> oif = 0);
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingLookupTestCase::Ipv4GlobalRoutingLookupTestCase ()
+  : TestCase ("Global routing lookup after routing table changes")
+{
+}
+
+Ipv4GlobalRoutingLookupTestCase::~Ipv4GlobalRoutingLookupTestCase ()
+{
+}
+
+// Returns the gateway of the route selected for dest, or 0.0.0.0 if none
+Ipv4Address
+Ipv4GlobalRoutingLookupTestCase::GetGateway (Ptr<Ipv4GlobalRouting> routing, std::string dest, Ptr<NetDevice> oif)
+{
+  Ipv4Header header;
+  header.SetDestination (Ipv4Address (dest.c_str ()));
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> route = routing->RouteOutput (0, header, oif, sockerr);
+  if (route == 0)
+    {
+      return Ipv4Address::GetAny ();
+    }
+  return route->GetGateway ();
+}
+
+// The routes matching a destination are cached, so every lookup below
+// follows a change of the routing table to check that the cache is
+// invalidated and that the routes keep the routing table order.
+void
+Ipv4GlobalRoutingLookupTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+
+  SimpleNetDeviceHelper devHelper;
+  NetDeviceContainer devices = devHelper.Install (NodeContainer (node, node));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (devices.Get (0));
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  ipv4.Assign (devices.Get (1));
+
+  Ptr<Ipv4GlobalRouting> routing = CreateObject<Ipv4GlobalRouting> ();
+  routing->SetIpv4 (node->GetObject<Ipv4> ());
+
+  NS_TEST_ASSERT_MSG_EQ (GetGateway (routing, "10.2.3.4"), Ipv4Address::GetAny (), "Route found in an empty routing table");
+
+  // Global routing uses the first matching network route, not the longest match
+  routing->AddNetworkRouteTo (Ipv4Address ("10.0.0.0"), Ipv4Mask ("/8"), Ipv4Address ("10.1.1.2"), 1);
+  routing->AddNetworkRouteTo (Ipv4Address ("10.2.0.0"), Ipv4Mask ("/16"), Ipv4Address ("10.1.2.2"), 2);
+  NS_TEST_ASSERT_MSG_EQ (GetGateway (routing, "10.2.3.4"), Ipv4Address ("10.1.1.2"), "Network routes not used in routing table order");
+  NS_TEST_ASSERT_MSG_EQ (GetGateway (routing, "10.2.3.4", devices.Get (1)), Ipv4Address ("10.1.2.2"), "Output device not honoured");
+  NS_TEST_ASSERT_MSG_EQ (GetGateway (routing, "10.3.0.1"), Ipv4Address ("10.1.1.2"), "Network route not found");
+
+  // Host routes take precedence over network routes
+  routing->AddHostRouteTo (Ipv4Address ("10.2.3.4"), Ipv4Address ("10.1.2.3"), 2);
+  NS_TEST_ASSERT_MSG_EQ (GetGateway (routing, "10.2.3.4"), Ipv4Address ("10.1.2.3"), "Host route not used");
+  NS_TEST_ASSERT_MSG_EQ (GetGateway (routing, "10.2.3.5"), Ipv4Address ("10.1.1.2"), "Host route used for another destination");
+
+  // Routing table is: host route, /8 network route, /16 network route
+  routing->RemoveRoute (0);
+  NS_TEST_ASSERT_MSG_EQ (GetGateway (routing, "10.2.3.4"), Ipv4Address ("10.1.1.2"), "Removed host route still used");
+  routing->RemoveRoute (0);
+  NS_TEST_ASSERT_MSG_EQ (GetGateway (routing, "10.2.3.4"), Ipv4Address ("10.1.2.2"), "Removed network route still used");
+  NS_TEST_ASSERT_MSG_EQ (GetGateway (routing, "10.3.0.1"), Ipv4Address::GetAny (), "Removed network route still used");
+
+  // External routes are used only when no host or network route matches
+  routing->AddASExternalRouteTo (Ipv4Address ("10.0.0.0"), Ipv4Mask ("/8"), Ipv4Address ("10.1.1.4"), 1);
+  NS_TEST_ASSERT_MSG_EQ (GetGateway (routing, "10.3.0.1"), Ipv4Address ("10.1.1.4"), "External route not found");
+  NS_TEST_ASSERT_MSG_EQ (GetGateway (routing, "10.2.3.4"), Ipv4Address ("10.1.2.2"), "External route used before a network route");
+  NS_TEST_ASSERT_MSG_EQ (routing->GetNRoutes (), 2, "Wrong number of routes");
+
+  routing->Dispose ();
+  Simulator::Destroy ();
+}
+
 class Ipv4GlobalRoutingTestSuite : public TestSuite
 {
 public:
@@ -431,6 +520,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
 {
   AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
   AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4GlobalRoutingLookupTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -256,11 +256,72 @@ Ipv4HeaderTest::DoRun (void)
   Simulator::Destroy ();
 }
 //-----------------------------------------------------------------------------
+class Ipv4HeaderChecksumTest : public TestCase
+{
+public:
+  virtual void DoRun (void);
+  Ipv4HeaderChecksumTest ();
+};
+
+Ipv4HeaderChecksumTest::Ipv4HeaderChecksumTest ()
+  : TestCase ("IPv4 Header incremental checksum Test")
+{
+}
+
+void
+Ipv4HeaderChecksumTest::DoRun (void)
+{
+  uint8_t protocols[] = { 0, 1, 6, 17, 0xff };
+  for (uint32_t i = 0; i < sizeof (protocols); i++)
+    {
+      Ipv4Header header;
+      header.EnableChecksum ();
+      header.SetSource (Ipv4Address ("10.1.2.3"));
+      header.SetDestination (Ipv4Address ("192.168.254.1"));
+      header.SetProtocol (protocols[i]);
+      header.SetPayloadSize (1460);
+      header.SetIdentification (0x1234 + i);
+      header.SetTtl (255);
+      Ptr<Packet> p = Create<Packet> (1460);
+      p->AddHeader (header);
+
+      // forward the packet until its TTL expires, as a router does
+      for (uint32_t ttl = 254; ttl > 0; ttl--)
+        {
+          Ipv4Header received;
+          received.EnableChecksum ();
+          p->RemoveHeader (received);
+          NS_TEST_ASSERT_MSG_EQ (received.IsChecksumOk (), true, "Bad checksum with TTL " << ttl + 1);
+          received.SetTtl (ttl);
+          p->AddHeader (received);
+
+          // the incrementally updated checksum matches a full computation
+          Ipv4Header full;
+          full.EnableChecksum ();
+          full.SetSource (received.GetSource ());
+          full.SetDestination (received.GetDestination ());
+          full.SetProtocol (received.GetProtocol ());
+          full.SetPayloadSize (received.GetPayloadSize ());
+          full.SetIdentification (received.GetIdentification ());
+          full.SetTtl (ttl);
+          Ptr<Packet> copy = Create<Packet> ();
+          copy->AddHeader (full);
+          uint8_t expected[20];
+          uint8_t actual[20];
+          copy->CopyData (expected, 20);
+          p->CopyData (actual, 20);
+          NS_TEST_ASSERT_MSG_EQ (actual[10], expected[10], "Bad checksum with TTL " << ttl);
+          NS_TEST_ASSERT_MSG_EQ (actual[11], expected[11], "Bad checksum with TTL " << ttl);
+        }
+    }
+}
+//-----------------------------------------------------------------------------
 class Ipv4HeaderTestSuite : public TestSuite
 {
 public:
   Ipv4HeaderTestSuite () : TestSuite ("ipv4-header", UNIT)
   {
     AddTestCase (new Ipv4HeaderTest, TestCase::QUICK);
+    AddTestCase (new Ipv4HeaderChecksumTest, TestCase::QUICK);
   }
 } g_ipv4HeaderTestSuite;
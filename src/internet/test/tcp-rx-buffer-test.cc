@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-rx-buffer.h"
+
+namespace ns3 {
+
+/**
+ * \brief Checks the reassembly of out of order and overlapping segments
+ * by TcpRxBuffer.
+ *
+ * With a virtual payload, only the sizes are checked, and the data
+ * extracted must be zero-filled.
+ */
+class TcpRxBufferTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param virtualPayload whether the buffer only keeps byte counts
+   */
+  TcpRxBufferTestCase (bool virtualPayload);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Adds a segment whose bytes are their sequence number modulo 251
+   * \param seq sequence number of the first byte
+   * \param size size of the segment
+   * \returns the value returned by TcpRxBuffer::Add
+   */
+  bool AddSegment (uint32_t seq, uint32_t size);
+
+  /**
+   * \brief Extracts data and checks its content
+   * \param maxSize maximum number of bytes to extract
+   * \param seq expected sequence number of the first byte extracted
+   * \param expectedSize expected number of bytes extracted
+   */
+  void CheckExtract (uint32_t maxSize, uint32_t seq, uint32_t expectedSize);
+
+  Ptr<TcpRxBuffer> m_buffer; //!< Buffer under test
+  bool m_virtualPayload;     //!< Whether the buffer only keeps byte counts
+};
+
+TcpRxBufferTestCase::TcpRxBufferTestCase (bool virtualPayload)
+  : TestCase (virtualPayload ? "Reassembly of byte counts in TcpRxBuffer"
+              : "Reassembly of data in TcpRxBuffer"),
+    m_virtualPayload (virtualPayload)
+{
+}
+
+bool
+TcpRxBufferTestCase::AddSegment (uint32_t seq, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      data[i] = (seq + i) % 251;
+    }
+  TcpHeader tcph;
+  tcph.SetSequenceNumber (SequenceNumber32 (seq));
+  return m_buffer->Add (Create<Packet> (&data[0], size), tcph);
+}
+
+void
+TcpRxBufferTestCase::CheckExtract (uint32_t maxSize, uint32_t seq, uint32_t expectedSize)
+{
+  Ptr<Packet> p = m_buffer->Extract (maxSize);
+  NS_TEST_ASSERT_MSG_NE (p, 0, "Nothing extracted at " << seq);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), expectedSize, "Wrong size extracted at " << seq);
+  std::vector<uint8_t> data (expectedSize + 1);
+  p->CopyData (&data[0], expectedSize);
+  for (uint32_t i = 0; i < expectedSize; ++i)
+    {
+      uint32_t expected = m_virtualPayload ? 0 : (seq + i) % 251;
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) data[i], expected, "Wrong byte " << i << " extracted at " << seq);
+    }
+}
+
+void
+TcpRxBufferTestCase::DoRun (void)
+{
+  m_buffer = CreateObject<TcpRxBuffer> (1000);
+  m_buffer->SetMaxBufferSize (10000);
+  m_buffer->SetVirtualPayload (m_virtualPayload);
+
+  // Out of order segments leave a hole at 1000
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (1500, 500), true, "Segment not buffered");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (2500, 500), true, "Segment not buffered");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (2000, 500), true, "Segment not buffered");
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Available (), 0, "Data available across a hole");
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Size (), 1500, "Wrong buffer size");
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Extract (1000), 0, "Data extracted across a hole");
+
+  // Duplicate and overlapping segments
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (1600, 300), false, "Duplicate segment buffered");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (2900, 300), true, "Overlapping segment not buffered");
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Size (), 1700, "Wrong buffer size");
+
+  // Filling the hole makes all the data available
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (1000, 600), true, "Segment not buffered");
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->NextRxSequence (), SequenceNumber32 (3200), "Wrong next sequence");
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Available (), 2200, "Wrong available size");
+
+  CheckExtract (700, 1000, 700);
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (3200, 100), true, "Segment not buffered");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (4000, 100), true, "Segment not buffered");
+  CheckExtract (5000, 1700, 1600);
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Size (), 100, "Wrong buffer size");
+
+  // A segment embedding buffered data replaces it
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (3300, 1000), true, "Segment not buffered");
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Available (), 1000, "Wrong available size");
+  CheckExtract (5000, 3300, 1000);
+
+  // FIN
+  m_buffer->SetFinSequence (SequenceNumber32 (4300));
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Finished (), true, "FIN not received");
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Size (), 0, "Wrong buffer size");
+  m_buffer = 0;
+}
+
+static class TcpRxBufferTestSuite : public TestSuite
+{
+public:
+  TcpRxBufferTestSuite ()
+    : TestSuite ("tcp-rx-buffer", UNIT)
+  {
+    AddTestCase (new TcpRxBufferTestCase (false), TestCase::QUICK);
+    AddTestCase (new TcpRxBufferTestCase (true), TestCase::QUICK);
+  }
+
+} g_tcpRxBufferTestSuite;
+
+} // namespace ns3
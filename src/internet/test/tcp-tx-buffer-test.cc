@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-tx-buffer.h"
+
+namespace ns3 {
+
+/**
+ * \brief Checks the bytes returned by TcpTxBuffer::CopyFromSequence while
+ * data is added and acknowledged.
+ *
+ * With a virtual payload, only the sizes are checked, and the segments
+ * must be zero-filled.
+ */
+class TcpTxBufferTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param virtualPayload whether the buffer only keeps byte counts
+   */
+  TcpTxBufferTestCase (bool virtualPayload);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Adds a packet whose bytes are their stream offset modulo 251
+   * \param size size of the packet
+   */
+  void AddPacket (uint32_t size);
+
+  /**
+   * \brief Checks the content of a segment copied from the buffer
+   * \param numBytes number of bytes requested
+   * \param seq sequence number of the first byte requested
+   * \param expectedSize expected size of the segment
+   */
+  void CheckSegment (uint32_t numBytes, uint32_t seq, uint32_t expectedSize);
+
+  Ptr<TcpTxBuffer> m_buffer; //!< Buffer under test
+  uint32_t m_written;         //!< Number of bytes written to the buffer
+  bool m_virtualPayload;      //!< Whether the buffer only keeps byte counts
+};
+
+TcpTxBufferTestCase::TcpTxBufferTestCase (bool virtualPayload)
+  : TestCase (virtualPayload ? "Copy and discard byte counts of TcpTxBuffer"
+              : "Copy and discard data of TcpTxBuffer"),
+    m_written (0),
+    m_virtualPayload (virtualPayload)
+{
+}
+
+void
+TcpTxBufferTestCase::AddPacket (uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      data[i] = (m_written + i) % 251;
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Add (Create<Packet> (&data[0], size)), true, "Packet not added");
+  m_written += size;
+}
+
+void
+TcpTxBufferTestCase::CheckSegment (uint32_t numBytes, uint32_t seq, uint32_t expectedSize)
+{
+  Ptr<Packet> p = m_buffer->CopyFromSequence (numBytes, SequenceNumber32 (seq));
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), expectedSize, "Wrong segment size at " << seq);
+  std::vector<uint8_t> data (expectedSize + 1);
+  p->CopyData (&data[0], expectedSize);
+  for (uint32_t i = 0; i < expectedSize; ++i)
+    {
+      uint32_t expected = m_virtualPayload ? 0 : (seq - 1000 + i) % 251;
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) data[i], expected, "Wrong byte " << i << " of segment at " << seq);
+    }
+}
+
+void
+TcpTxBufferTestCase::DoRun (void)
+{
+  m_buffer = CreateObject<TcpTxBuffer> (1000);
+  m_buffer->SetMaxBufferSize (4000);
+  m_buffer->SetVirtualPayload (m_virtualPayload);
+
+  // Packets of 512 bytes, as written by BulkSendApplication, and segments of 536 bytes
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      AddPacket (512);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Size (), 2560, "Wrong buffer size");
+  CheckSegment (536, 1000, 536);
+  CheckSegment (536, 1536, 536);
+  CheckSegment (2000, 1100, 2000);
+  CheckSegment (536, 3144, 416);
+  CheckSegment (536, 3560, 0);
+
+  // Acknowledge part of the second packet, then all of the third one
+  m_buffer->DiscardUpTo (SequenceNumber32 (1700));
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->HeadSequence (), SequenceNumber32 (1700), "Wrong head sequence");
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Size (), 1860, "Wrong buffer size");
+  CheckSegment (536, 1700, 536);
+  m_buffer->DiscardUpTo (SequenceNumber32 (2536));
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Size (), 1024, "Wrong buffer size");
+  CheckSegment (1024, 2536, 1024);
+
+  // Writes after acknowledgements
+  AddPacket (100);
+  AddPacket (1);
+  AddPacket (700);
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->TailSequence (), SequenceNumber32 (4361), "Wrong tail sequence");
+  CheckSegment (536, 3500, 536);
+  CheckSegment (3000, 2536, 1825);
+
+  // Acknowledge everything, then the FIN
+  m_buffer->DiscardUpTo (SequenceNumber32 (4361));
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Size (), 0, "Wrong buffer size");
+  m_buffer->DiscardUpTo (SequenceNumber32 (4362));
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->HeadSequence (), SequenceNumber32 (4362), "FIN not acknowledged");
+  m_buffer = 0;
+}
+
+static class TcpTxBufferTestSuite : public TestSuite
+{
+public:
+  TcpTxBufferTestSuite ()
+    : TestSuite ("tcp-tx-buffer", UNIT)
+  {
+    AddTestCase (new TcpTxBufferTestCase (false), TestCase::QUICK);
+    AddTestCase (new TcpTxBufferTestCase (true), TestCase::QUICK);
+  }
+
+} g_tcpTxBufferTestSuite;
+
+} // namespace ns3
@@ -18,8 +18,10 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "buffer.h"
+#include "packet-allocator.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include <algorithm>
 
 #define LOG_INTERNAL_STATE(y)                                                                    \
   NS_LOG_LOGIC (y << "start="<<m_start<<", end="<<m_end<<", zero start="<<m_zeroAreaStart<<              \
@@ -50,97 +52,34 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
-uint32_t Buffer::g_recommendedStart = 0;
+__thread uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
-/* The following macros are pretty evil but they are needed to allow us to
- * keep track of 3 possible states for the g_freeList variable:
- *  - uninitialized means that no one has created a buffer yet
- *    so no one has created the associated free list (it is created
- *    on-demand when the first buffer is created)
- *  - initialized means that the free list exists and is valid
- *  - destroyed means that the static destructors of this compilation unit
- *    have run so, the free list has been cleared from its content
- * The key is that in destroyed state, we are careful not re-create it
- * which is a typical weakness of lazy evaluation schemes which use 
- * '0' as a special value to indicate both un-initialized and destroyed.
- * Note that it is important to use '0' as the marker for un-initialized state
- * because the variable holding this state information is initialized to zero
- * which the compiler assigns to zero-memory which is initialized to _zero_
- * before the constructors run so this ensures perfect handling of crazy 
- * constructor orderings.
- */
-#define MAGIC_DESTROYED (~(long) 0)
-#define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
-#define IS_DESTROYED(x) (x == (Buffer::FreeList*)MAGIC_DESTROYED)
-#define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
-#define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
-#define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
-
-Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
-{
-  NS_LOG_FUNCTION (this);
-  if (IS_INITIALIZED (g_freeList))
-    {
-      for (Buffer::FreeList::iterator i = g_freeList->begin ();
-           i != g_freeList->end (); i++)
-        {
-          Buffer::Deallocate (*i);
-        }
-      delete g_freeList;
-      g_freeList = DESTROYED;
-    }
-}
+// The maximum size is per thread, since MultithreadedSimulatorImpl
+// creates packets from several threads.
+__thread uint32_t Buffer::g_maxSize = 0;
 
 void
 Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
-  g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
-  if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
-      g_freeList->size () > 1000)
-    {
-      Buffer::Deallocate (data);
-    }
-  else
+  // do not learn the sizes larger than the size classes, which would
+  // take all the new buffers out of the PacketAllocator free lists
+  if (data->m_size - 1 + sizeof (struct Buffer::Data) <= PacketAllocator::MAX_BLOCK_SIZE)
     {
-      NS_ASSERT (IS_INITIALIZED (g_freeList));
-      g_freeList->push_back (data);
+      g_maxSize = std::max (g_maxSize, data->m_size);
     }
+  Buffer::Deallocate (data);
 }
 
 Buffer::Data *
 Buffer::Create (uint32_t dataSize)
 {
   NS_LOG_FUNCTION (dataSize);
-  /* try to find a buffer correctly sized. */
-  if (IS_UNINITIALIZED (g_freeList))
-    {
-      g_freeList = new Buffer::FreeList ();
-    }
-  else if (IS_INITIALIZED (g_freeList))
-    {
-      while (!g_freeList->empty ()) 
-        {
-          struct Buffer::Data *data = g_freeList->back ();
-          g_freeList->pop_back ();
-          if (data->m_size >= dataSize) 
-            {
-              data->m_count = 1;
-              return data;
-            }
-          Buffer::Deallocate (data);
-        }
-    }
-  struct Buffer::Data *data = Buffer::Allocate (dataSize);
-  NS_ASSERT (data->m_count == 1);
-  return data;
+  /* new buffers are created with the maximum size ever used, to
+   * minimize the number of resizes, and the PacketAllocator free
+   * lists make recycling a buffer of any size cheap. */
+  return Buffer::Allocate (std::max (dataSize, g_maxSize));
 }
 #else /* BUFFER_FREE_LIST */
 void
@@ -168,10 +107,11 @@ Buffer::Allocate (uint32_t reqSize)
       reqSize = 1;
     }
   NS_ASSERT (reqSize >= 1);
-  uint32_t size = reqSize - 1 + sizeof (struct Buffer::Data);
-  uint8_t *b = new uint8_t [size];
+  uint32_t size = PacketAllocator::GetBlockSize (reqSize - 1 + sizeof (struct Buffer::Data));
+  uint8_t *b = static_cast<uint8_t *> (PacketAllocator::Allocate (size));
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
-  data->m_size = reqSize;
+  // use the whole block, which is rounded up to its size class
+  data->m_size = size + 1 - sizeof (struct Buffer::Data);
   data->m_count = 1;
   return data;
 }
@@ -181,8 +121,7 @@ Buffer::Deallocate (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  uint8_t *buf = reinterpret_cast<uint8_t *> (data);
-  delete [] buf;
+  PacketAllocator::Deallocate (data, data->m_size - 1 + sizeof (struct Buffer::Data));
 }
 
 Buffer::Buffer ()
@@ -1140,18 +1079,76 @@ uint16_t
 Buffer::Iterator::CalculateIpChecksum (uint16_t size, uint32_t initialChecksum)
 {
   NS_LOG_FUNCTION (this << size << initialChecksum);
-  /* see RFC 1071 to understand this code. */
-  uint32_t sum = initialChecksum;
+  /* see RFC 1071 to understand this code. The 16-bit words are read
+   * in little endian order, like ReadU16 does. The zero area adds
+   * nothing to the sum, so only the bytes before and after it are
+   * summed, the bytes after it being swapped if the zero area has an
+   * odd size.
+   */
+  NS_ASSERT_MSG (m_current + size <= m_dataEnd, GetReadErrorMessage ());
+  uint32_t start = m_current;
+  uint32_t end = m_current + size;
+  uint64_t sum = initialChecksum;
+
+  if (start < m_zeroStart)
+    {
+      sum += SumWords (&m_data[start], std::min (end, m_zeroStart) - start);
+    }
+  if (end > m_zeroEnd)
+    {
+      uint32_t segment = std::max (start, m_zeroEnd);
+      uint16_t segmentSum = SumWords (&m_data[segment - (m_zeroEnd - m_zeroStart)],
+                                      end - segment);
+      if ((segment - start) & 1)
+        {
+          segmentSum = (segmentSum << 8) | (segmentSum >> 8);
+        }
+      sum += segmentSum;
+    }
+  m_current = end;
 
-  for (int j = 0; j < size/2; j++)
-    sum += ReadU16 ();
+  while (sum >> 16)
+    sum = (sum & 0xffff) + (sum >> 16);
+  return ~sum;
+}
 
-  if (size & 1)
-    sum += ReadU8 ();
+uint16_t
+Buffer::Iterator::SumWords (const uint8_t *data, uint32_t size)
+{
+  NS_LOG_FUNCTION (data << size);
+  // The bytes are summed 8 at a time in native order, with the carries
+  // added back, which folds to the same one's complement sum as the
+  // 16-bit words, byte swapped on big endian hosts.
+  uint64_t sum = 0;
+  uint32_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      uint64_t word;
+      std::memcpy (&word, data + i, 8);
+      sum += word;
+      sum += (sum < word);
+    }
+  uint64_t tail = 0;
+  std::memcpy (&tail, data + i, (size - i) & ~1U);
+  sum += tail;
+  sum += (sum < tail);
 
+  sum = (sum & 0xffffffff) + (sum >> 32);
   while (sum >> 16)
     sum = (sum & 0xffff) + (sum >> 16);
-  return ~sum;
+  uint16_t result = sum;
+  const uint16_t one = 1;
+  if (*reinterpret_cast<const uint8_t *> (&one) == 0)
+    {
+      result = (result << 8) | (result >> 8);
+    }
+
+  if (size & 1)
+    {
+      sum = result + data[size - 1];
+      result = (sum & 0xffff) + (sum >> 16);
+    }
+  return result;
 }
 
 uint32_t 
@@ -40,7 +40,8 @@ namespace ns3 {
  * to ensure that the number of buffer resizes is minimized,
  * by creating new Buffers of the maximum size ever used.
  * The correct maximum size is learned at runtime during use by 
- * recording the maximum size of each packet.
+ * recording the maximum size of each packet. The memory of the
+ * buffers comes from the size classes of the PacketAllocator.
  *
  * \internal
  * The implementation of the Buffer class uses a COW (Copy On Write)
@@ -397,6 +398,15 @@ private:
      * \param buffer the buffer this iterator refers to
      */
     inline void Construct (const Buffer *buffer);
+    /**
+     * \brief Calculate the one's complement sum of contiguous bytes.
+     *
+     * \param data the bytes.
+     * \param size the number of bytes.
+     * \return the sum of the 16-bit words read in little endian order,
+     *         the last byte of an odd size being a low order byte.
+     */
+    static uint16_t SumWords (const uint8_t *data, uint32_t size);
     /**
      * Checks that the [start, end) is not in the "virtual zero area".
      *
@@ -761,7 +771,7 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
-  static uint32_t g_recommendedStart;
+  static __thread uint32_t g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -785,16 +795,7 @@ private:
   uint32_t m_end;
 
 #ifdef BUFFER_FREE_LIST
-  /// Container for buffer data
-  typedef std::vector<struct Buffer::Data*> FreeList;
-  /// Local static destructor structure
-  struct LocalStaticDestructor 
-  {
-    ~LocalStaticDestructor ();
-  };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+  static __thread uint32_t g_maxSize; //!< Max observed data size of the current thread
 #endif
 };
 
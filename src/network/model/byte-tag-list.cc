@@ -52,12 +52,35 @@ struct ByteTagListData {
  *
  * Internal use only.
  */
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
+class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
 {
 public:
   ~ByteTagListDataFreeList ();
-} g_freeList; //!< Container for struct ByteTagListData
-static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+};
+
+/**
+ * Container for struct ByteTagListData of the current thread, created
+ * on demand. Each thread has its own, since MultithreadedSimulatorImpl
+ * creates packets from several threads.
+ */
+static __thread ByteTagListDataFreeList *g_freeList = 0;
+static __thread uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+
+/**
+ * \ingroup packet
+ *
+ * \brief Delete the free list of the main thread at exit.
+ *
+ * Internal use only.
+ */
+static struct ByteTagListDataFreeListDestructor
+{
+  ~ByteTagListDataFreeListDestructor ()
+  {
+    delete g_freeList;
+    g_freeList = 0;
+  }
+} g_freeListDestructor; //!< Deletes the free list of the main thread
 
 ByteTagListDataFreeList::~ByteTagListDataFreeList ()
 {
@@ -158,6 +181,10 @@ ByteTagList::ByteTagList (const ByteTagList &o)
     {
       m_data->count++;
     }
+  else
+    {
+      std::memcpy (m_inline, o.m_inline, m_used);
+    }
 }
 ByteTagList &
 ByteTagList::operator = (const ByteTagList &o)
@@ -177,6 +204,10 @@ ByteTagList::operator = (const ByteTagList &o)
     {
       m_data->count++;
     }
+  else
+    {
+      std::memcpy (m_inline, o.m_inline, m_used);
+    }
   return *this;
 }
 ByteTagList::~ByteTagList ()
@@ -193,10 +224,17 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
   NS_LOG_FUNCTION (this << tid << bufferSize << start << end);
   uint32_t spaceNeeded = m_used + bufferSize + 4 + 4 + 4 + 4;
   NS_ASSERT (m_used <= spaceNeeded);
-  if (m_data == 0)
+  uint8_t *buffer;
+  if (m_data == 0 && spaceNeeded <= INLINE_SIZE)
     {
+      buffer = m_inline;
+    }
+  else if (m_data == 0)
+    {
+      // the inline buffer overflows
       m_data = Allocate (spaceNeeded);
-      m_used = 0;
+      std::memcpy (&m_data->data, m_inline, m_used);
+      buffer = m_data->data;
     } 
   else if (m_data->size < spaceNeeded ||
            (m_data->count != 1 && m_data->dirty != m_used))
@@ -205,9 +243,14 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
       std::memcpy (&newData->data, &m_data->data, m_used);
       Deallocate (m_data);
       m_data = newData;
+      buffer = m_data->data;
+    }
+  else
+    {
+      buffer = m_data->data;
     }
-  TagBuffer tag = TagBuffer (&m_data->data[m_used], 
-                             &m_data->data[spaceNeeded]);
+  TagBuffer tag = TagBuffer (&buffer[m_used], 
+                             &buffer[spaceNeeded]);
   tag.WriteU32 (tid.GetUid ());
   tag.WriteU32 (bufferSize);
   tag.WriteU32 (start - m_adjustment);
@@ -221,7 +264,10 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
       m_maxEnd = end - m_adjustment;
     }
   m_used = spaceNeeded;
-  m_data->dirty = m_used;
+  if (m_data != 0)
+    {
+      m_data->dirty = m_used;
+    }
   return tag;
 }
 
@@ -263,13 +309,14 @@ ByteTagList::Iterator
 ByteTagList::Begin (int32_t offsetStart, int32_t offsetEnd) const
 {
   NS_LOG_FUNCTION (this << offsetStart << offsetEnd);
-  if (m_data == 0)
+  if (m_used == 0)
     {
       return Iterator (0, 0, offsetStart, offsetEnd, 0);
     }
   else
     {
-      return Iterator (m_data->data, &m_data->data[m_used], offsetStart, offsetEnd, m_adjustment);
+      uint8_t *buffer = m_data != 0 ? m_data->data : const_cast<uint8_t *> (m_inline);
+      return Iterator (buffer, &buffer[m_used], offsetStart, offsetEnd, m_adjustment);
     }
 }
 
@@ -344,10 +391,14 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  while (!g_freeList.empty ())
+  if (g_freeList == 0)
+    {
+      g_freeList = new ByteTagListDataFreeList ();
+    }
+  while (!g_freeList->empty ())
     {
-      struct ByteTagListData *data = g_freeList.back ();
-      g_freeList.pop_back ();
+      struct ByteTagListData *data = g_freeList->back ();
+      g_freeList->pop_back ();
       NS_ASSERT (data != 0);
       if (data->size >= size)
         {
@@ -378,7 +429,8 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
   data->count--;
   if (data->count == 0)
     {
-      if (g_freeList.size () > FREE_LIST_SIZE ||
+      if (g_freeList == 0 ||
+          g_freeList->size () > FREE_LIST_SIZE ||
           data->size < g_maxSize)
         {
           uint8_t *buffer = (uint8_t *)data;
@@ -386,7 +438,7 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
         }
       else
         {
-          g_freeList.push_back (data);
+          g_freeList->push_back (data);
         }
     }
 }
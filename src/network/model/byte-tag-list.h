@@ -45,7 +45,11 @@ struct ByteTagListData;
  *     as 4 32bit integers (TypeId, tag data size, start, end) followed 
  *     by the tag data as generated by Tag::Serialize.
  *
- *   - The struct ByteTagListData structure which contains the tag byte buffer
+ *   - The first INLINE_SIZE bytes of tags are stored in the ByteTagList
+ *     itself, and copied with it, so that adding a few small tags to a
+ *     packet needs no heap allocation.
+ *   - Once the tags overflow the inline buffer, they move to a
+ *     struct ByteTagListData structure which contains the tag byte buffer,
  *     is shared and, thus, reference-counted. This data structure is unshared
  *     as-needed to emulate COW semantics.
  *
@@ -226,6 +230,12 @@ private:
   void AddAtStart (int32_t prependOffset);
 
 private:
+  /** Size of the inline tag buffer, in bytes. */
+  enum
+  {
+    INLINE_SIZE = 64
+  };
+
   /**
    * \brief Returns an iterator pointing to the very first tag in this list.
    *
@@ -250,7 +260,8 @@ private:
   int32_t m_maxEnd; // !< maximal end offset
   int32_t m_adjustment; // !< adjustment to byte tag offsets
   uint16_t m_used; //!< the number of used bytes in the buffer
-  struct ByteTagListData *m_data; //!< the ByteTagListData structure
+  struct ByteTagListData *m_data; //!< the ByteTagListData structure, or 0 for the inline buffer
+  uint8_t m_inline[INLINE_SIZE]; //!< the inline tag buffer
 };
 
 void
@@ -0,0 +1,668 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+#include "channel.h"
+#include "channel-list.h"
+#include "net-device.h"
+#include "node.h"
+#include "node-list.h"
+#include "packet-allocator.h"
+
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/uinteger.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Implementation of class ns3::MultithreadedSimulatorImpl.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/** Timestamp of the events which never happen. */
+const uint64_t INFINITE_TS = ~(uint64_t) 0;
+
+/** The partition run by the current thread, 0 out of Simulator::Run. */
+__thread void *g_currentPartition = 0;
+
+} // anonymous namespace
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Network")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("ThreadCount",
+                   "Number of threads, each one running the nodes whose "
+                   "system id modulo this number is the thread index",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_threadCount),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  // uids are allocated from 4, as in DefaultSimulatorImpl
+  m_uid = 4;
+  m_currentUid = 0;
+  m_currentTs = 0;
+  m_stop = false;
+  m_stopTs = INFINITE_TS;
+  m_lookahead = INFINITE_TS;
+  m_windowEnd = 0;
+  m_done = false;
+  m_exit = false;
+  m_threadCount = 1;
+  m_barrierCount = 0;
+  m_barrierGeneration = 0;
+  pthread_mutex_init (&m_barrierMutex, 0);
+  pthread_cond_init (&m_barrierCond, 0);
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  pthread_mutex_destroy (&m_barrierMutex);
+  pthread_cond_destroy (&m_barrierCond);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_threads.empty ())
+    {
+      m_exit = true;
+      Synchronize (false);
+      for (uint32_t i = 0; i < m_threads.size (); ++i)
+        {
+          m_threads[i]->Join ();
+        }
+      m_threads.clear ();
+    }
+
+  // Between runs, all the events are in m_events
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      next.impl->Unref ();
+    }
+  m_events = 0;
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      delete m_partitions[i];
+    }
+  m_partitions.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ASSERT_MSG (GetCurrentPartition () == 0, "Cannot change the scheduler while the simulation runs");
+  m_schedulerFactory = schedulerFactory;
+  Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+
+  if (m_events != 0)
+    {
+      while (!m_events->IsEmpty ())
+        {
+          Scheduler::Event next = m_events->RemoveNext ();
+          scheduler->Insert (next);
+        }
+    }
+  m_events = scheduler;
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      m_partitions[i]->m_events = schedulerFactory.Create<Scheduler> ();
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  // Packet uids are made unique across threads by the system id
+  Partition *partition = GetCurrentPartition ();
+  return (partition == 0) ? 0 : partition->m_index;
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetCurrentPartition (void)
+{
+  return static_cast<Partition *> (g_currentPartition);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionIndex (uint32_t context) const
+{
+  return (context < m_nodePartition.size ()) ? m_nodePartition[context] : 0;
+}
+
+EventId
+MultithreadedSimulatorImpl::Insert (Partition *partition, uint64_t ts, uint32_t context, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  if (partition == 0)
+    {
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_events->Insert (ev);
+    }
+  else
+    {
+      // Partitions allocate uids in distinct residue classes, so the
+      // uids are unique across partitions.
+      ev.key.m_uid = partition->m_uid;
+      partition->m_uid += m_partitions.size ();
+      partition->m_events->Insert (ev);
+    }
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::CreatePartitions (void)
+{
+  NS_LOG_FUNCTION (this << m_threadCount);
+  for (uint32_t i = 0; i < m_threadCount; ++i)
+    {
+      Partition *partition = new Partition;
+      partition->m_index = i;
+      partition->m_events = m_schedulerFactory.Create<Scheduler> ();
+      partition->m_uid = 0;
+      partition->m_currentUid = 0;
+      partition->m_currentTs = 0;
+      partition->m_currentContext = 0xffffffff;
+      partition->m_nextTs = INFINITE_TS;
+      partition->m_inbox.resize (m_threadCount);
+      m_partitions.push_back (partition);
+    }
+  // The thread calling Run runs the first partition
+  for (uint32_t i = 1; i < m_threadCount; ++i)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&MultithreadedSimulatorImpl::RunThread, this).Bind (i));
+      thread->Start ();
+      m_threads.push_back (thread);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DistributePendingEvents (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_nodePartition.resize (NodeList::GetNNodes ());
+  for (uint32_t i = 0; i < m_nodePartition.size (); ++i)
+    {
+      m_nodePartition[i] = NodeList::GetNode (i)->GetSystemId () % m_partitions.size ();
+    }
+
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      Partition *partition = m_partitions[i];
+      partition->m_uid = m_uid + i;
+      partition->m_currentTs = m_currentTs;
+      partition->m_currentUid = m_currentUid;
+    }
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      m_partitions[GetPartitionIndex (next.key.m_context)]->m_events->Insert (next);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ComputeLookahead (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_lookahead = INFINITE_TS;
+  for (ChannelList::Iterator i = ChannelList::Begin (); i != ChannelList::End (); ++i)
+    {
+      Ptr<Channel> channel = *i;
+      bool crossing = false;
+      for (uint32_t j = 1; j < channel->GetNDevices (); ++j)
+        {
+          crossing |= GetPartitionIndex (channel->GetDevice (j)->GetNode ()->GetId ())
+            != GetPartitionIndex (channel->GetDevice (0)->GetNode ()->GetId ());
+        }
+      if (!crossing)
+        {
+          continue;
+        }
+      TimeValue delay;
+      if (!channel->GetAttributeFailSafe ("Delay", delay))
+        {
+          NS_FATAL_ERROR ("Channel " << channel->GetInstanceTypeId ().GetName ()
+                          << " crosses threads but has no Delay attribute");
+        }
+      NS_ABORT_MSG_UNLESS (delay.Get ().IsStrictlyPositive (), "Channel crossing threads without delay");
+      m_lookahead = std::min (m_lookahead, (uint64_t) delay.Get ().GetTimeStep ());
+    }
+  NS_LOG_LOGIC ("lookahead " << m_lookahead);
+}
+
+void
+MultithreadedSimulatorImpl::Synchronize (bool computeWindow)
+{
+  pthread_mutex_lock (&m_barrierMutex);
+  uint32_t generation = m_barrierGeneration;
+  m_barrierCount++;
+  if (m_barrierCount == m_partitions.size ())
+    {
+      // The last thread to arrive computes the window for all of them
+      if (computeWindow)
+        {
+          ComputeWindow ();
+        }
+      m_barrierCount = 0;
+      m_barrierGeneration++;
+      pthread_cond_broadcast (&m_barrierCond);
+    }
+  else
+    {
+      while (generation == m_barrierGeneration)
+        {
+          pthread_cond_wait (&m_barrierCond, &m_barrierMutex);
+        }
+    }
+  pthread_mutex_unlock (&m_barrierMutex);
+}
+
+void
+MultithreadedSimulatorImpl::ComputeWindow (void)
+{
+  uint64_t nextTs = INFINITE_TS;
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      nextTs = std::min (nextTs, m_partitions[i]->m_nextTs);
+    }
+  CriticalSection cs (m_mutex);
+  if (m_stop || nextTs == INFINITE_TS || nextTs >= m_stopTs)
+    {
+      m_done = true;
+      return;
+    }
+  m_windowEnd = (m_lookahead > m_stopTs - nextTs) ? m_stopTs : nextTs + m_lookahead;
+}
+
+void
+MultithreadedSimulatorImpl::RunThread (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  while (true)
+    {
+      // Wait for Run to be called, or for the simulator to be disposed of
+      Synchronize (false);
+      if (m_exit)
+        {
+          PacketAllocator::Release ();
+          return;
+        }
+      RunPartition (index);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (uint32_t index)
+{
+  Partition *partition = m_partitions[index];
+  g_currentPartition = partition;
+  while (true)
+    {
+      // Receive the events of the other partitions, in a deterministic order
+      for (uint32_t i = 0; i < partition->m_inbox.size (); ++i)
+        {
+          Outbox &inbox = partition->m_inbox[i];
+          for (Outbox::iterator j = inbox.begin (); j != inbox.end (); ++j)
+            {
+              j->key.m_uid = partition->m_uid;
+              partition->m_uid += m_partitions.size ();
+              partition->m_events->Insert (*j);
+            }
+          inbox.clear ();
+        }
+      partition->m_nextTs = partition->m_events->IsEmpty () ? INFINITE_TS : partition->m_events->PeekNext ().key.m_ts;
+
+      Synchronize (true);
+      if (m_done)
+        {
+          break;
+        }
+      while (!partition->m_events->IsEmpty ()
+             && partition->m_events->PeekNext ().key.m_ts < m_windowEnd)
+        {
+          ProcessOneEvent (partition);
+        }
+      // Wait for the events sent to this partition during the window
+      Synchronize (false);
+    }
+  g_currentPartition = 0;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (Partition *partition)
+{
+  Scheduler::Event next = partition->m_events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= partition->m_currentTs);
+  partition->m_currentTs = next.key.m_ts;
+  partition->m_currentContext = next.key.m_context;
+  partition->m_currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0)
+    {
+      return partition->m_events->IsEmpty () || m_stop;
+    }
+  return m_events->IsEmpty () || m_stop;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (GetCurrentPartition () == 0, "Simulator::Run called while the simulation runs");
+  if (m_partitions.empty ())
+    {
+      CreatePartitions ();
+    }
+  NS_ASSERT_MSG (m_partitions.size () == m_threadCount, "Cannot change ThreadCount after Simulator::Run");
+  DistributePendingEvents ();
+  ComputeLookahead ();
+  m_stop = false;
+  m_done = false;
+
+  // Start the other threads, and run the first partition
+  Synchronize (false);
+  RunPartition (0);
+
+  // All the threads are waiting for the next run: move the events left
+  // back to m_events, and set the time to the latest event.
+  uint32_t uid = m_uid;
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      Partition *partition = m_partitions[i];
+      while (!partition->m_events->IsEmpty ())
+        {
+          m_events->Insert (partition->m_events->RemoveNext ());
+        }
+      m_currentTs = std::max (m_currentTs, partition->m_currentTs);
+      uid = std::max (uid, partition->m_uid);
+    }
+  m_uid = uid;
+  m_currentUid = uid - 1;
+  if (!m_stop && m_stopTs != INFINITE_TS
+      && (m_events->IsEmpty () || m_events->PeekNext ().key.m_ts >= m_stopTs))
+    {
+      // Stopped at the stop time, before the events of that time
+      m_currentTs = std::max (m_currentTs, m_stopTs);
+      m_currentUid = 0;
+      m_stopTs = INFINITE_TS;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  uint64_t ts = (uint64_t) (Now () + delay).GetTimeStep ();
+  CriticalSection cs (m_mutex);
+  m_stopTs = std::min (m_stopTs, ts);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  Time tAbsolute = delay + Now ();
+  NS_ASSERT (tAbsolute.IsPositive ());
+  return Insert (GetCurrentPartition (), tAbsolute.GetTimeStep (), GetContext (), event);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  Partition *partition = GetCurrentPartition ();
+  uint64_t ts = (uint64_t) (delay + Now ()).GetTimeStep ();
+  uint32_t index = GetPartitionIndex (context);
+  if (partition == 0 || partition->m_index == index)
+    {
+      Insert (partition, ts, context, event);
+      return;
+    }
+  if (ts < m_windowEnd)
+    {
+      NS_FATAL_ERROR ("Event scheduled for node " << context << " within the lookahead: "
+                      << ts << " < " << m_windowEnd);
+    }
+  // The uid is allocated by the destination partition
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = 0;
+  m_partitions[index]->m_inbox[partition->m_index].push_back (ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Insert (GetCurrentPartition (), Now ().GetTimeStep (), GetContext (), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), Now ().GetTimeStep (), 0xffffffff, 2);
+  CriticalSection cs (m_mutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  Partition *partition = GetCurrentPartition ();
+  return TimeStep ((partition == 0) ? m_currentTs : partition->m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs ()) - Now ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_mutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition *partition = GetCurrentPartition ();
+  NS_ASSERT_MSG (partition == 0 || partition->m_index == GetPartitionIndex (id.GetContext ()),
+                 "Cannot remove an event of another thread");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  if (partition == 0)
+    {
+      m_events->Remove (event);
+    }
+  else
+    {
+      partition->m_events->Remove (event);
+    }
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_mutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  if (id.PeekEventImpl () == 0)
+    {
+      return true;
+    }
+  // Compare with the current event of the partition, which is the only
+  // one this thread can read while the other threads run
+  uint64_t currentTs = m_currentTs;
+  uint32_t currentUid = m_currentUid;
+  const Partition *partition = GetCurrentPartition ();
+  if (partition != 0)
+    {
+      NS_ASSERT_MSG (partition->m_index == GetPartitionIndex (id.GetContext ()),
+                     "Cannot check an event of another thread");
+      currentTs = partition->m_currentTs;
+      currentUid = partition->m_currentUid;
+    }
+  if (id.GetTs () < currentTs ||
+      (id.GetTs () == currentTs &&
+       id.GetUid () <= currentUid) ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  Partition *partition = GetCurrentPartition ();
+  return (partition == 0) ? 0xffffffff : partition->m_currentContext;
+}
+
+} // namespace ns3
@@ -0,0 +1,236 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/ptr.h"
+
+#include <list>
+#include <vector>
+#include <pthread.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::MultithreadedSimulatorImpl.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief A conservative parallel simulator running the nodes of a
+ * single process on a pool of threads.
+ *
+ * The nodes are split into partitions by their system id, as assigned
+ * for distributed simulations: the node with system id \c s belongs to
+ * the partition <tt>s % ThreadCount</tt>. Each partition has its own
+ * event queue and is run by its own thread; the thread calling
+ * Simulator::Run runs the first partition. Events without a node
+ * context belong to the first partition.
+ *
+ * The partitions are synchronized by time windows. The lookahead is the
+ * smallest "Delay" attribute of the channels connecting nodes of
+ * different partitions, computed when Simulator::Run is called. Each
+ * window starts at the earliest pending event of all the partitions and
+ * lasts for the lookahead, so the events of a window can only schedule
+ * events of the other partitions in later windows. Events scheduled for
+ * another partition are buffered per pair of partitions, and inserted
+ * into the destination queue between windows, in the order of the source
+ * partitions, which keeps the simulation deterministic.
+ *
+ * Channels crossing partitions must use Simulator::ScheduleWithContext
+ * with a delay of at least their "Delay" attribute, and must not share
+ * objects between the two sides: see PointToPointChannel, which copies
+ * the packets it delivers to another partition. A model scheduling an
+ * event for another partition within the lookahead aborts the
+ * simulation. While the partitions run, an EventId can only be checked,
+ * cancelled or removed by the partition of its event.
+ *
+ * Simulator::Stop (void) takes effect at the end of the current window,
+ * and Simulator::Stop (const Time &) stops the simulation before the
+ * events scheduled at the stop time. Packet metadata (Packet::EnablePrinting)
+ * is not supported.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &delay);
+  virtual EventId Schedule (Time const &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** Container of the events scheduled by a partition for another one. */
+  typedef std::vector<Scheduler::Event> Outbox;
+
+  /** The state of a partition of the nodes. */
+  struct Partition
+  {
+    uint32_t m_index;              //!< Index of the partition
+    Ptr<Scheduler> m_events;       //!< The event priority queue
+    uint32_t m_uid;                //!< Next event unique id
+    uint32_t m_currentUid;         //!< Unique id of the current event
+    uint64_t m_currentTs;          //!< Timestamp of the current event
+    uint32_t m_currentContext;     //!< Execution context of the current event
+    uint64_t m_nextTs;             //!< Timestamp of the earliest event, between windows
+    std::vector<Outbox> m_inbox;   //!< Events scheduled by each partition for this one
+  };
+
+  /**
+   * Get the partition of the nodes running the current event.
+   * \returns The partition, or 0 when the simulation is not running.
+   */
+  static Partition *GetCurrentPartition (void);
+
+  /**
+   * Get the index of the partition of a context.
+   * \param [in] context The context.
+   * \returns The index of the partition.
+   */
+  uint32_t GetPartitionIndex (uint32_t context) const;
+
+  /**
+   * Insert an event into the queue of a partition.
+   * \param [in] partition The partition.
+   * \param [in] ts The timestamp of the event.
+   * \param [in] context The context of the event.
+   * \param [in] event The event.
+   * \returns The id of the event.
+   */
+  EventId Insert (Partition *partition, uint64_t ts, uint32_t context, EventImpl *event);
+
+  /** Create the partitions and the threads, at the first call to Run. */
+  void CreatePartitions (void);
+  /** Move the events scheduled out of Run into the queues of the partitions. */
+  void DistributePendingEvents (void);
+  /** Compute the lookahead from the channels crossing partitions. */
+  void ComputeLookahead (void);
+
+  /**
+   * Body of the threads running the partitions other than the first one.
+   * \param [in] index The index of the partition run by the thread.
+   */
+  void RunThread (uint32_t index);
+  /**
+   * Run the events of a partition until the end of the simulation.
+   * \param [in] index The index of the partition.
+   */
+  void RunPartition (uint32_t index);
+  /**
+   * Process the next event of a partition.
+   * \param [in] partition The partition.
+   */
+  void ProcessOneEvent (Partition *partition);
+
+  /**
+   * Wait until all the threads call this method.
+   * \param [in] computeWindow Whether to compute the next window before
+   *        releasing the threads.
+   */
+  void Synchronize (bool computeWindow);
+  /** Compute the next window, or whether the simulation is over. */
+  void ComputeWindow (void);
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Mutex to control access to the destroy events and to the stop time. */
+  mutable SystemMutex m_mutex;
+
+  /** Number of partitions and threads. */
+  uint32_t m_threadCount;
+  /** The factory of the event queues. */
+  ObjectFactory m_schedulerFactory;
+  /** The events scheduled out of Run. */
+  Ptr<Scheduler> m_events;
+  /** The partitions, created at the first call to Run. */
+  std::vector<Partition *> m_partitions;
+  /** The partition of each node, indexed by node id, set by Run. */
+  std::vector<uint32_t> m_nodePartition;
+  /** The threads running the partitions other than the first one. */
+  std::vector<Ptr<SystemThread> > m_threads;
+
+  /** Next event unique id, out of Run. */
+  uint32_t m_uid;
+  /** Unique id of the last event run, out of Run. */
+  uint32_t m_currentUid;
+  /** Timestamp of the current time, out of Run. */
+  uint64_t m_currentTs;
+  /** Flag calling for the end of the simulation. */
+  bool m_stop;
+  /** Timestamp at which the simulation stops. */
+  uint64_t m_stopTs;
+  /** Minimum delay of the channels crossing partitions. */
+  uint64_t m_lookahead;
+  /** Timestamp of the end of the current window. */
+  uint64_t m_windowEnd;
+  /** Flag set between windows when the simulation is over. */
+  bool m_done;
+  /** Flag telling the threads to exit. */
+  bool m_exit;
+
+  /** Mutex of the barrier of the threads. */
+  pthread_mutex_t m_barrierMutex;
+  /** Condition signalled when all the threads reach the barrier. */
+  pthread_cond_t m_barrierCond;
+  /** Number of threads which reached the barrier. */
+  uint32_t m_barrierCount;
+  /** Number of times all the threads reached the barrier. */
+  uint32_t m_barrierGeneration;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
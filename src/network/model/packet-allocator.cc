@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-allocator.h"
+#include "ns3/log.h"
+#include <new>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketAllocator");
+
+namespace {
+
+/** Number of size classes. */
+const uint32_t CLASSES = PacketAllocator::MAX_BLOCK_SIZE / PacketAllocator::GRANULARITY;
+
+/** A free block, linked into the free list of its size class. */
+struct FreeBlock
+{
+  FreeBlock *m_next; //!< Next free block of the same size class
+};
+
+/** Free lists of the current thread, by size class. */
+__thread FreeBlock *g_freeLists[CLASSES];
+/** Length of the free lists of the current thread, by size class. */
+__thread uint32_t g_nFree[CLASSES];
+/** Allocation counters of the current thread. */
+__thread PacketAllocator::Counters g_counters;
+
+/**
+ * Set when the static destructors of this file have run, after which
+ * all the blocks are returned to the system allocator.
+ */
+bool g_destroyed = false;
+
+/** Releases the free blocks of the main thread at exit. */
+struct LocalStaticDestructor
+{
+  ~LocalStaticDestructor ()
+  {
+    PacketAllocator::Release ();
+    g_destroyed = true;
+  }
+} g_localStaticDestructor; //!< Local static destructor
+
+} // anonymous namespace
+
+uint32_t
+PacketAllocator::GetBlockSize (uint32_t size)
+{
+  if (size == 0 || size > MAX_BLOCK_SIZE)
+    {
+      return size == 0 ? static_cast<uint32_t> (GRANULARITY) : size;
+    }
+  return ((size - 1) / GRANULARITY + 1) * GRANULARITY;
+}
+
+void *
+PacketAllocator::Allocate (uint32_t size)
+{
+  g_counters.m_allocations++;
+  uint32_t blockSize = GetBlockSize (size);
+  if (blockSize <= MAX_BLOCK_SIZE)
+    {
+      uint32_t sizeClass = blockSize / GRANULARITY - 1;
+      FreeBlock *block = g_freeLists[sizeClass];
+      if (block != 0)
+        {
+          g_freeLists[sizeClass] = block->m_next;
+          g_nFree[sizeClass]--;
+          return block;
+        }
+    }
+  g_counters.m_systemAllocations++;
+  return ::operator new (blockSize);
+}
+
+void
+PacketAllocator::Deallocate (void *block, uint32_t size)
+{
+  g_counters.m_deallocations++;
+  uint32_t blockSize = GetBlockSize (size);
+  if (blockSize <= MAX_BLOCK_SIZE && !g_destroyed)
+    {
+      uint32_t sizeClass = blockSize / GRANULARITY - 1;
+      if (g_nFree[sizeClass] < MAX_FREE)
+        {
+          FreeBlock *freeBlock = static_cast<FreeBlock *> (block);
+          freeBlock->m_next = g_freeLists[sizeClass];
+          g_freeLists[sizeClass] = freeBlock;
+          g_nFree[sizeClass]++;
+          return;
+        }
+    }
+  g_counters.m_systemDeallocations++;
+  ::operator delete (block);
+}
+
+PacketAllocator::Counters
+PacketAllocator::GetCounters (void)
+{
+  return g_counters;
+}
+
+void
+PacketAllocator::ResetCounters (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Counters zero = { 0, 0, 0, 0 };
+  g_counters = zero;
+}
+
+void
+PacketAllocator::Release (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  for (uint32_t i = 0; i < CLASSES; ++i)
+    {
+      while (g_freeLists[i] != 0)
+        {
+          FreeBlock *block = g_freeLists[i];
+          g_freeLists[i] = block->m_next;
+          ::operator delete (block);
+        }
+      g_nFree[i] = 0;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_ALLOCATOR_H
+#define PACKET_ALLOCATOR_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Size-classed allocator of the memory blocks of the packets.
+ *
+ * The blocks of Buffer::Data, PacketMetadata::Data and
+ * PacketTagList::TagData are rounded up to a multiple of GRANULARITY
+ * bytes, and the freed blocks are kept in one free list per size class,
+ * so that a block freed by a packet of any size is reused by the next
+ * packet of the same class instead of going back to the system allocator.
+ * Blocks larger than MAX_BLOCK_SIZE always use the system allocator.
+ *
+ * The free lists and the counters are per thread, since
+ * MultithreadedSimulatorImpl creates and frees packets from several
+ * threads: a block may be freed by another thread than the one which
+ * allocated it. Each free list holds at most MAX_FREE blocks, above which
+ * the freed blocks are returned to the system allocator.
+ */
+class PacketAllocator
+{
+public:
+  /** Parameters of the size classes. */
+  enum
+  {
+    GRANULARITY = 16,       //!< Granularity of the size classes, in bytes
+    MAX_BLOCK_SIZE = 4096,  //!< Size of the largest class, in bytes
+    MAX_FREE = 4096         //!< Maximum number of free blocks per class and thread
+  };
+
+  /** Allocation counters of a thread. */
+  struct Counters
+  {
+    uint64_t m_allocations;         //!< Blocks allocated
+    uint64_t m_systemAllocations;   //!< Blocks allocated by the system allocator
+    uint64_t m_deallocations;       //!< Blocks deallocated
+    uint64_t m_systemDeallocations; //!< Blocks freed by the system allocator
+  };
+
+  /**
+   * Get the size of the blocks allocated for a requested size.
+   *
+   * \param [in] size The requested size, in bytes.
+   * \returns The size of the block, which is at least the requested size.
+   */
+  static uint32_t GetBlockSize (uint32_t size);
+
+  /**
+   * Allocate a block.
+   *
+   * \param [in] size The requested size, in bytes.
+   * \returns A block of GetBlockSize (size) bytes.
+   */
+  static void *Allocate (uint32_t size);
+
+  /**
+   * Deallocate a block.
+   *
+   * \param [in] block The block.
+   * \param [in] size The requested size or the size of the block, in bytes.
+   */
+  static void Deallocate (void *block, uint32_t size);
+
+  /**
+   * Get the allocation counters of the calling thread.
+   *
+   * \returns The counters since the start of the thread, or since the
+   *          last call to ResetCounters.
+   */
+  static Counters GetCounters (void);
+
+  /** Reset the allocation counters of the calling thread. */
+  static void ResetCounters (void);
+
+  /**
+   * Return the free blocks of the calling thread to the system allocator,
+   * as threads which exit must do.
+   */
+  static void Release (void);
+};
+
+} // namespace ns3
+
+#endif /* PACKET_ALLOCATOR_H */
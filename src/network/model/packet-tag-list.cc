@@ -24,6 +24,7 @@
 */
 
 #include "packet-tag-list.h"
+#include "packet-allocator.h"
 #include "tag-buffer.h"
 #include "tag.h"
 #include "ns3/fatal-error.h"
@@ -34,6 +35,18 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
+void *
+PacketTagList::TagData::operator new (std::size_t size)
+{
+  return PacketAllocator::Allocate (size);
+}
+
+void
+PacketTagList::TagData::operator delete (void *p, std::size_t size)
+{
+  PacketAllocator::Deallocate (p, size);
+}
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -154,10 +167,37 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 
 }
 
+int
+PacketTagList::FindInline (TypeId tid) const
+{
+  for (uint8_t i = 0; i < m_nInline; ++i)
+    {
+      if (m_inline[i].tid == tid)
+        {
+          return i;
+        }
+    }
+  return -1;
+}
+
 bool
 PacketTagList::Remove (Tag & tag)
 {
-  return COWTraverse (tag, &PacketTagList::RemoveWriter);
+  int i = FindInline (tag.GetInstanceTypeId ());
+  if (i >= 0)
+    {
+      tag.Deserialize (TagBuffer (m_inline[i].data,
+                                  m_inline[i].data + TagData::MAX_SIZE));
+      for (m_nInline--; i < m_nInline; ++i)
+        {
+          m_inline[i] = m_inline[i + 1];
+        }
+      Link ();
+      return true;
+    }
+  bool found = COWTraverse (tag, &PacketTagList::RemoveWriter);
+  Link ();
+  return found;
 }
 
 // COWWriter implementing Remove
@@ -196,7 +236,15 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
 bool
 PacketTagList::Replace (Tag & tag)
 {
+  int i = FindInline (tag.GetInstanceTypeId ());
+  if (i >= 0)
+    {
+      tag.Serialize (TagBuffer (m_inline[i].data,
+                                m_inline[i].data + tag.GetSerializedSize ()));
+      return true;
+    }
   bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
+  Link ();
   if (!found)
     {
       Add (tag);
@@ -245,19 +293,33 @@ PacketTagList::Add (const Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   // ensure this id was not yet added
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  for (const struct TagData *cur = Head (); cur != 0; cur = cur->next) 
     {
       NS_ASSERT (cur->tid != tag.GetInstanceTypeId ());
     }
-  struct TagData * head = new struct TagData ();
+  PacketTagList *self = const_cast<PacketTagList *> (this);
+  if (m_nInline == INLINE_TAGS)
+    {
+      // move the oldest inline tag to the head of the older tags, which
+      // takes over the reference to the previous head
+      struct TagData * head = new struct TagData ();
+      *head = m_inline[INLINE_TAGS - 1];
+      head->count = 1;
+      head->next = m_next;
+      self->m_next = head;
+      self->m_nInline--;
+    }
+  for (uint8_t i = m_nInline; i > 0; --i)
+    {
+      self->m_inline[i] = m_inline[i - 1];
+    }
+  struct TagData * head = &self->m_inline[0];
   head->count = 1;
-  head->next = 0;
   head->tid = tag.GetInstanceTypeId ();
-  head->next = m_next;
   NS_ASSERT (tag.GetSerializedSize () <= TagData::MAX_SIZE);
   tag.Serialize (TagBuffer (head->data, head->data + tag.GetSerializedSize ()));
-
-  const_cast<PacketTagList *> (this)->m_next = head;
+  self->m_nInline++;
+  self->Link ();
 }
 
 bool
@@ -265,7 +327,7 @@ PacketTagList::Peek (Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  for (struct TagData *cur = const_cast<struct TagData *> (Head ()); cur != 0; cur = cur->next) 
     {
       if (cur->tid == tid) 
         {
@@ -281,7 +343,7 @@ PacketTagList::Peek (Tag &tag) const
 const struct PacketTagList::TagData *
 PacketTagList::Head (void) const
 {
-  return m_next;
+  return m_nInline > 0 ? &m_inline[0] : m_next;
 }
 
 } /* namespace ns3 */
@@ -26,6 +26,7 @@
 */
 
 #include <stdint.h>
+#include <cstddef>
 #include <ostream>
 #include "ns3/type-id.h"
 
@@ -120,6 +121,19 @@ class Tag;
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
  *
+ * \par <b> Inline storage </b>
+ *
+ *   - The INLINE_TAGS most recent tags are stored in the PacketTagList
+ *     itself, in #m_inline, which is copied with the PacketTagList, so that
+ *     packets with a few tags need no heap allocation to add, find or
+ *     remove them. The tree above only holds the older tags, from
+ *     #m_next, and is shared and copied on write as described.
+ *
+ *   - When a tag is added to a full #m_inline, the oldest inline tag
+ *     moves to the head of the tree. The \c next pointers of the inline
+ *     tags link them, newest first, to #m_next, so that the list from
+ *     #Head is in the order the tags were added.
+ *
  * \par <b> Memory Management: </b>
  * \n
  * Packet tags must serialize to a finite maximum size, see TagData
@@ -165,6 +179,19 @@ public:
     struct TagData * next;   /**< Pointer to next in list */
     TypeId tid;               /**< Type of the tag serialized into #data */
     uint32_t count;           /**< Number of incoming links */
+
+    /**
+     * Allocate a TagData from the PacketAllocator.
+     * \param [in] size The size of the TagData.
+     * \returns The memory of the TagData.
+     */
+    static void *operator new (std::size_t size);
+    /**
+     * Return the memory of a TagData to the PacketAllocator.
+     * \param [in] p The memory of the TagData.
+     * \param [in] size The size of the TagData.
+     */
+    static void operator delete (void *p, std::size_t size);
   };  /* struct TagData */
 
   /**
@@ -176,8 +203,9 @@ public:
    *
    * \param [in] o The PacketTagList to copy.
    *
-   * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * This copies the inline tags of \pname{o}, then makes a
+   * light-weight copy of the others by pointing to the same
+   * \ref TagData as \pname{o}.
    */
   inline PacketTagList (PacketTagList const &o);
   /**
@@ -187,7 +215,8 @@ public:
    * \returns the copied object
    *
    * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * copying the inline tags and pointing to the same \ref TagData
+   * as \pname{o}.
    */
   inline PacketTagList &operator = (PacketTagList const &o);
   /**
@@ -239,6 +268,30 @@ public:
   const struct PacketTagList::TagData *Head (void) const;
 
 private:
+  /** Number of tags stored in the PacketTagList itself. */
+  enum
+  {
+    INLINE_TAGS = 3
+  };
+
+  /**
+   * Copy the tags of another list, which must be empty.
+   *
+   * \param [in] o The PacketTagList to copy.
+   */
+  inline void Copy (PacketTagList const &o);
+  /**
+   * Link the inline tags to each other, then to #m_next.
+   */
+  inline void Link (void);
+  /**
+   * Find a tag among the inline tags.
+   *
+   * \param [in] tid The type of the tag.
+   * \returns The index of the tag in #m_inline, or -1 if not found.
+   */
+  int FindInline (TypeId tid) const;
+
   /**
    * Typedef of method function pointer for copy-on-write operations
    *
@@ -288,9 +341,17 @@ private:
   bool ReplaceWriter (Tag & tag, bool preMerge, struct TagData * cur, struct TagData ** prevNext);
 
   /**
-   * Pointer to first \ref TagData on the list
+   * The most recent tags, newest first.
+   */
+  struct TagData m_inline[INLINE_TAGS];
+  /**
+   * Pointer to first \ref TagData on the list of the older tags
    */
   struct TagData *m_next;
+  /**
+   * Number of tags in #m_inline
+   */
+  uint8_t m_nInline;
 };
 
 } // namespace ns3
@@ -302,34 +363,58 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_next (),
+    m_nInline (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_next (),
+    m_nInline (0)
 {
-  if (m_next != 0)
-    {
-      m_next->count++;
-    }
+  Copy (o);
 }
 
 PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (this == &o) 
     {
       return *this;
     }
   RemoveAll ();
+  Copy (o);
+  return *this;
+}
+
+void
+PacketTagList::Copy (PacketTagList const &o)
+{
+  for (uint8_t i = 0; i < o.m_nInline; ++i)
+    {
+      m_inline[i] = o.m_inline[i];
+    }
+  m_nInline = o.m_nInline;
   m_next = o.m_next;
-  if (m_next != 0) 
+  if (m_next != 0)
     {
       m_next->count++;
     }
-  return *this;
+  Link ();
+}
+
+void
+PacketTagList::Link (void)
+{
+  for (uint8_t i = 0; i + 1 < m_nInline; ++i)
+    {
+      m_inline[i].next = &m_inline[i + 1];
+    }
+  if (m_nInline > 0)
+    {
+      m_inline[m_nInline - 1].next = m_next;
+    }
 }
 
 PacketTagList::~PacketTagList ()
@@ -340,6 +425,7 @@ PacketTagList::~PacketTagList ()
 void
 PacketTagList::RemoveAll (void)
 {
+  m_nInline = 0;
   struct TagData *prev = 0;
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
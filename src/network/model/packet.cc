@@ -28,7 +28,9 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+// Packet uids are made unique across threads by the system id, in the
+// upper 32 bits of the uid, see MultithreadedSimulatorImpl::GetSystemId
+__thread uint32_t Packet::m_globalUid = 0;
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -721,7 +721,7 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  static __thread uint32_t m_globalUid; //!< Counter of packets Uid of the current thread
 };
 
 /**
@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/packet.h"
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+class BinaryTraceFileTestCase : public TestCase
+{
+public:
+  BinaryTraceFileTestCase ();
+  virtual void DoRun (void);
+};
+
+BinaryTraceFileTestCase::BinaryTraceFileTestCase ()
+  : TestCase ("Write, read and convert a binary trace file")
+{
+}
+
+void
+BinaryTraceFileTestCase::DoRun (void)
+{
+  // A PPP header, an IPv4 header from 10.1.1.1 to 10.2.1.2 and the ports
+  // of a TCP header, from 49153 to 5001
+  uint8_t frame[] = {
+    0x00, 0x21,
+    0x45, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x40, 0x06, 0x00, 0x00,
+    0x0a, 0x01, 0x01, 0x01, 0x0a, 0x02, 0x01, 0x02,
+    0xc0, 0x01, 0x13, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+  };
+  Ptr<Packet> tcp = Create<Packet> (frame, sizeof (frame));
+  Ptr<Packet> raw = Create<Packet> (100);
+
+  std::string filename = CreateTempDirFilename ("binary-trace-file.bin");
+  {
+    Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> (filename);
+    file->Write ('+', 3, 1, tcp);
+    file->Write ('d', 4, 2, raw);
+  }
+
+  std::ifstream is (filename.c_str (), std::ios::in | std::ios::binary);
+  NS_TEST_ASSERT_MSG_EQ (BinaryTraceFile::ReadHeader (is), true, "Bad header");
+  BinaryTraceFile::Record record;
+  NS_TEST_ASSERT_MSG_EQ (BinaryTraceFile::Read (is, record), true, "Missing record");
+  NS_TEST_EXPECT_MSG_EQ (record.m_event, '+', "Bad event");
+  NS_TEST_EXPECT_MSG_EQ (record.m_node, 3, "Bad node");
+  NS_TEST_EXPECT_MSG_EQ (record.m_device, 1, "Bad device");
+  NS_TEST_EXPECT_MSG_EQ (record.m_uid, tcp->GetUid (), "Bad uid");
+  NS_TEST_EXPECT_MSG_EQ (record.m_size, sizeof (frame), "Bad size");
+  NS_TEST_EXPECT_MSG_EQ (record.m_protocol, 6, "Bad protocol");
+  NS_TEST_EXPECT_MSG_EQ (record.m_source, 0x0a010101, "Bad source");
+  NS_TEST_EXPECT_MSG_EQ (record.m_destination, 0x0a020102, "Bad destination");
+  NS_TEST_EXPECT_MSG_EQ (record.m_sourcePort, 49153, "Bad source port");
+  NS_TEST_EXPECT_MSG_EQ (record.m_destinationPort, 5001, "Bad destination port");
+  NS_TEST_ASSERT_MSG_EQ (BinaryTraceFile::Read (is, record), true, "Missing record");
+  NS_TEST_EXPECT_MSG_EQ (record.m_protocol, 0, "Bad protocol");
+  NS_TEST_EXPECT_MSG_EQ (BinaryTraceFile::Read (is, record), false, "Extra record");
+
+  std::ifstream converted (filename.c_str (), std::ios::in | std::ios::binary);
+  std::ostringstream oss;
+  NS_TEST_ASSERT_MSG_EQ (BinaryTraceFile::ConvertToAscii (converted, oss), true, "Bad header");
+  std::ostringstream expected;
+  expected << "+ 0 /NodeList/3/DeviceList/1 uid " << tcp->GetUid ()
+           << " size 46 protocol 6 10.1.1.1:49153 > 10.2.1.2:5001\n"
+           << "d 0 /NodeList/4/DeviceList/2 uid " << raw->GetUid () << " size 100\n";
+  NS_TEST_EXPECT_MSG_EQ (oss.str (), expected.str (), "Bad conversion");
+}
+
+class BinaryTraceFileTestSuite : public TestSuite
+{
+public:
+  BinaryTraceFileTestSuite ();
+};
+
+BinaryTraceFileTestSuite::BinaryTraceFileTestSuite ()
+  : TestSuite ("binary-trace-file", UNIT)
+{
+  AddTestCase (new BinaryTraceFileTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceFileTestSuite g_binaryTraceFileTestSuite;
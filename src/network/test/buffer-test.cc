@@ -19,6 +19,7 @@
  */
 
 #include "ns3/buffer.h"
+#include "ns3/packet-allocator.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/double.h"
 #include "ns3/test.h"
@@ -361,6 +362,137 @@ BufferTest::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
 }
 //-----------------------------------------------------------------------------
+class PacketAllocatorTest : public TestCase {
+public:
+  virtual void DoRun (void);
+  PacketAllocatorTest ();
+};
+
+PacketAllocatorTest::PacketAllocatorTest ()
+  : TestCase ("PacketAllocator") {
+}
+
+void
+PacketAllocatorTest::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (PacketAllocator::GetBlockSize (1), 16, "Bad block size");
+  NS_TEST_ASSERT_MSG_EQ (PacketAllocator::GetBlockSize (16), 16, "Bad block size");
+  NS_TEST_ASSERT_MSG_EQ (PacketAllocator::GetBlockSize (17), 32, "Bad block size");
+  NS_TEST_ASSERT_MSG_EQ (PacketAllocator::GetBlockSize (4096), 4096, "Bad block size");
+  NS_TEST_ASSERT_MSG_EQ (PacketAllocator::GetBlockSize (4097), 4097, "Bad block size");
+
+  PacketAllocator::Release ();
+  PacketAllocator::ResetCounters ();
+
+  // a freed block is reused by the next block of its size class
+  void *block = PacketAllocator::Allocate (100);
+  PacketAllocator::Deallocate (block, 100);
+  NS_TEST_ASSERT_MSG_EQ (PacketAllocator::Allocate (97), block, "Block not reused");
+  PacketAllocator::Deallocate (block, 97);
+  PacketAllocator::Counters counters = PacketAllocator::GetCounters ();
+  NS_TEST_ASSERT_MSG_EQ (counters.m_allocations, 2, "Bad allocations");
+  NS_TEST_ASSERT_MSG_EQ (counters.m_systemAllocations, 1, "Bad system allocations");
+  NS_TEST_ASSERT_MSG_EQ (counters.m_deallocations, 2, "Bad deallocations");
+  NS_TEST_ASSERT_MSG_EQ (counters.m_systemDeallocations, 0, "Bad system deallocations");
+
+  // larger blocks use the system allocator
+  block = PacketAllocator::Allocate (5000);
+  PacketAllocator::Deallocate (block, 5000);
+  counters = PacketAllocator::GetCounters ();
+  NS_TEST_ASSERT_MSG_EQ (counters.m_systemAllocations, 2, "Bad system allocations");
+  NS_TEST_ASSERT_MSG_EQ (counters.m_systemDeallocations, 1, "Bad system deallocations");
+
+  // buffers of mixed sizes stop allocating memory once the maximum size
+  // of the buffers is learned
+  for (uint32_t round = 0; round < 3; ++round)
+    {
+      PacketAllocator::ResetCounters ();
+      uint32_t sizes[] = { 172, 840, 1500 };
+      for (uint32_t i = 0; i < 3; ++i)
+        {
+          Buffer buffer;
+          buffer.AddAtStart (sizes[i]);
+          buffer.Begin ().WriteU8 (0x66, sizes[i]);
+          Buffer copy = buffer.CreateFragment (0, sizes[i] / 2);
+          copy.AddAtEnd (8);
+        }
+      counters = PacketAllocator::GetCounters ();
+      NS_TEST_ASSERT_MSG_GT (counters.m_allocations, 0, "Buffers not allocated");
+      NS_TEST_ASSERT_MSG_EQ (counters.m_allocations, counters.m_deallocations, "Buffers not freed");
+      if (round == 2)
+        {
+          NS_TEST_ASSERT_MSG_EQ (counters.m_systemAllocations, 0, "Buffers not reused");
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+class BufferChecksumTest : public TestCase {
+public:
+  virtual void DoRun (void);
+  BufferChecksumTest ();
+};
+
+BufferChecksumTest::BufferChecksumTest ()
+  : TestCase ("Buffer checksum") {
+}
+
+void
+BufferChecksumTest::DoRun (void)
+{
+  // the checksum of each range of buffers with zero areas of several
+  // sizes must match the sum of their 16-bit words, one at a time
+  uint32_t sizes[] = { 0, 1, 2, 7, 8, 19 };
+  uint32_t nSizes = sizeof (sizes) / sizeof (sizes[0]);
+  for (uint32_t zero = 0; zero < nSizes; ++zero)
+    {
+      for (uint32_t head = 0; head < nSizes; ++head)
+        {
+          for (uint32_t tail = 0; tail < nSizes; ++tail)
+            {
+              Buffer buffer (sizes[zero]);
+              buffer.AddAtStart (sizes[head]);
+              Buffer::Iterator i = buffer.Begin ();
+              for (uint32_t j = 0; j < sizes[head]; ++j)
+                {
+                  i.WriteU8 (0xf1 + 13 * j);
+                }
+              buffer.AddAtEnd (sizes[tail]);
+              i = buffer.End ();
+              i.Prev (sizes[tail]);
+              for (uint32_t j = 0; j < sizes[tail]; ++j)
+                {
+                  i.WriteU8 (0x9b + 29 * j);
+                }
+
+              uint32_t size = buffer.GetSize ();
+              std::vector<uint8_t> bytes (size + 1, 0);
+              buffer.CopyData (&bytes[0], size);
+              for (uint32_t start = 0; start < 3 && start <= size; ++start)
+                {
+                  uint32_t sum = 0xabcd;
+                  for (uint32_t j = start; j < size; j += 2)
+                    {
+                      sum += bytes[j] | (bytes[j + 1] << 8);
+                    }
+                  while (sum >> 16)
+                    {
+                      sum = (sum & 0xffff) + (sum >> 16);
+                    }
+                  uint16_t expected = ~sum;
+
+                  i = buffer.Begin ();
+                  i.Next (start);
+                  uint16_t checksum = i.CalculateIpChecksum (size - start, 0xabcd);
+                  NS_TEST_ASSERT_MSG_EQ (checksum, expected, "Bad checksum with zero area of size "
+                                         << sizes[zero] << ", " << sizes[head] << " bytes before it, "
+                                         << sizes[tail] << " bytes after it, from byte " << start);
+                  NS_TEST_ASSERT_MSG_EQ (i.IsEnd (), true, "Iterator not advanced");
+                }
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------------
 class BufferTestSuite : public TestSuite
 {
 public:
@@ -371,6 +503,8 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest, TestCase::QUICK);
+  AddTestCase (new PacketAllocatorTest, TestCase::QUICK);
+  AddTestCase (new BufferChecksumTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite;
@@ -19,6 +19,8 @@
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include <list>
 
 using namespace ns3;
 
@@ -77,6 +79,50 @@ DropTailQueueTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ ((p == 0), true, "There are really no packets in there");
 }
 
+class DropTailQueueBytesTestCase : public TestCase
+{
+public:
+  DropTailQueueBytesTestCase ();
+  virtual void DoRun (void);
+};
+
+DropTailQueueBytesTestCase::DropTailQueueBytesTestCase ()
+  : TestCase ("Check the order of the packets as the drop tail queue storage wraps and grows")
+{
+}
+void
+DropTailQueueBytesTestCase::DoRun (void)
+{
+  Ptr<DropTailQueue> queue = CreateObject<DropTailQueue> ();
+  queue->SetAttribute ("Mode", EnumValue (Queue::QUEUE_MODE_BYTES));
+  queue->SetAttribute ("MaxBytes", UintegerValue (100 * 1000));
+
+  // fill the queue up to 50 packets and drain it down to 10, with
+  // packets of various sizes, so that the storage grows and wraps
+  std::list<Ptr<Packet> > expected;
+  uint32_t bytes = 0;
+  for (uint32_t round = 0; round < 4; ++round)
+    {
+      while (expected.size () < 50)
+        {
+          Ptr<Packet> p = Create<Packet> (expected.size () + round + 1);
+          NS_TEST_ASSERT_MSG_EQ (queue->Enqueue (p), true, "The packet should be accepted");
+          expected.push_back (p);
+          bytes += p->GetSize ();
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), bytes, "Wrong number of bytes in there");
+      while (expected.size () > 10)
+        {
+          Ptr<Packet> p = queue->Dequeue ();
+          NS_TEST_ASSERT_MSG_EQ (p, expected.front (), "Packet out of order");
+          expected.pop_front ();
+          bytes -= p->GetSize ();
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 10, "There should be ten packets in there");
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), bytes, "Wrong number of bytes in there");
+    }
+}
+
 static class DropTailQueueTestSuite : public TestSuite
 {
 public:
@@ -84,5 +130,6 @@ public:
     : TestSuite ("drop-tail-queue", UNIT)
   {
     AddTestCase (new DropTailQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new DropTailQueueBytesTestCase (), TestCase::QUICK);
   }
 } g_dropTailQueueTestSuite;
@@ -727,6 +727,23 @@ PacketTagListTest::DoRun (void)
     NS_TEST_EXPECT_MSG_EQ (ref.Peek (t10), false, "missing tag");
   }
 
+  { // Head order, across the inline and the shared tags
+    std::cout << GetName () << "check Head order" << std::endl;
+    TypeId tids[] = { t7.GetInstanceTypeId (), t6.GetInstanceTypeId (),
+                      t5.GetInstanceTypeId (), t4.GetInstanceTypeId (),
+                      t3.GetInstanceTypeId (), t2.GetInstanceTypeId (),
+                      t1.GetInstanceTypeId () };
+    PacketTagList ptl (ref);
+    const struct PacketTagList::TagData *cur = ptl.Head ();
+    for (int i = 0; i < tagLast; ++i)
+      {
+        NS_TEST_ASSERT_MSG_NE (cur, 0, "missing tag " << i);
+        NS_TEST_EXPECT_MSG_EQ (cur->tid, tids[i], "tag " << i << " out of order");
+        cur = cur->next;
+      }
+    NS_TEST_EXPECT_MSG_EQ (cur, 0, "extra tag");
+  }
+
   { // Copy ctor, assignment
     std::cout << GetName () << "check copy and assignment" << std::endl;
     { PacketTagList ptl (ref);
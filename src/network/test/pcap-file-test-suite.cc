@@ -25,6 +25,10 @@
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace ns3;
 
@@ -77,6 +81,26 @@ CheckFileLength (std::string filename, uint64_t sizeExpected)
   return sizeActual == sizeExpected;
 }
 
+static std::string
+ReadFileContents (std::string filename)
+{
+  std::string contents;
+  FILE * p = std::fopen (filename.c_str (), "rb");
+  if (p == 0)
+    {
+      return contents;
+    }
+
+  char buffer[4096];
+  size_t n;
+  while ((n = std::fread (buffer, 1, sizeof (buffer), p)) > 0)
+    {
+      contents.append (buffer, n);
+    }
+  std::fclose (p);
+  return contents;
+}
+
 // ===========================================================================
 // Test case to make sure that the Pcap File Object can do its most basic job 
 // and create an empty pcap file.
@@ -1121,6 +1145,98 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that the files written from a background thread,
+// compressed or not, hold the same records as the files written
+// synchronously.
+// ===========================================================================
+class AsyncWriteTestCase : public TestCase
+{
+public:
+  AsyncWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Write the same records to a file.
+   * \param f The file, opened for writing.
+   */
+  void WriteRecords (PcapFile &f);
+};
+
+AsyncWriteTestCase::AsyncWriteTestCase ()
+  : TestCase ("Check that PcapFile writes the same records from a background thread")
+{
+}
+
+void
+AsyncWriteTestCase::WriteRecords (PcapFile &f)
+{
+  f.Init (1, 100);
+  uint8_t data[150];
+  for (uint32_t i = 0; i < sizeof (data); ++i)
+    {
+      data[i] = i;
+    }
+  //
+  // Some records are longer than the snapshot length, and together they
+  // wrap around the small ring buffer many times.
+  //
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      f.Write (i / 10, (i % 10) * 100000, data, i % sizeof (data));
+    }
+}
+
+void
+AsyncWriteTestCase::DoRun (void)
+{
+  std::string syncFilename = CreateTempDirFilename ("sync.pcap");
+  PcapFile sync;
+  sync.Open (syncFilename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (sync.Fail (), false, "Open (" << syncFilename << ", \"std::ios::out\") returns error");
+  WriteRecords (sync);
+  sync.Close ();
+  std::string expected = ReadFileContents (syncFilename);
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 24 + 1000 * 16 + 64650, "Unexpected size of " << syncFilename);
+
+  std::string asyncFilename = CreateTempDirFilename ("async.pcap");
+  PcapFile async;
+  async.SetAsynchronous (1024, false);
+  async.Open (asyncFilename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (async.Fail (), false, "Open (" << asyncFilename << ", \"std::ios::out\") returns error");
+  WriteRecords (async);
+  async.Close ();
+  NS_TEST_EXPECT_MSG_EQ (async.Fail (), false, "Close () returns error");
+  NS_TEST_EXPECT_MSG_EQ ((ReadFileContents (asyncFilename) == expected), true,
+                         asyncFilename << " differs from " << syncFilename);
+
+#if defined (HAVE_PTHREAD_H) && defined (HAVE_ZLIB)
+  std::string gzipFilename = CreateTempDirFilename ("async.pcap.gz");
+  PcapFile gzip;
+  gzip.SetAsynchronous (1024, true);
+  gzip.Open (gzipFilename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (gzip.Fail (), false, "Open (" << gzipFilename << ", \"std::ios::out\") returns error");
+  WriteRecords (gzip);
+  gzip.Close ();
+  NS_TEST_EXPECT_MSG_EQ (gzip.Fail (), false, "Close () returns error");
+
+  std::string contents;
+  gzFile file = gzopen (gzipFilename.c_str (), "rb");
+  NS_TEST_ASSERT_MSG_NE (file, 0, "Unable to open " << gzipFilename);
+  char buffer[4096];
+  int n;
+  while ((n = gzread (file, buffer, sizeof (buffer))) > 0)
+    {
+      contents.append (buffer, n);
+    }
+  gzclose (file);
+  NS_TEST_EXPECT_MSG_EQ ((contents == expected), true,
+                         gzipFilename << " does not uncompress to " << syncFilename);
+#endif
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1138,6 +1254,7 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new AsyncWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
@@ -0,0 +1,322 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-file-writer.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/system-thread.h"
+#include <algorithm>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AsyncFileWriter");
+
+namespace {
+
+/** Time the background thread waits between two writes, in microseconds. */
+const uint32_t WAIT_US = 10000;
+
+/** The background thread, which exists while writers are open. */
+struct WriterThread
+{
+  std::vector<AsyncFileWriter *> m_writers; //!< The open writers
+  Ptr<SystemThread> m_thread;               //!< The thread
+  bool m_stop;                              //!< Whether the thread should exit
+};
+
+/** Serializes the opening and the closing of the writers. */
+pthread_mutex_t g_openMutex = PTHREAD_MUTEX_INITIALIZER;
+/** Protects g_thread, and held by the background thread while it writes. */
+pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** Signalled to wake up the background thread. */
+pthread_cond_t g_wakeUp = PTHREAD_COND_INITIALIZER;
+/** Whether the background thread waits, without holding g_mutex. */
+bool g_sleeping = false;
+/** The background thread, or 0 if no writer is open. */
+WriterThread *g_thread = 0;
+
+} // anonymous namespace
+
+AsyncFileWriter::AsyncFileWriter (std::string filename, uint32_t bufferSize, bool compress)
+  : m_fd (-1),
+    m_gzFile (0),
+    m_ring (0),
+    m_ringSize (1),
+    m_head (0),
+    m_tail (0),
+    m_open (false),
+    m_failed (false)
+{
+  NS_LOG_FUNCTION (this << filename << bufferSize << compress);
+  while (m_ringSize < bufferSize)
+    {
+      m_ringSize <<= 1;
+    }
+  m_ring = new uint8_t[m_ringSize];
+
+  m_fd = open (filename.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (m_fd < 0)
+    {
+      NS_LOG_WARN ("Unable to open " << filename << ": " << std::strerror (errno));
+      m_failed = true;
+      return;
+    }
+  if (compress)
+    {
+#ifdef HAVE_ZLIB
+      // The fastest level, so that the background thread keeps up
+      m_gzFile = gzdopen (m_fd, "wb1");
+      NS_ABORT_MSG_IF (m_gzFile == 0, "Unable to compress " << filename);
+#else
+      NS_FATAL_ERROR ("Compressed files need zlib, which was not found at configure time");
+#endif
+    }
+
+  pthread_mutex_lock (&g_openMutex);
+  pthread_mutex_lock (&g_mutex);
+  bool start = g_thread == 0;
+  if (start)
+    {
+      g_thread = new WriterThread;
+      g_thread->m_stop = false;
+    }
+  g_thread->m_writers.push_back (this);
+  m_open = true;
+  pthread_mutex_unlock (&g_mutex);
+  if (start)
+    {
+      g_thread->m_thread = Create<SystemThread> (MakeCallback (&AsyncFileWriter::Run));
+      g_thread->m_thread->Start ();
+    }
+  pthread_mutex_unlock (&g_openMutex);
+}
+
+AsyncFileWriter::~AsyncFileWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+  delete [] m_ring;
+}
+
+bool
+AsyncFileWriter::Fail (void) const
+{
+  return __atomic_load_n (&m_failed, __ATOMIC_ACQUIRE);
+}
+
+void
+AsyncFileWriter::Write (const void *data, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << data << size);
+  if (!m_open)
+    {
+      return;
+    }
+  const uint8_t *bytes = static_cast<const uint8_t *> (data);
+  while (size > 0)
+    {
+      uint32_t used = m_tail - __atomic_load_n (&m_head, __ATOMIC_ACQUIRE);
+      if (used == m_ringSize)
+        {
+          // The background thread is behind: this is the only wait
+          Wake ();
+          sched_yield ();
+          continue;
+        }
+      uint32_t offset = m_tail & (m_ringSize - 1);
+      uint32_t n = std::min (size, std::min (m_ringSize - used, m_ringSize - offset));
+      std::memcpy (m_ring + offset, bytes, n);
+      __atomic_store_n (&m_tail, m_tail + n, __ATOMIC_RELEASE);
+      bytes += n;
+      size -= n;
+      if (used < m_ringSize / 2 && used + n >= m_ringSize / 2)
+        {
+          Wake ();
+        }
+    }
+}
+
+void
+AsyncFileWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_open)
+    {
+      pthread_mutex_lock (&g_openMutex);
+      pthread_mutex_lock (&g_mutex);
+      std::vector<AsyncFileWriter *> &writers = g_thread->m_writers;
+      writers.erase (std::find (writers.begin (), writers.end (), this));
+      bool stop = writers.empty ();
+      if (stop)
+        {
+          g_thread->m_stop = true;
+          pthread_cond_signal (&g_wakeUp);
+        }
+      pthread_mutex_unlock (&g_mutex);
+      if (stop)
+        {
+          g_thread->m_thread->Join ();
+          delete g_thread;
+          g_thread = 0;
+        }
+      pthread_mutex_unlock (&g_openMutex);
+      m_open = false;
+
+      // The background thread is done with this file
+      Drain ();
+    }
+#ifdef HAVE_ZLIB
+  if (m_gzFile != 0)
+    {
+      // Also closes the file descriptor
+      if (gzclose (static_cast<gzFile> (m_gzFile)) != Z_OK)
+        {
+          m_failed = true;
+        }
+      m_gzFile = 0;
+      m_fd = -1;
+    }
+#endif
+  if (m_fd >= 0)
+    {
+      if (close (m_fd) != 0)
+        {
+          m_failed = true;
+        }
+      m_fd = -1;
+    }
+}
+
+void
+AsyncFileWriter::Run (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  pthread_mutex_lock (&g_mutex);
+  while (!g_thread->m_stop)
+    {
+      for (std::vector<AsyncFileWriter *>::const_iterator i = g_thread->m_writers.begin ();
+           i != g_thread->m_writers.end (); ++i)
+        {
+          (*i)->Drain ();
+        }
+
+      // Let the data accumulate, unless a ring gets half full
+      struct timeval now;
+      gettimeofday (&now, 0);
+      uint64_t us = now.tv_usec + WAIT_US;
+      struct timespec deadline;
+      deadline.tv_sec = now.tv_sec + us / 1000000;
+      deadline.tv_nsec = (us % 1000000) * 1000;
+      __atomic_store_n (&g_sleeping, true, __ATOMIC_RELEASE);
+      pthread_cond_timedwait (&g_wakeUp, &g_mutex, &deadline);
+      __atomic_store_n (&g_sleeping, false, __ATOMIC_RELEASE);
+    }
+  pthread_mutex_unlock (&g_mutex);
+}
+
+void
+AsyncFileWriter::Wake (void)
+{
+  // A missed wake up only delays the write until the end of the wait
+  if (__atomic_load_n (&g_sleeping, __ATOMIC_ACQUIRE))
+    {
+      pthread_mutex_lock (&g_mutex);
+      pthread_cond_signal (&g_wakeUp);
+      pthread_mutex_unlock (&g_mutex);
+    }
+}
+
+void
+AsyncFileWriter::Drain (void)
+{
+  uint64_t tail = __atomic_load_n (&m_tail, __ATOMIC_ACQUIRE);
+  if (tail == m_head)
+    {
+      return;
+    }
+  uint32_t offset = m_head & (m_ringSize - 1);
+  uint32_t size = tail - m_head;
+  uint32_t first = std::min (size, m_ringSize - offset);
+  // After a failure, the data is discarded so that the writer never waits
+  if (!m_failed && !WriteFile (m_ring + offset, first, m_ring, size - first))
+    {
+      NS_LOG_WARN ("Write error: " << std::strerror (errno));
+      __atomic_store_n (&m_failed, true, __ATOMIC_RELEASE);
+    }
+  __atomic_store_n (&m_head, tail, __ATOMIC_RELEASE);
+}
+
+bool
+AsyncFileWriter::WriteFile (const uint8_t *first, uint32_t firstSize,
+                            const uint8_t *second, uint32_t secondSize)
+{
+#ifdef HAVE_ZLIB
+  if (m_gzFile != 0)
+    {
+      gzFile file = static_cast<gzFile> (m_gzFile);
+      return gzwrite (file, first, firstSize) == static_cast<int> (firstSize)
+             && (secondSize == 0
+                 || gzwrite (file, second, secondSize) == static_cast<int> (secondSize));
+    }
+#endif
+  struct iovec iov[2];
+  iov[0].iov_base = const_cast<uint8_t *> (first);
+  iov[0].iov_len = firstSize;
+  iov[1].iov_base = const_cast<uint8_t *> (second);
+  iov[1].iov_len = secondSize;
+  struct iovec *vec = iov;
+  int count = secondSize > 0 ? 2 : 1;
+  while (count > 0)
+    {
+      ssize_t written = writev (m_fd, vec, count);
+      if (written < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          return false;
+        }
+      while (count > 0 && static_cast<size_t> (written) >= vec->iov_len)
+        {
+          written -= vec->iov_len;
+          ++vec;
+          --count;
+        }
+      if (count > 0)
+        {
+          vec->iov_base = static_cast<uint8_t *> (vec->iov_base) + written;
+          vec->iov_len -= written;
+        }
+    }
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <string>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Write a file from a background thread.
+ *
+ * Write copies the data into a ring buffer, and a background thread,
+ * shared by all the open writers, does all the file I/O. Each ring has a
+ * single producer and a single consumer, and each side only moves its
+ * own position, so Write takes no lock: it only waits for the background
+ * thread when the ring is full.
+ *
+ * The background thread wakes up every few milliseconds, or when a ring
+ * is half full, and writes all the data available in each ring with a
+ * single writev call, or through zlib when the file is compressed. It
+ * runs while at least one writer is open. Close writes the data left in
+ * the ring from the calling thread.
+ */
+class AsyncFileWriter
+{
+public:
+  /**
+   * Open a file for writing.
+   *
+   * \param filename The file name.
+   * \param bufferSize The size of the ring buffer, rounded up to a power
+   *        of two.
+   * \param compress Whether to write a gzip file.
+   */
+  AsyncFileWriter (std::string filename, uint32_t bufferSize, bool compress);
+  /** Write the buffered data and close the file. */
+  ~AsyncFileWriter ();
+
+  /**
+   * \returns Whether the file could not be opened or written.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Append data to the file.
+   *
+   * \param data The data.
+   * \param size The size of the data, in bytes.
+   */
+  void Write (const void *data, uint32_t size);
+
+  /**
+   * Write the buffered data and close the file. Further writes are
+   * discarded.
+   */
+  void Close (void);
+
+private:
+  /** The body of the background thread. */
+  static void Run (void);
+  /** Wake up the background thread if it waits for data. */
+  static void Wake (void);
+
+  /** Write the data available in the ring buffer to the file. */
+  void Drain (void);
+  /**
+   * Write data to the file.
+   *
+   * \param [in] first The first block of data.
+   * \param [in] firstSize The size of the first block.
+   * \param [in] second The second block of data, following the first one.
+   * \param [in] secondSize The size of the second block, may be 0.
+   * \returns Whether the data was written.
+   */
+  bool WriteFile (const uint8_t *first, uint32_t firstSize,
+                  const uint8_t *second, uint32_t secondSize);
+
+  int m_fd;                  //!< The file descriptor
+  void *m_gzFile;            //!< The zlib stream, or 0 if not compressed
+  uint8_t *m_ring;           //!< The ring buffer
+  uint32_t m_ringSize;       //!< The size of the ring buffer, a power of two
+  uint64_t m_head;           //!< Position of the background thread, which only it moves
+  uint64_t m_tail;           //!< Position of the writer, which only it moves
+  bool m_open;               //!< Whether the background thread writes the file
+  bool m_failed;             //!< Whether the file could not be opened or written
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_WRITER_H */
@@ -0,0 +1,331 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace-file.h"
+#include "ipv4-address.h"
+#include "ns3/abort.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/object.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+namespace {
+
+/** Magic string at the start of the files. */
+const char MAGIC[8] = { 'n', 's', '3', 't', 'r', 'a', 'c', 'e' };
+
+/**
+ * Store an integer in little endian order.
+ * \param [out] data The bytes.
+ * \param [in] value The integer.
+ * \param [in] size The size of the integer, in bytes.
+ */
+void
+Put (uint8_t *data, uint64_t value, uint32_t size)
+{
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      data[i] = value & 0xff;
+      value >>= 8;
+    }
+}
+
+/**
+ * Read an integer in little endian order.
+ * \param [in] data The bytes.
+ * \param [in] size The size of the integer, in bytes.
+ * \returns The integer.
+ */
+uint64_t
+Extract (const uint8_t *data, uint32_t size)
+{
+  uint64_t value = 0;
+  for (uint32_t i = size; i > 0; --i)
+    {
+      value = (value << 8) | data[i - 1];
+    }
+  return value;
+}
+
+/**
+ * Read an integer in network order.
+ * \param [in] data The bytes.
+ * \param [in] size The size of the integer, in bytes.
+ * \returns The integer.
+ */
+uint32_t
+ExtractNetwork (const uint8_t *data, uint32_t size)
+{
+  uint32_t value = 0;
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      value = (value << 8) | data[i];
+    }
+  return value;
+}
+
+/**
+ * Find the IPv4 header of a packet, which may follow a PPP or an
+ * Ethernet header.
+ * \param [in] data The first bytes of the packet.
+ * \param [in] size The number of bytes.
+ * \param [in] packetSize The size of the packet.
+ * \returns The offset of the IPv4 header, or -1.
+ */
+int32_t
+FindIpv4 (const uint8_t *data, uint32_t size, uint32_t packetSize)
+{
+  if (size >= 20 && (data[0] >> 4) == 4 && (data[0] & 0x0f) >= 5
+      && ExtractNetwork (data + 2, 2) <= packetSize)
+    {
+      return 0;
+    }
+  // PPP header with the IPv4 protocol
+  if (size >= 22 && data[0] == 0x00 && data[1] == 0x21 && (data[2] >> 4) == 4)
+    {
+      return 2;
+    }
+  // Ethernet II header with the IPv4 type
+  if (size >= 34 && data[12] == 0x08 && data[13] == 0x00 && (data[14] >> 4) == 4)
+    {
+      return 14;
+    }
+  // Ethernet header followed by a LLC/SNAP header with the IPv4 type
+  if (size >= 42 && data[14] == 0xaa && data[15] == 0xaa
+      && data[20] == 0x08 && data[21] == 0x00 && (data[22] >> 4) == 4)
+    {
+      return 22;
+    }
+  return -1;
+}
+
+} // anonymous namespace
+
+BinaryTraceFile::BinaryTraceFile (std::string filename)
+  : m_records (0),
+    m_lastFlush (std::time (0))
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_buffer.resize (BUFFER_SIZE);
+  m_file.rdbuf ()->pubsetbuf (&m_buffer[0], m_buffer.size ());
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary);
+  FatalImpl::RegisterStream (&m_file);
+  NS_ABORT_MSG_UNLESS (m_file.is_open (), "BinaryTraceFile::BinaryTraceFile():  " <<
+                       "Unable to Open " << filename);
+  uint8_t header[HEADER_SIZE];
+  std::memcpy (header, MAGIC, sizeof (MAGIC));
+  Put (header + 8, VERSION, 4);
+  Put (header + 12, RECORD_SIZE, 4);
+  m_file.write (reinterpret_cast<const char *> (header), HEADER_SIZE);
+  Flush ();
+}
+
+BinaryTraceFile::~BinaryTraceFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  FatalImpl::UnregisterStream (&m_file);
+}
+
+void
+BinaryTraceFile::EnableDevice (Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  uint32_t node = device->GetNode ()->GetId ();
+  uint32_t index = device->GetIfIndex ();
+  PointerValue queue;
+  if (device->GetAttributeFailSafe ("TxQueue", queue) && queue.Get<Object> () != 0)
+    {
+      Ptr<Object> txQueue = queue.Get<Object> ();
+      txQueue->TraceConnectWithoutContext ("Enqueue", MakeBoundCallback (&EnqueueSink, this, node, index));
+      txQueue->TraceConnectWithoutContext ("Dequeue", MakeBoundCallback (&DequeueSink, this, node, index));
+      txQueue->TraceConnectWithoutContext ("Drop", MakeBoundCallback (&DropSink, this, node, index));
+    }
+  device->TraceConnectWithoutContext ("MacRx", MakeBoundCallback (&ReceiveSink, this, node, index));
+}
+
+void
+BinaryTraceFile::Write (uint8_t event, uint32_t node, uint32_t device, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << event << node << device << p);
+  Record record;
+  std::memset (&record, 0, sizeof (record));
+  record.m_time = Simulator::Now ().GetNanoSeconds ();
+  record.m_uid = p->GetUid ();
+  record.m_node = node;
+  record.m_device = device;
+  record.m_size = p->GetSize ();
+  record.m_event = event;
+
+  uint8_t data[64];
+  uint32_t size = p->CopyData (data, sizeof (data));
+  int32_t ip = FindIpv4 (data, size, record.m_size);
+  if (ip >= 0)
+    {
+      record.m_protocol = data[ip + 9];
+      record.m_source = ExtractNetwork (data + ip + 12, 4);
+      record.m_destination = ExtractNetwork (data + ip + 16, 4);
+      uint32_t l4 = ip + (data[ip] & 0x0f) * 4;
+      if ((record.m_protocol == 6 || record.m_protocol == 17) && l4 + 4 <= size)
+        {
+          record.m_sourcePort = ExtractNetwork (data + l4, 2);
+          record.m_destinationPort = ExtractNetwork (data + l4 + 2, 2);
+        }
+    }
+  Write (record);
+}
+
+void
+BinaryTraceFile::Write (const Record &record)
+{
+  uint8_t data[RECORD_SIZE];
+  Put (data, record.m_time, 8);
+  Put (data + 8, record.m_uid, 8);
+  Put (data + 16, record.m_node, 4);
+  Put (data + 20, record.m_device, 4);
+  Put (data + 24, record.m_size, 4);
+  Put (data + 28, record.m_source, 4);
+  Put (data + 32, record.m_destination, 4);
+  Put (data + 36, record.m_sourcePort, 2);
+  Put (data + 38, record.m_destinationPort, 2);
+  data[40] = record.m_event;
+  data[41] = record.m_protocol;
+  std::memset (data + 42, 0, RECORD_SIZE - 42);
+  m_file.write (reinterpret_cast<const char *> (data), RECORD_SIZE);
+
+  // The stream writes the file when its buffer is full; the wall clock
+  // is only read every 64 records
+  if (++m_records % 64 == 0 && std::time (0) != m_lastFlush)
+    {
+      Flush ();
+    }
+}
+
+void
+BinaryTraceFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_file.flush ();
+  m_lastFlush = std::time (0);
+}
+
+bool
+BinaryTraceFile::ReadHeader (std::istream &is)
+{
+  NS_LOG_FUNCTION (&is);
+  uint8_t header[HEADER_SIZE];
+  if (!is.read (reinterpret_cast<char *> (header), HEADER_SIZE))
+    {
+      return false;
+    }
+  return std::memcmp (header, MAGIC, sizeof (MAGIC)) == 0
+         && Extract (header + 8, 4) == VERSION
+         && Extract (header + 12, 4) == RECORD_SIZE;
+}
+
+bool
+BinaryTraceFile::Read (std::istream &is, Record &record)
+{
+  uint8_t data[RECORD_SIZE];
+  if (!is.read (reinterpret_cast<char *> (data), RECORD_SIZE))
+    {
+      return false;
+    }
+  record.m_time = Extract (data, 8);
+  record.m_uid = Extract (data + 8, 8);
+  record.m_node = Extract (data + 16, 4);
+  record.m_device = Extract (data + 20, 4);
+  record.m_size = Extract (data + 24, 4);
+  record.m_source = Extract (data + 28, 4);
+  record.m_destination = Extract (data + 32, 4);
+  record.m_sourcePort = Extract (data + 36, 2);
+  record.m_destinationPort = Extract (data + 38, 2);
+  record.m_event = data[40];
+  record.m_protocol = data[41];
+  return true;
+}
+
+void
+BinaryTraceFile::Print (const Record &record, std::ostream &os)
+{
+  os << record.m_event << " " << NanoSeconds (record.m_time).GetSeconds ()
+     << " /NodeList/" << record.m_node << "/DeviceList/" << record.m_device
+     << " uid " << record.m_uid << " size " << record.m_size;
+  if (record.m_protocol != 0)
+    {
+      os << " protocol " << static_cast<uint32_t> (record.m_protocol) << " "
+         << Ipv4Address (record.m_source) << ":" << record.m_sourcePort << " > "
+         << Ipv4Address (record.m_destination) << ":" << record.m_destinationPort;
+    }
+  os << "\n";
+}
+
+bool
+BinaryTraceFile::ConvertToAscii (std::istream &is, std::ostream &os)
+{
+  NS_LOG_FUNCTION (&is << &os);
+  if (!ReadHeader (is))
+    {
+      return false;
+    }
+  Record record;
+  while (Read (is, record))
+    {
+      Print (record, os);
+    }
+  return true;
+}
+
+void
+BinaryTraceFile::EnqueueSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device,
+                              Ptr<const Packet> p)
+{
+  file->Write ('+', node, device, p);
+}
+
+void
+BinaryTraceFile::DequeueSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device,
+                              Ptr<const Packet> p)
+{
+  file->Write ('-', node, device, p);
+}
+
+void
+BinaryTraceFile::DropSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device,
+                           Ptr<const Packet> p)
+{
+  file->Write ('d', node, device, p);
+}
+
+void
+BinaryTraceFile::ReceiveSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device,
+                              Ptr<const Packet> p)
+{
+  file->Write ('r', node, device, p);
+}
+
+} // namespace ns3
@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+class NetDevice;
+
+/**
+ * \ingroup network
+ *
+ * \brief A compact binary alternative to the ascii traces of the devices.
+ *
+ * Each packet event is written as a fixed size record of RECORD_SIZE
+ * bytes, in little endian order, holding the time, the node and device
+ * indexes, the event, the packet uid and size, and the IPv4 5-tuple of
+ * the packet when it has one. The file stream buffers BUFFER_SIZE
+ * bytes, and writes them when the buffer is full, or when a record is
+ * traced at least one second of wall clock time after the last write.
+ * The records buffered are written by NS_FATAL_ERROR too. The file starts with an 8 bytes magic string, a
+ * version and the size of the records, each on 4 bytes.
+ *
+ * ConvertToAscii prints the records as the lines of the ascii traces
+ * with context, e.g., "+ 1.5 /NodeList/0/DeviceList/1 ...", followed by
+ * the packet summary instead of the packet contents.
+ */
+class BinaryTraceFile : public SimpleRefCount<BinaryTraceFile>
+{
+public:
+  /** Sizes of the file contents. */
+  enum
+  {
+    HEADER_SIZE = 16,        //!< Size of the file header, in bytes
+    RECORD_SIZE = 48,        //!< Size of the records, in bytes
+    BUFFER_SIZE = 1 << 18,   //!< Size of the stream buffer, in bytes
+    VERSION = 1              //!< Version of the format
+  };
+
+  /** A packet event. */
+  struct Record
+  {
+    int64_t m_time;             //!< Time of the event, in nanoseconds
+    uint64_t m_uid;             //!< Packet uid
+    uint32_t m_node;            //!< Node index
+    uint32_t m_device;          //!< Device index in the node
+    uint32_t m_size;            //!< Packet size, in bytes
+    uint32_t m_source;          //!< IPv4 source address, or 0
+    uint32_t m_destination;     //!< IPv4 destination address, or 0
+    uint16_t m_sourcePort;      //!< TCP or UDP source port, or 0
+    uint16_t m_destinationPort; //!< TCP or UDP destination port, or 0
+    uint8_t m_event;            //!< Event, '+', '-', 'd' or 'r' as in the ascii traces
+    uint8_t m_protocol;         //!< IPv4 protocol, or 0
+  };
+
+  /**
+   * Create a trace file.
+   *
+   * \param filename The file name.
+   */
+  BinaryTraceFile (std::string filename);
+  ~BinaryTraceFile ();
+
+  /**
+   * Trace the enqueue, dequeue and drop events of the transmit queue
+   * (the "TxQueue" attribute) and the receive events ("MacRx" trace
+   * source) of a device.
+   *
+   * \param device The device.
+   */
+  void EnableDevice (Ptr<NetDevice> device);
+
+  /**
+   * Write the record of a packet event at the current time.
+   *
+   * \param event The event, '+', '-', 'd' or 'r'.
+   * \param node The node index.
+   * \param device The device index in the node.
+   * \param p The packet, starting with its IPv4, PPP or Ethernet header.
+   */
+  void Write (uint8_t event, uint32_t node, uint32_t device, Ptr<const Packet> p);
+
+  /**
+   * Write a record.
+   *
+   * \param record The record.
+   */
+  void Write (const Record &record);
+
+  /** Write the records buffered by the stream to the file. */
+  void Flush (void);
+
+  /**
+   * Read the header of a trace file.
+   *
+   * \param is The trace file.
+   * \returns Whether the header is valid.
+   */
+  static bool ReadHeader (std::istream &is);
+
+  /**
+   * Read the next record of a trace file.
+   *
+   * \param is The trace file, past its header.
+   * \param record The record read.
+   * \returns Whether a record was read.
+   */
+  static bool Read (std::istream &is, Record &record);
+
+  /**
+   * Print a record as a line of the ascii traces.
+   *
+   * \param record The record.
+   * \param os The output stream.
+   */
+  static void Print (const Record &record, std::ostream &os);
+
+  /**
+   * Print a trace file as ascii traces.
+   *
+   * \param is The trace file.
+   * \param os The output stream.
+   * \returns Whether the file header was valid.
+   */
+  static bool ConvertToAscii (std::istream &is, std::ostream &os);
+
+private:
+  /**
+   * Trace sink of the enqueue events of a device.
+   *
+   * \param file The trace file.
+   * \param node The node index.
+   * \param device The device index in the node.
+   * \param p The packet.
+   */
+  static void EnqueueSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device,
+                           Ptr<const Packet> p);
+  /**
+   * Trace sink of the dequeue events of a device.
+   *
+   * \param file The trace file.
+   * \param node The node index.
+   * \param device The device index in the node.
+   * \param p The packet.
+   */
+  static void DequeueSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device,
+                           Ptr<const Packet> p);
+  /**
+   * Trace sink of the drop events of a device.
+   *
+   * \param file The trace file.
+   * \param node The node index.
+   * \param device The device index in the node.
+   * \param p The packet.
+   */
+  static void DropSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device,
+                        Ptr<const Packet> p);
+  /**
+   * Trace sink of the receive events of a device.
+   *
+   * \param file The trace file.
+   * \param node The node index.
+   * \param device The device index in the node.
+   * \param p The packet.
+   */
+  static void ReceiveSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device,
+                           Ptr<const Packet> p);
+
+  std::vector<char> m_buffer; //!< The buffer of the stream
+  std::ofstream m_file;       //!< The trace file
+  uint32_t m_records;         //!< Number of records written
+  std::time_t m_lastFlush;    //!< Wall clock time of the last write to the file
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
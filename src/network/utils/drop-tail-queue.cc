@@ -57,8 +57,7 @@ TypeId DropTailQueue::GetTypeId (void)
 
 DropTailQueue::DropTailQueue () :
   Queue (),
-  m_packets (),
-  m_bytesInQueue (0)
+  m_packets ()
 {
   NS_LOG_FUNCTION (this);
 }
@@ -87,25 +86,28 @@ DropTailQueue::DoEnqueue (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << p);
 
-  if (m_mode == QUEUE_MODE_PACKETS && (m_packets.size () >= m_maxPackets))
+  if (m_mode == QUEUE_MODE_PACKETS)
     {
-      NS_LOG_LOGIC ("Queue full (at max packets) -- droppping pkt");
-      Drop (p);
-      return false;
+      if (m_packets.GetNPackets () >= m_maxPackets)
+        {
+          NS_LOG_LOGIC ("Queue full (at max packets) -- droppping pkt");
+          Drop (p);
+          return false;
+        }
+      m_packets.Reserve (m_maxPackets);
     }
 
-  if (m_mode == QUEUE_MODE_BYTES && (m_bytesInQueue + p->GetSize () >= m_maxBytes))
+  if (m_mode == QUEUE_MODE_BYTES && (m_packets.GetNBytes () + p->GetSize () >= m_maxBytes))
     {
       NS_LOG_LOGIC ("Queue full (packet would exceed max bytes) -- droppping pkt");
       Drop (p);
       return false;
     }
 
-  m_bytesInQueue += p->GetSize ();
-  m_packets.push (p);
+  m_packets.Push (p);
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
-  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << m_packets.GetNBytes ());
 
   return true;
 }
@@ -115,20 +117,18 @@ DropTailQueue::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       return 0;
     }
 
-  Ptr<Packet> p = m_packets.front ();
-  m_packets.pop ();
-  m_bytesInQueue -= p->GetSize ();
+  Ptr<Packet> p = m_packets.Pop ();
 
   NS_LOG_LOGIC ("Popped " << p);
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
-  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << m_packets.GetNBytes ());
 
   return p;
 }
@@ -138,16 +138,16 @@ DropTailQueue::DoPeek (void) const
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       return 0;
     }
 
-  Ptr<Packet> p = m_packets.front ();
+  Ptr<Packet> p = m_packets.Front ();
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
-  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << m_packets.GetNBytes ());
 
   return p;
 }
@@ -26,11 +26,19 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("OutputStreamWrapper");
 
+const uint32_t OutputStreamWrapper::BUFFER_SIZE;
+
 OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmode filemode)
-  : m_destroyable (true)
+  : m_destroyable (true),
+    m_calls (0),
+    m_lastFlush (std::time (0))
 {
   NS_LOG_FUNCTION (this << filename << filemode);
   std::ofstream* os = new std::ofstream ();
+  // The traces write a line per packet event: write the file by large
+  // blocks rather than by the default few kilobytes
+  m_buffer.resize (BUFFER_SIZE);
+  os->rdbuf ()->pubsetbuf (&m_buffer[0], m_buffer.size ());
   os->open (filename.c_str (), filemode);
   m_ostream = os;
   FatalImpl::RegisterStream (m_ostream);
@@ -39,7 +47,7 @@ OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmo
 }
 
 OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
-  : m_ostream (os), m_destroyable (false)
+  : m_ostream (os), m_destroyable (false), m_calls (0), m_lastFlush (0)
 {
   NS_LOG_FUNCTION (this << os);
   FatalImpl::RegisterStream (m_ostream);
@@ -58,6 +66,12 @@ std::ostream *
 OutputStreamWrapper::GetStream (void)
 {
   NS_LOG_FUNCTION (this);
+  // The wall clock is only read every 64 calls
+  if (m_destroyable && ++m_calls % 64 == 0 && std::time (0) != m_lastFlush)
+    {
+      m_ostream->flush ();
+      m_lastFlush = std::time (0);
+    }
   return m_ostream;
 }
 
@@ -19,7 +19,9 @@
 #ifndef OUTPUT_STREAM_WRAPPER_H
 #define OUTPUT_STREAM_WRAPPER_H
 
+#include <ctime>
 #include <fstream>
+#include <vector>
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
@@ -70,6 +72,14 @@ namespace ns3 {
 class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
 {
 public:
+  /**
+   * Size of the buffer of the files opened by the wrapper, in bytes,
+   * which are written when the buffer is full, when the wrapper is
+   * destroyed, or when GetStream is called at least one second of wall
+   * clock time after the last write.
+   */
+  static const uint32_t BUFFER_SIZE = 1 << 18;
+
   /**
    * Constructor
    * \param filename file name
@@ -86,6 +96,11 @@ public:
   /**
    * Return a pointer to an ostream previously set in the wrapper.
    *
+   * The trace sinks get the stream for each line they write, so the
+   * file opened by the wrapper is flushed here, at most every second
+   * of wall clock time, for the traces to be followed while they are
+   * written.
+   *
    * \see SetStream
    *
    * \returns a pointer to the encapsulated std::ostream
@@ -93,8 +108,11 @@ public:
   std::ostream *GetStream (void);
 
 private:
+  std::vector<char> m_buffer; //!< The buffer of the file opened by the wrapper
   std::ostream *m_ostream; //!< The output stream
   bool m_destroyable; //!< Can be destroyed
+  uint32_t m_calls; //!< Number of calls of GetStream
+  std::time_t m_lastFlush; //!< Wall clock time of the last flush of the file
 };
 
 } // namespace ns3
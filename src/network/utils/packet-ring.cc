@@ -0,0 +1,55 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-ring.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketRing");
+
+const uint32_t PacketRing::MAX_RESERVE;
+
+PacketRing::PacketRing ()
+  : m_head (0),
+    m_nPackets (0),
+    m_nBytes (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PacketRing::Resize (uint32_t capacity)
+{
+  NS_LOG_FUNCTION (this << capacity);
+  NS_ASSERT (capacity >= m_nPackets);
+  std::vector<Ptr<Packet> > ring (capacity);
+  for (uint32_t i = 0; i < m_nPackets; ++i)
+    {
+      uint32_t index = m_head + i;
+      if (index >= m_ring.size ())
+        {
+          index -= m_ring.size ();
+        }
+      ring[i] = m_ring[index];
+    }
+  m_ring.swap (ring);
+  m_head = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_RING_H
+#define PACKET_RING_H
+
+#include <algorithm>
+#include <vector>
+#include "ns3/packet.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup queue
+ *
+ * \brief A FIFO of packets stored in a ring buffer.
+ *
+ * The storage is allocated once, for the capacity given to Reserve,
+ * and only grows, by doubling, when a packet is pushed into a full ring,
+ * so that a queue with a packet limit pushes and pops its packets
+ * without allocating memory. The number of bytes of the packets in the
+ * ring is maintained as they are pushed and popped.
+ */
+class PacketRing
+{
+public:
+  /**
+   * Largest capacity reserved by Reserve, in packets, so that a queue
+   * with a huge limit does not allocate it upfront.
+   */
+  static const uint32_t MAX_RESERVE = 65536;
+
+  PacketRing ();
+
+  /**
+   * Make room for a number of packets, up to MAX_RESERVE.
+   *
+   * \param n The number of packets.
+   */
+  inline void Reserve (uint32_t n);
+  /**
+   * Add a packet at the end of the ring.
+   *
+   * \param p The packet.
+   */
+  inline void Push (Ptr<Packet> p);
+  /**
+   * Remove the packet at the front of the ring, which must not be empty.
+   *
+   * \returns The packet.
+   */
+  inline Ptr<Packet> Pop (void);
+  /**
+   * Get the packet at the front of the ring, which must not be empty.
+   *
+   * \returns The packet.
+   */
+  inline Ptr<Packet> Front (void) const;
+  /**
+   * \returns Whether the ring holds no packet.
+   */
+  inline bool IsEmpty (void) const;
+  /**
+   * \returns The number of packets in the ring.
+   */
+  inline uint32_t GetNPackets (void) const;
+  /**
+   * \returns The number of bytes of the packets in the ring.
+   */
+  inline uint32_t GetNBytes (void) const;
+  /**
+   * \returns The number of packets the ring holds without growing.
+   */
+  inline uint32_t GetCapacity (void) const;
+
+private:
+  /**
+   * Move the packets to a storage of a larger capacity.
+   *
+   * \param capacity The new capacity, which is larger than the number
+   *        of packets.
+   */
+  void Resize (uint32_t capacity);
+
+  std::vector<Ptr<Packet> > m_ring; //!< The storage of the ring
+  uint32_t m_head;                  //!< Index of the front packet
+  uint32_t m_nPackets;              //!< Number of packets
+  uint32_t m_nBytes;                //!< Number of bytes of the packets
+};
+
+} // namespace ns3
+
+namespace ns3 {
+
+void
+PacketRing::Reserve (uint32_t n)
+{
+  n = std::min (n, MAX_RESERVE);
+  if (n > m_ring.size ())
+    {
+      Resize (n);
+    }
+}
+
+void
+PacketRing::Push (Ptr<Packet> p)
+{
+  if (m_nPackets == m_ring.size ())
+    {
+      Resize (std::max<uint32_t> (2 * m_ring.size (), 16));
+    }
+  uint32_t tail = m_head + m_nPackets;
+  if (tail >= m_ring.size ())
+    {
+      tail -= m_ring.size ();
+    }
+  m_nBytes += p->GetSize ();
+  m_ring[tail] = p;
+  m_nPackets++;
+}
+
+Ptr<Packet>
+PacketRing::Pop (void)
+{
+  NS_ASSERT (m_nPackets > 0);
+  Ptr<Packet> p = m_ring[m_head];
+  m_ring[m_head] = 0;
+  if (++m_head == m_ring.size ())
+    {
+      m_head = 0;
+    }
+  m_nPackets--;
+  m_nBytes -= p->GetSize ();
+  return p;
+}
+
+Ptr<Packet>
+PacketRing::Front (void) const
+{
+  NS_ASSERT (m_nPackets > 0);
+  return m_ring[m_head];
+}
+
+bool
+PacketRing::IsEmpty (void) const
+{
+  return m_nPackets == 0;
+}
+
+uint32_t
+PacketRing::GetNPackets (void) const
+{
+  return m_nPackets;
+}
+
+uint32_t
+PacketRing::GetNBytes (void) const
+{
+  return m_nBytes;
+}
+
+uint32_t
+PacketRing::GetCapacity (void) const
+{
+  return m_ring.size ();
+}
+
+} // namespace ns3
+
+#endif /* PACKET_RING_H */
@@ -18,6 +18,7 @@
 
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
@@ -40,6 +41,18 @@ PcapFileWrapper::GetTypeId (void)
                    UintegerValue (PcapFile::SNAPLEN_DEFAULT),
                    MakeUintegerAccessor (&PcapFileWrapper::m_snapLen),
                    MakeUintegerChecker<uint32_t> (0, PcapFile::SNAPLEN_DEFAULT))
+    .AddAttribute ("AsyncBufferSize",
+                   "Size of the ring buffer of the thread writing the file in the "
+                   "background, in bytes, or 0 to write the file synchronously",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_asyncBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Compress",
+                   "Write a gzip compressed file, from the background thread "
+                   "(needs a non zero AsyncBufferSize)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_compress),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -87,6 +100,7 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  m_file.SetAsynchronous (m_asyncBufferSize, m_compress);
   m_file.Open (filename, mode);
 }
 
@@ -215,6 +215,8 @@ public:
 private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
+  uint32_t m_asyncBufferSize; //!< ring buffer size of the background writer, or 0
+  bool m_compress; //!< write a gzip compressed file
 };
 
 } // namespace ns3
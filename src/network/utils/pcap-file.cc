@@ -20,15 +20,21 @@
 
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 #include "ns3/assert.h"
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
 #include "ns3/fatal-impl.h"
+#include "ns3/abort.h"
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "pcap-file.h"
 #include "ns3/log.h"
 #include "ns3/build-profile.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "async-file-writer.h"
+#endif
 //
 // This file is used as part of the ns-3 test framework, so please refrain from 
 // adding any ns-3 specific constructs such as Packet to this file.
@@ -49,7 +55,10 @@ const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pc
 
 PcapFile::PcapFile ()
   : m_file (),
-    m_swapMode (false)
+    m_swapMode (false),
+    m_asyncBufferSize (0),
+    m_compress (false),
+    m_writer (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file);
@@ -67,6 +76,12 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_writer != 0 && m_writer->Fail ())
+    {
+      return true;
+    }
+#endif
   return m_file.fail ();
 }
 bool 
@@ -87,6 +102,19 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_writer != 0)
+    {
+      m_writer->Close ();
+      if (m_writer->Fail ())
+        {
+          m_file.setstate (std::ios::failbit);
+        }
+      delete m_writer;
+      m_writer = 0;
+      return;
+    }
+#endif
   m_file.close ();
 }
 
@@ -198,7 +226,10 @@ PcapFile::WriteFileHeader (void)
   // If we're initializing the file, we need to write the pcap file header
   // at the start of the file.
   //
-  m_file.seekp (0, std::ios::beg);
+  if (m_writer == 0)
+    {
+      m_file.seekp (0, std::ios::beg);
+    }
  
   //
   // We have the ability to write out the pcap file header in a foreign endian
@@ -226,13 +257,14 @@ PcapFile::WriteFileHeader (void)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  WriteData (&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+  WriteData (&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+  WriteData (&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+  WriteData (&headerOut->m_zone, sizeof(headerOut->m_zone));
+  WriteData (&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+  WriteData (&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+  WriteData (&headerOut->m_type, sizeof(headerOut->m_type));
+  EndRecord ();
 }
 
 void
@@ -307,12 +339,39 @@ PcapFile::ReadAndVerifyFileHeader (void)
     }
 }
 
+void
+PcapFile::SetAsynchronous (uint32_t bufferSize, bool compress)
+{
+  NS_LOG_FUNCTION (this << bufferSize << compress);
+  NS_ABORT_MSG_IF (compress && bufferSize == 0, "Compressed files are written in the background");
+  m_asyncBufferSize = bufferSize;
+  m_compress = compress;
+}
+
 void
 PcapFile::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
   NS_ASSERT ((mode & std::ios::app) == 0);
   NS_ASSERT (!m_file.fail ());
+  NS_ASSERT (m_writer == 0);
+
+  if (m_asyncBufferSize > 0 && (mode & std::ios::out) && !(mode & std::ios::in))
+    {
+#ifdef HAVE_PTHREAD_H
+      m_filename = filename;
+      m_writer = new AsyncFileWriter (filename, m_asyncBufferSize, m_compress);
+      if (m_writer->Fail ())
+        {
+          m_file.setstate (std::ios::failbit);
+        }
+      return;
+#else
+      NS_ABORT_MSG_IF (m_compress, "Compressed files need threads");
+      NS_LOG_WARN ("Threads are not available, writing " << filename << " synchronously");
+#endif
+    }
+
   //
   // All pcap files are binary files, so we just do this automatically.
   //
@@ -394,10 +453,10 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
+  WriteData (&header.m_tsSec, sizeof(header.m_tsSec));
+  WriteData (&header.m_tsUsec, sizeof(header.m_tsUsec));
+  WriteData (&header.m_inclLen, sizeof(header.m_inclLen));
+  WriteData (&header.m_origLen, sizeof(header.m_origLen));
   NS_BUILD_DEBUG(m_file.flush());
   return inclLen;
 }
@@ -407,7 +466,8 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
+  WriteData (data, inclLen);
+  EndRecord ();
   NS_BUILD_DEBUG(m_file.flush());
 }
 
@@ -416,6 +476,12 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
+  if (m_writer != 0)
+    {
+      p->CopyData (ReserveData (inclLen), inclLen);
+      EndRecord ();
+      return;
+    }
   p->CopyData (&m_file, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
 }
@@ -432,11 +498,52 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
+  if (m_writer != 0)
+    {
+      uint8_t *data = ReserveData (inclLen);
+      headerBuffer.CopyData (data, toCopy);
+      p->CopyData (data + toCopy, inclLen - toCopy);
+      EndRecord ();
+      return;
+    }
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
   p->CopyData (&m_file, inclLen);
 }
 
+void
+PcapFile::WriteData (const void *data, uint32_t size)
+{
+  if (m_writer != 0)
+    {
+      const uint8_t *bytes = static_cast<const uint8_t *> (data);
+      m_record.insert (m_record.end (), bytes, bytes + size);
+      return;
+    }
+  m_file.write (static_cast<const char *> (data), size);
+}
+
+uint8_t *
+PcapFile::ReserveData (uint32_t size)
+{
+  NS_ASSERT (m_writer != 0 && !m_record.empty ());
+  uint32_t offset = m_record.size ();
+  m_record.resize (offset + size);
+  return &m_record[0] + offset;
+}
+
+void
+PcapFile::EndRecord (void)
+{
+#ifdef HAVE_PTHREAD_H
+  if (m_writer != 0)
+    {
+      m_writer->Write (&m_record[0], m_record.size ());
+      m_record.clear ();
+    }
+#endif
+}
+
 void
 PcapFile::Read (
   uint8_t * const data, 
@@ -23,6 +23,7 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ptr.h"
 
@@ -30,6 +31,7 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class AsyncFileWriter;
 
 
 /**
@@ -62,6 +64,22 @@ public:
    */
   void Clear (void);
 
+  /**
+   * \brief Write the file from a background thread
+   *
+   * Takes effect when the file is next opened for writing only.  The
+   * records are then copied, truncated to the snapshot length, into a
+   * ring buffer, and a background thread writes them to the file, so
+   * that writing a packet does not wait for the disk.  Without threads,
+   * the file is written synchronously.
+   *
+   * \param bufferSize the size of the ring buffer, in bytes, or 0 to
+   *        write the file synchronously
+   * \param compress whether to write a gzip compressed file, which
+   *        needs the background thread and zlib
+   */
+  void SetAsynchronous (uint32_t bufferSize, bool compress);
+
   /**
    * Create a new pcap file or open an existing pcap file.  Semantics are
    * similar to the stdc++ io stream classes, but differ in that
@@ -353,10 +371,32 @@ private:
    */
   void ReadAndVerifyFileHeader (void);
 
+  /**
+   * \brief Write data to the file, or append it to the record for the
+   * background writer
+   * \param data the data
+   * \param size the size of the data
+   */
+  void WriteData (const void *data, uint32_t size);
+  /**
+   * \brief Append space to the record for the background writer
+   * \param size the size of the data
+   * \returns the space for the data
+   */
+  uint8_t *ReserveData (uint32_t size);
+  /**
+   * \brief Pass the record to the background writer, if any
+   */
+  void EndRecord (void);
+
   std::string    m_filename;    //!< file name
   std::fstream   m_file;        //!< file stream
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
+  uint32_t m_asyncBufferSize;   //!< ring buffer size of the background writer, or 0
+  bool m_compress;              //!< compress the file written in the background
+  AsyncFileWriter *m_writer;    //!< background writer, or 0 if writing synchronously
+  std::vector<uint8_t> m_record; //!< record being copied for the background writer
 };
 
 } // namespace ns3
@@ -151,7 +151,6 @@ TypeId RedQueue::GetTypeId (void)
 RedQueue::RedQueue () :
   Queue (),
   m_packets (),
-  m_bytesInQueue (0),
   m_hasRedStarted (false)
 {
   NS_LOG_FUNCTION (this);
@@ -225,12 +224,12 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
   if (GetMode () == QUEUE_MODE_BYTES)
     {
       NS_LOG_DEBUG ("Enqueue in bytes mode");
-      nQueued = m_bytesInQueue;
+      nQueued = m_packets.GetNBytes ();
     }
   else if (GetMode () == QUEUE_MODE_PACKETS)
     {
       NS_LOG_DEBUG ("Enqueue in packets mode");
-      nQueued = m_packets.size ();
+      nQueued = m_packets.GetNPackets ();
     }
 
   // simulate number of packets arrival during idle period
@@ -256,8 +255,8 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
 
   m_qAvg = Estimator (nQueued, m + 1, m_qAvg, m_qW);
 
-  NS_LOG_DEBUG ("\t bytesInQueue  " << m_bytesInQueue << "\tQavg " << m_qAvg);
-  NS_LOG_DEBUG ("\t packetsInQueue  " << m_packets.size () << "\tQavg " << m_qAvg);
+  NS_LOG_DEBUG ("\t bytesInQueue  " << m_packets.GetNBytes () << "\tQavg " << m_qAvg);
+  NS_LOG_DEBUG ("\t packetsInQueue  " << m_packets.GetNPackets () << "\tQavg " << m_qAvg);
 
   m_count++;
   m_countBytes += p->GetSize ();
@@ -323,11 +322,14 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
       return false;
     }
 
-  m_bytesInQueue += p->GetSize ();
-  m_packets.push_back (p);
+  if (GetMode () == QUEUE_MODE_PACKETS)
+    {
+      m_packets.Reserve (m_queueLimit);
+    }
+  m_packets.Push (p);
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
-  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << m_packets.GetNBytes ());
 
   return true;
 }
@@ -597,11 +599,11 @@ RedQueue::GetQueueSize (void)
   NS_LOG_FUNCTION (this);
   if (GetMode () == QUEUE_MODE_BYTES)
     {
-      return m_bytesInQueue;
+      return m_packets.GetNBytes ();
     }
   else if (GetMode () == QUEUE_MODE_PACKETS)
     {
-      return m_packets.size ();
+      return m_packets.GetNPackets ();
     }
   else
     {
@@ -614,7 +616,7 @@ RedQueue::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       m_idle = 1;
@@ -625,14 +627,12 @@ RedQueue::DoDequeue (void)
   else
     {
       m_idle = 0;
-      Ptr<Packet> p = m_packets.front ();
-      m_packets.pop_front ();
-      m_bytesInQueue -= p->GetSize ();
+      Ptr<Packet> p = m_packets.Pop ();
 
       NS_LOG_LOGIC ("Popped " << p);
 
-      NS_LOG_LOGIC ("Number packets " << m_packets.size ());
-      NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+      NS_LOG_LOGIC ("Number packets " << m_packets.GetNPackets ());
+      NS_LOG_LOGIC ("Number bytes " << m_packets.GetNBytes ());
 
       return p;
     }
@@ -642,16 +642,16 @@ Ptr<const Packet>
 RedQueue::DoPeek (void) const
 {
   NS_LOG_FUNCTION (this);
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       return 0;
     }
 
-  Ptr<Packet> p = m_packets.front ();
+  Ptr<Packet> p = m_packets.Front ();
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
-  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << m_packets.GetNBytes ());
 
   return p;
 }
@@ -61,9 +61,9 @@
 #ifndef RED_QUEUE_H
 #define RED_QUEUE_H
 
-#include <queue>
 #include "ns3/packet.h"
 #include "ns3/queue.h"
+#include "ns3/packet-ring.h"
 #include "ns3/nstime.h"
 #include "ns3/boolean.h"
 #include "ns3/data-rate.h"
@@ -78,6 +78,10 @@ class UniformRandomVariable;
  * \ingroup queue
  *
  * \brief A RED packet queue
+ *
+ * The packets are stored in a PacketRing, which is sized to QueueLimit
+ * in the packets mode, so that enqueueing and dequeueing packets does
+ * not allocate memory.
  */
 class RedQueue : public Queue
 {
@@ -233,9 +237,8 @@ private:
   double ModifyP (double p, uint32_t count, uint32_t countBytes,
                   uint32_t meanPktSize, bool wait, uint32_t size);
 
-  std::list<Ptr<Packet> > m_packets; //!< packets in the queue
+  PacketRing m_packets; //!< packets in the queue
 
-  uint32_t m_bytesInQueue; //!< bytes in the queue
   bool m_hasRedStarted; //!< True if RED has started
   Stats m_stats; //!< RED statistics
 
@@ -42,11 +42,36 @@ PointToPointDumbbellHelper::PointToPointDumbbellHelper (uint32_t nLeftLeaf,
                                                         PointToPointHelper rightHelper,
                                                         PointToPointHelper bottleneckHelper)
 {
-  // Create the bottleneck routers
-  m_routers.Create (2);
+  Create (nLeftLeaf, leftHelper, nRightLeaf, rightHelper, bottleneckHelper, 0, 0);
+}
+
+PointToPointDumbbellHelper::PointToPointDumbbellHelper (uint32_t nLeftLeaf,
+                                                        PointToPointHelper leftHelper,
+                                                        uint32_t nRightLeaf,
+                                                        PointToPointHelper rightHelper,
+                                                        PointToPointHelper bottleneckHelper,
+                                                        uint32_t leftSystemId,
+                                                        uint32_t rightSystemId)
+{
+  Create (nLeftLeaf, leftHelper, nRightLeaf, rightHelper, bottleneckHelper, leftSystemId, rightSystemId);
+}
+
+void
+PointToPointDumbbellHelper::Create (uint32_t nLeftLeaf,
+                                    PointToPointHelper leftHelper,
+                                    uint32_t nRightLeaf,
+                                    PointToPointHelper rightHelper,
+                                    PointToPointHelper bottleneckHelper,
+                                    uint32_t leftSystemId,
+                                    uint32_t rightSystemId)
+{
+  // Create the bottleneck routers, in the same order on every system
+  // so that node ids do not depend on the partitioning
+  m_routers.Create (1, leftSystemId);
+  m_routers.Create (1, rightSystemId);
   // Create the leaf nodes
-  m_leftLeaf.Create (nLeftLeaf);
-  m_rightLeaf.Create (nRightLeaf);
+  m_leftLeaf.Create (nLeftLeaf, leftSystemId);
+  m_rightLeaf.Create (nRightLeaf, rightSystemId);
 
   // Add the link connecting routers
   m_routerDevices = bottleneckHelper.Install (m_routers);
@@ -67,6 +67,44 @@ public:
                               PointToPointHelper rightHelper,
                               PointToPointHelper bottleneckHelper);
 
+  /**
+   * Create a PointToPointDumbbellHelper in order to easily create
+   * dumbbell topologies partitioned across the processes of a
+   * distributed simulation
+   *
+   * The left leaf nodes and the left-most router are created on a
+   * system (MPI rank), the right leaf nodes and the right-most router
+   * on another one, so that the bottleneck link is a remote channel
+   * when both systems differ.
+   *
+   * \param nLeftLeaf number of left side leaf nodes in the dumbbell
+   *
+   * \param leftHelper PointToPointHelper used to install the links 
+   *                   between the left leaf nodes and the left-most 
+   *                   router
+   *
+   * \param nRightLeaf number of right side leaf nodes in the dumbbell
+   *
+   * \param rightHelper PointToPointHelper used to install the links 
+   *                    between the right leaf nodes and the right-most 
+   *                    router
+   *
+   * \param bottleneckHelper PointToPointHelper used to install the link 
+   *                         between the inner-routers, usually known as 
+   *                         the bottleneck link
+   *
+   * \param leftSystemId system id of the left side nodes
+   *
+   * \param rightSystemId system id of the right side nodes
+   */
+  PointToPointDumbbellHelper (uint32_t nLeftLeaf,
+                              PointToPointHelper leftHelper,
+                              uint32_t nRightLeaf,
+                              PointToPointHelper rightHelper,
+                              PointToPointHelper bottleneckHelper,
+                              uint32_t leftSystemId,
+                              uint32_t rightSystemId);
+
   ~PointToPointDumbbellHelper ();
 
 public:
@@ -167,6 +205,22 @@ public:
   void      BoundingBox (double ulx, double uly, double lrx, double lry);
 
 private:
+  /**
+   * Create the nodes and links of the dumbbell
+   *
+   * \param nLeftLeaf number of left side leaf nodes
+   * \param leftHelper PointToPointHelper used to install the left side links
+   * \param nRightLeaf number of right side leaf nodes
+   * \param rightHelper PointToPointHelper used to install the right side links
+   * \param bottleneckHelper PointToPointHelper used to install the bottleneck link
+   * \param leftSystemId system id of the left side nodes
+   * \param rightSystemId system id of the right side nodes
+   */
+  void Create (uint32_t nLeftLeaf, PointToPointHelper leftHelper,
+               uint32_t nRightLeaf, PointToPointHelper rightHelper,
+               PointToPointHelper bottleneckHelper,
+               uint32_t leftSystemId, uint32_t rightSystemId);
+
   NodeContainer          m_leftLeaf;            //!< Left Leaf nodes
   NetDeviceContainer     m_leftLeafDevices;     //!< Left Leaf NetDevices
   NodeContainer          m_rightLeaf;           //!< Right Leaf nodes
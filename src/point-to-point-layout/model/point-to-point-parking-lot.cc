@@ -27,6 +27,7 @@
 
 // ns3 includes
 #include "ns3/log.h"
+#include "ns3/assert.h"
 #include "ns3/point-to-point-parking-lot.h"
 
 #include "ns3/node-list.h"
@@ -48,18 +49,48 @@ PointToPointParkingLotHelper::PointToPointParkingLotHelper (uint32_t nLeftLeaf,
                                                             uint32_t nCrossSourceAtEachRouter,
                                                             PointToPointHelper crossHelper,
                                                             PointToPointHelper bottleneckHelper)
+{
+  Create (nLeftLeaf, leftHelper, nRightLeaf, rightHelper, nBottleneck, nCrossSourceAtEachRouter,
+          crossHelper, bottleneckHelper, std::vector<uint32_t> (nBottleneck + 1, 0));
+}
+
+PointToPointParkingLotHelper::PointToPointParkingLotHelper (uint32_t nLeftLeaf,
+                                                            PointToPointHelper leftHelper,
+                                                            uint32_t nRightLeaf,
+                                                            PointToPointHelper rightHelper,
+                                                            uint32_t nBottleneck,
+                                                            uint32_t nCrossSourceAtEachRouter,
+                                                            PointToPointHelper crossHelper,
+                                                            PointToPointHelper bottleneckHelper,
+                                                            std::vector<uint32_t> routerSystemIds)
+{
+  NS_ASSERT_MSG (routerSystemIds.size () == nBottleneck + 1, "One system id per router is required");
+  Create (nLeftLeaf, leftHelper, nRightLeaf, rightHelper, nBottleneck, nCrossSourceAtEachRouter,
+          crossHelper, bottleneckHelper, routerSystemIds);
+}
+
+void
+PointToPointParkingLotHelper::Create (uint32_t nLeftLeaf,
+                                      PointToPointHelper leftHelper,
+                                      uint32_t nRightLeaf,
+                                      PointToPointHelper rightHelper,
+                                      uint32_t nBottleneck,
+                                      uint32_t nCrossSourceAtEachRouter,
+                                      PointToPointHelper crossHelper,
+                                      PointToPointHelper bottleneckHelper,
+                                      const std::vector<uint32_t> &routerSystemIds)
 {
   // Set nRouters to the number of bottleneck links + 1
   uint32_t nRouters = nBottleneck + 1;
 
-  // Create the leaf nodes
-  m_leftLeaf.Create (nLeftLeaf);
-  m_rightLeaf.Create (nRightLeaf);
+  // Create the leaf nodes on the systems of the routers they are attached to
+  m_leftLeaf.Create (nLeftLeaf, routerSystemIds[0]);
+  m_rightLeaf.Create (nRightLeaf, routerSystemIds[nBottleneck]);
 
   // Install point-to-point bottleneck links across nRouters
   for (uint32_t i = 0; i < nRouters; ++i)
     {
-      m_routers.Create (1);
+      m_routers.Create (1, routerSystemIds[i]);
       if (i > 0)
         {
           m_routerDevices.Add (bottleneckHelper.Install (m_routers.Get (i - 1),
@@ -91,8 +122,8 @@ PointToPointParkingLotHelper::PointToPointParkingLotHelper (uint32_t nLeftLeaf,
       NodeContainer crossSource, crossSink;
       NetDeviceContainer crossSourceDevices, crossSinkDevices, routerToCrossSourceDevices, routerToCrossSinkDevices;
 
-      crossSource.Create (nCrossSourceAtEachRouter);
-      crossSink.Create (nCrossSourceAtEachRouter);
+      crossSource.Create (nCrossSourceAtEachRouter, routerSystemIds[i]);
+      crossSink.Create (nCrossSourceAtEachRouter, routerSystemIds[i + 1]);
 
       for (uint32_t j = 0; j < nCrossSourceAtEachRouter; ++j)
         {
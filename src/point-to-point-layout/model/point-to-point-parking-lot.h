@@ -25,6 +25,7 @@
 #define POINT_TO_POINT_PARKING_LOT_HELPER_H
 
 #include <string>
+#include <vector>
 
 #include "point-to-point-helper.h"
 #include "ipv6-address-helper.h"
@@ -81,6 +82,54 @@ public:
                                 PointToPointHelper crossHelper,
                                 PointToPointHelper bottleneckHelper);
 
+  /**
+   * Create a PointToPointParkingLotHelper in order to easily create
+   * parking-lot topologies partitioned across the processes of a
+   * distributed simulation
+   *
+   * Every router is created on the system (MPI rank) given for it.
+   * The left leaf nodes are created on the system of the first router,
+   * the right leaf nodes on the system of the last router, and the
+   * cross-source and cross-sink nodes on the system of the router they
+   * are attached to. The bottleneck links between routers of different
+   * systems are remote channels.
+   *
+   * \param nLeftLeaf number of left side leaf nodes in the parking-lot
+   *
+   * \param leftHelper PointToPointHelper used to install the links
+   *                   between the left leaf nodes and the left-most
+   *                   router
+   *
+   * \param nRightLeaf number of right side leaf nodes in the parking-lot
+   *
+   * \param rightHelper PointToPointHelper used to install the links
+   *                    between the right leaf nodes and the right-most
+   *                    router
+   *
+   * \param nBottleneck number of bottleneck links in the parking-lot
+   *                    between the left leaf nodes and right leaf nodes
+   *
+   * \param nCrossFlowsAtRouter number of cross flows passing through a router
+   *
+   * \param crossHelper PointToPointHelper used to install the link
+   *                    between the router and cross sources
+   *
+   * \param bottleneckHelper PointToPointHelper used to install the link
+   *                         between the inner-routers, usually known as
+   *                         the bottleneck link
+   *
+   * \param routerSystemIds system id of each of the nBottleneck + 1 routers
+   */
+  PointToPointParkingLotHelper (uint32_t nLeftLeaf,
+                                PointToPointHelper leftHelper,
+                                uint32_t nRightLeaf,
+                                PointToPointHelper rightHelper,
+                                uint32_t nBottleneck,
+                                uint32_t nCrossFlowsAtRouter,
+                                PointToPointHelper crossHelper,
+                                PointToPointHelper bottleneckHelper,
+                                std::vector<uint32_t> routerSystemIds);
+
   ~PointToPointParkingLotHelper ();
 
 public:
@@ -295,6 +344,25 @@ public:
   void      AssignIpv6Addresses (Ipv6Address network, Ipv6Prefix prefix);
 
 private:
+  /**
+   * Create the nodes and links of the parking-lot
+   *
+   * \param nLeftLeaf number of left side leaf nodes
+   * \param leftHelper PointToPointHelper used to install the left side links
+   * \param nRightLeaf number of right side leaf nodes
+   * \param rightHelper PointToPointHelper used to install the right side links
+   * \param nBottleneck number of bottleneck links
+   * \param nCrossFlowsAtRouter number of cross flows passing through a router
+   * \param crossHelper PointToPointHelper used to install the cross links
+   * \param bottleneckHelper PointToPointHelper used to install the bottleneck links
+   * \param routerSystemIds system id of each router
+   */
+  void Create (uint32_t nLeftLeaf, PointToPointHelper leftHelper,
+               uint32_t nRightLeaf, PointToPointHelper rightHelper,
+               uint32_t nBottleneck, uint32_t nCrossFlowsAtRouter,
+               PointToPointHelper crossHelper, PointToPointHelper bottleneckHelper,
+               const std::vector<uint32_t> &routerSystemIds);
+
   NodeContainer          m_leftLeaf;                                    //!< Left Leaf nodes
   NetDeviceContainer     m_leftLeafDevices;                             //!< Left Leaf NetDevices
   NodeContainer          m_rightLeaf;                                   //!< Right Leaf nodes
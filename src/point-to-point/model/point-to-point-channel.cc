@@ -22,6 +22,10 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/tag.h"
+
+#include <vector>
 
 namespace ns3 {
 
@@ -50,6 +54,31 @@ PointToPointChannel::GetTypeId (void)
   return tid;
 }
 
+/**
+ * \brief Copy a packet, without sharing any data with it.
+ * \param p The packet.
+ * \returns The copy, with the same uid and packet tags, but no byte tags.
+ */
+static Ptr<Packet>
+DeepCopy (Ptr<const Packet> p)
+{
+  std::vector<uint8_t> buffer (p->GetSerializedSize ());
+  p->Serialize (&buffer[0], buffer.size ());
+  Ptr<Packet> copy = Create<Packet> (&buffer[0], buffer.size (), true);
+  PacketTagIterator i = p->GetPacketTagIterator ();
+  while (i.HasNext ())
+    {
+      PacketTagIterator::Item item = i.Next ();
+      Callback<ObjectBase *> constructor = item.GetTypeId ().GetConstructor ();
+      Tag *tag = dynamic_cast<Tag *> (constructor ());
+      NS_ASSERT (tag != 0);
+      item.GetTag (*tag);
+      copy->AddPacketTag (*tag);
+      delete tag;
+    }
+  return copy;
+}
+
 //
 // By default, you get a channel that 
 // has an "infitely" fast transmission speed and zero delay.
@@ -80,6 +109,19 @@ PointToPointChannel::Attach (Ptr<PointToPointNetDevice> device)
       m_link[1].m_dst = m_link[0].m_src;
       m_link[0].m_state = IDLE;
       m_link[1].m_state = IDLE;
+      // Cached, so that transmitting does not touch the objects of the
+      // receiving node, which may run in another thread
+      for (uint32_t i = 0; i < N_DEVICES; ++i)
+        {
+          Ptr<Node> src = m_link[i].m_src->GetNode ();
+          Ptr<Node> dst = m_link[i].m_dst->GetNode ();
+          if (src == 0 || dst == 0)
+            {
+              continue;
+            }
+          m_link[i].m_dstContext = dst->GetId ();
+          m_link[i].m_crossSystem = src->GetSystemId () != dst->GetSystemId ();
+        }
     }
 }
 
@@ -97,6 +139,16 @@ PointToPointChannel::TransmitStart (
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
+  if (m_link[wire].m_crossSystem)
+    {
+      // The event holds a raw pointer to the device, whose reference
+      // count belongs to the thread of the receiving node.
+      Simulator::ScheduleWithContext (m_link[wire].m_dstContext,
+                                      txTime + m_delay, &PointToPointNetDevice::Receive,
+                                      PeekPointer (m_link[wire].m_dst), DeepCopy (p));
+      return true;
+    }
+
   Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
                                   txTime + m_delay, &PointToPointNetDevice::Receive,
                                   m_link[wire].m_dst, p);
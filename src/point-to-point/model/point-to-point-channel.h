@@ -73,6 +73,14 @@ public:
 
   /**
    * \brief Transmit a packet over this channel
+   *
+   * When the two devices belong to nodes of different system ids, as
+   * for MultithreadedSimulatorImpl, the receiving device gets a deep
+   * copy of the packet, which shares no data with the transmitted one,
+   * since the receiving node may run in another thread. Such a copy keeps
+   * the packet uid and packet tags, but drops the byte tags, and the
+   * TxRxPointToPoint trace is not fired.
+   *
    * \param p Packet to transmit
    * \param src Source PointToPointNetDevice
    * \param txTime Transmit time to apply
@@ -194,11 +202,13 @@ public:
     /** \brief Create the link, it will be in INITIALIZING state
      *
      */
-    Link() : m_state (INITIALIZING), m_src (0), m_dst (0) {}
+    Link() : m_state (INITIALIZING), m_src (0), m_dst (0), m_dstContext (0), m_crossSystem (false) {}
 
-    WireState                  m_state; //!< State of the link
-    Ptr<PointToPointNetDevice> m_src;   //!< First NetDevice
-    Ptr<PointToPointNetDevice> m_dst;   //!< Second NetDevice
+    WireState                  m_state;       //!< State of the link
+    Ptr<PointToPointNetDevice> m_src;         //!< First NetDevice
+    Ptr<PointToPointNetDevice> m_dst;         //!< Second NetDevice
+    uint32_t                   m_dstContext;  //!< Id of the node of the second NetDevice
+    bool                       m_crossSystem; //!< Whether the nodes have different system ids
   };
 
   Link    m_link[N_DEVICES]; //!< Link model
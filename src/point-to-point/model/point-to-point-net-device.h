@@ -330,13 +330,13 @@ private:
    * The trace source fired when packets come into the "top" of the device
    * at the L3/L2 transition, before being queued for transmission.
    */
-  TracedCallback<Ptr<const Packet> > m_macTxTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_macTxTrace;
 
   /**
    * The trace source fired when packets coming into the "top" of the device
    * at the L3/L2 transition are dropped before being queued for transmission.
    */
-  TracedCallback<Ptr<const Packet> > m_macTxDropTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_macTxDropTrace;
 
   /**
    * The trace source fired for packets successfully received by the device
@@ -344,7 +344,7 @@ private:
    * transition).  This is a promiscuous trace (which doesn't mean a lot here
    * in the point-to-point device).
    */
-  TracedCallback<Ptr<const Packet> > m_macPromiscRxTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_macPromiscRxTrace;
 
   /**
    * The trace source fired for packets successfully received by the device
@@ -359,7 +359,7 @@ private:
    * but are dropped before being forwarded up to higher layers (at the L2/L3 
    * transition).
    */
-  TracedCallback<Ptr<const Packet> > m_macRxDropTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_macRxDropTrace;
 
   /**
    * The trace source fired when a packet begins the transmission process on
@@ -371,25 +371,25 @@ private:
    * The trace source fired when a packet ends the transmission process on
    * the medium.
    */
-  TracedCallback<Ptr<const Packet> > m_phyTxEndTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_phyTxEndTrace;
 
   /**
    * The trace source fired when the phy layer drops a packet before it tries
    * to transmit it.
    */
-  TracedCallback<Ptr<const Packet> > m_phyTxDropTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_phyTxDropTrace;
 
   /**
    * The trace source fired when a packet begins the reception process from
    * the medium -- when the simulated first bit(s) arrive.
    */
-  TracedCallback<Ptr<const Packet> > m_phyRxBeginTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_phyRxBeginTrace;
 
   /**
    * The trace source fired when a packet ends the reception process from
    * the medium.
    */
-  TracedCallback<Ptr<const Packet> > m_phyRxEndTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_phyRxEndTrace;
 
   /**
    * The trace source fired when the phy layer drops a packet it has received.
@@ -414,7 +414,7 @@ private:
    * this would correspond to the point at which the packet is dispatched to 
    * packet sniffers in \c netif_receive_skb.
    */
-  TracedCallback<Ptr<const Packet> > m_snifferTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_snifferTrace;
 
   /**
    * A trace source that emulates a promiscuous mode protocol sniffer connected
@@ -18,11 +18,16 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <vector>
+
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -93,6 +98,130 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test of a PointToPointChannel between nodes run by different
+ * threads of MultithreadedSimulatorImpl
+ *
+ * Each node sends packets to the other one, which must receive them in
+ * its own thread after the transmission time and the channel delay.
+ */
+class PointToPointMultithreadedTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointMultithreadedTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send a packet of 998 bytes, 1000 bytes with the PPP header
+   *
+   * \param device NetDevice to send from
+   */
+  void SendPacket (Ptr<PointToPointNetDevice> device);
+
+  /**
+   * \brief Receive a packet
+   *
+   * \param device NetDevice receiving the packet
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  Ptr<NetDevice> m_devices[2];          //!< The devices
+  std::vector<Time> m_rxTimes[2];       //!< Receive times of each device
+  std::vector<uint32_t> m_rxSystems[2]; //!< System ids of the threads receiving on each device
+};
+
+PointToPointMultithreadedTest::PointToPointMultithreadedTest ()
+  : TestCase ("PointToPoint across threads")
+{
+}
+
+void
+PointToPointMultithreadedTest::SendPacket (Ptr<PointToPointNetDevice> device)
+{
+  Ptr<Packet> p = Create<Packet> (998);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointMultithreadedTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  // Each vector is only accessed by the thread of its device
+  uint32_t i = (device == m_devices[0]) ? 0 : 1;
+  m_rxTimes[i].push_back (Simulator::Now ());
+  m_rxSystems[i].push_back (Simulator::GetSystemId ());
+  return true;
+}
+
+void
+PointToPointMultithreadedTest::DoRun (void)
+{
+  TypeId tid;
+  if (!TypeId::LookupByNameFailSafe ("ns3::MultithreadedSimulatorImpl", &tid))
+    {
+      // Built without threads
+      return;
+    }
+  ObjectFactory factory;
+  factory.SetTypeId (tid);
+  factory.Set ("ThreadCount", UintegerValue (2));
+  Simulator::SetImplementation (factory.Create<SimulatorImpl> ());
+
+  Ptr<Node> a = CreateObject<Node> (0);
+  Ptr<Node> b = CreateObject<Node> (1);
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (10)));
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetDataRate (DataRate ("8Mbps"));
+  devA->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+  devB->SetDataRate (DataRate ("8Mbps"));
+  devB->Attach (channel);
+  m_devices[0] = devA;
+  m_devices[1] = devB;
+  devA->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedTest::Receive, this));
+  devB->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedTest::Receive, this));
+
+  // Two back to back packets from a, and one from b at the same time
+  Simulator::ScheduleWithContext (a->GetId (), Seconds (1.0), &PointToPointMultithreadedTest::SendPacket, this, devA);
+  Simulator::ScheduleWithContext (a->GetId (), Seconds (1.0), &PointToPointMultithreadedTest::SendPacket, this, devA);
+  Simulator::ScheduleWithContext (b->GetId (), Seconds (1.0), &PointToPointMultithreadedTest::SendPacket, this, devB);
+
+  Simulator::Run ();
+
+  // 1000 bytes take 1 ms at 8 Mbps
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[1].size (), 2, "Wrong number of packets received by b");
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[1][0], MilliSeconds (1011), "Wrong receive time");
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[1][1], MilliSeconds (1012), "Wrong receive time");
+  NS_TEST_ASSERT_MSG_EQ (m_rxSystems[1][0], 1, "Packet received by the wrong thread");
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[0].size (), 1, "Wrong number of packets received by a");
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[0][0], MilliSeconds (1011), "Wrong receive time");
+  NS_TEST_ASSERT_MSG_EQ (m_rxSystems[0][0], 0, "Packet received by the wrong thread");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), MilliSeconds (1012), "Wrong time at the end of the simulation");
+
+  m_devices[0] = 0;
+  m_devices[1] = 0;
+  Simulator::Destroy ();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -109,6 +238,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointMultithreadedTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -23,6 +23,7 @@
 // creates a dumbbell scenario.
 
 #include "ns3/core-module.h"
+#include "ns3/mpi-interface.h"
 #include "ns3/configure-topology.h"
 #include "ns3/traffic-parameters.h"
 #include "ns3/dumbbell-topology.h"
@@ -49,6 +50,7 @@ main (int argc, char *argv[])
   uint32_t      nRevStreamingFlows = 5;
   double        streamingRate = 640;
   double        simTime = 100;
+  double        samplingInterval = 1;
   uint32_t      streamingPacketSize = 840;
   bool          useAqm = false;
   Time          simulationTime;
@@ -56,9 +58,25 @@ main (int argc, char *argv[])
   // Set default TCP variant
   std::string tcp_variant = "TcpNewReno";
 
+  // Default filename to stream the bottleneck metrics, empty to disable
+  std::string timeSeriesFileName = "";
+
+  // Default filename to store per-flow statistics, empty to disable
+  std::string flowStatsFileName = "";
+
   // Default filename to store results
   std::string fileName = "TcpEvalDumbbell";
 
+  // Partition the topology across MPI processes, with the granted time
+  // window or the null message synchronization
+  bool          distributed = false;
+  bool          nullmsg = false;
+
+  // Partition the topology across threads of this process
+  uint32_t      threads = 1;
+
+  ConfigureTopology::SetDefaults ();
+
   // Allow the user to change values by command line arguments
   CommandLine cmd;
   cmd.AddValue ("bottleneckBandwidth", "Bandwidth of bottleneck link in Mbps", bottleneckBandwidth);
@@ -73,10 +91,34 @@ main (int argc, char *argv[])
   cmd.AddValue ("streamingPacketSize", "Packet size of streaming flows in bytes", streamingPacketSize);
   cmd.AddValue ("useAqm", "Enable or disable AQM in routers", useAqm);
   cmd.AddValue ("simulationTime", "Total simulation time in seconds", simTime);
+  cmd.AddValue ("samplingInterval", "Interval in seconds at which bottleneck metrics are sampled", samplingInterval);
   cmd.AddValue ("tcp_variant", "Change the TCP variant", tcp_variant);
   cmd.AddValue ("fileName", "File to store the results", fileName);
+  cmd.AddValue ("flowStatsFileName", "File to store the per-flow statistics of FTP flows", flowStatsFileName);
+  cmd.AddValue ("timeSeriesFileName", "CSV file to stream every sample of the bottleneck metrics", timeSeriesFileName);
+  cmd.AddValue ("distributed", "Partition the topology across MPI processes", distributed);
+  cmd.AddValue ("nullmsg", "Use the null message synchronization in distributed simulations", nullmsg);
+  cmd.AddValue ("threads", "Number of threads the topology is partitioned across", threads);
   cmd.Parse (argc, argv);
 
+  if (distributed)
+    {
+      if (nullmsg)
+        {
+          GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::NullMessageSimulatorImpl"));
+        }
+      else
+        {
+          GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DistributedSimulatorImpl"));
+        }
+      MpiInterface::Enable (&argc, &argv);
+    }
+  else if (threads > 1)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+      Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (threads));
+    }
+
   // Convert time from double to seconds
   rttp = Time::FromDouble (rtt, Time::S);
   rttDifference = Time::FromDouble (rttDiff, Time::S);
@@ -86,6 +128,7 @@ main (int argc, char *argv[])
   Config::SetDefault ("ns3::ConfigureTopology::BottleneckBandwidth", DoubleValue (bottleneckBandwidth));
   Config::SetDefault ("ns3::ConfigureTopology::RTTP", TimeValue (rttp));
   Config::SetDefault ("ns3::ConfigureTopology::RttDiff", TimeValue (rttDifference));
+  Config::SetDefault ("ns3::ConfigureTopology::FlowStatsFileName", StringValue (flowStatsFileName));
 
   // Set traffic parameters
   Config::SetDefault ("ns3::TrafficParameters::FwdFtpFlows", UintegerValue (nFwdFtpFlows));
@@ -98,31 +141,12 @@ main (int argc, char *argv[])
   Config::SetDefault ("ns3::TrafficParameters::UseAqm", BooleanValue (useAqm));
   Config::SetDefault ("ns3::TrafficParameters::SimulationTime", TimeValue (simulationTime));
 
+  // Set statistics parameters
+  Config::SetDefault ("ns3::EvalStats::SamplingInterval", TimeValue (Time::FromDouble (samplingInterval, Time::S)));
+  Config::SetDefault ("ns3::EvalStats::TimeSeriesFileName", StringValue (timeSeriesFileName));
+
   // Set TCP variant
-  if (tcp_variant.compare ("TcpTahoe") == 0)
-    {
-      Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpTahoe::GetTypeId ()));
-    }
-  else if (tcp_variant.compare ("TcpReno") == 0)
-    {
-      Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpReno::GetTypeId ()));
-    }
-  else if (tcp_variant.compare ("TcpNewReno") == 0)
-    {
-      Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpNewReno::GetTypeId ()));
-    }
-  else if (tcp_variant.compare ("TcpWestwood") == 0)
-    { // the default protocol type in ns3::TcpWestwood is WESTWOOD
-      Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpWestwood::GetTypeId ()));
-      Config::SetDefault ("ns3::TcpWestwood::FilterType", EnumValue (TcpWestwood::TUSTIN));
-    }
-  else if (tcp_variant.compare ("TcpWestwoodPlus") == 0)
-    {
-      Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpWestwood::GetTypeId ()));
-      Config::SetDefault ("ns3::TcpWestwood::ProtocolType", EnumValue (TcpWestwood::WESTWOODPLUS));
-      Config::SetDefault ("ns3::TcpWestwood::FilterType", EnumValue (TcpWestwood::TUSTIN));
-    }
-  else
+  if (!ConfigureTopology::SetTcpVariant (tcp_variant))
     {
       NS_LOG_DEBUG ("Invalid TCP version");
       exit (1);
@@ -130,10 +154,13 @@ main (int argc, char *argv[])
 
   Ptr<TrafficParameters> trafficParams = CreateObject <TrafficParameters> ();
   Ptr<DumbbellTopology> dumbbell = CreateObject<DumbbellTopology> ();
+  // The topology runs and destroys the simulation
   dumbbell->CreateDumbbellTopology (trafficParams, fileName);
 
-  Simulator::Run ();
-  Simulator::Destroy ();
+  if (distributed)
+    {
+      MpiInterface::Disable ();
+    }
 
   return 0;
 }
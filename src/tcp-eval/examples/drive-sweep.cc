@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This example is a part of TCP evaluation suite and runs a sweep of
+// dumbbell or parking-lot scenarios in parallel.
+//
+// The tcpVariants, rttp, bottleneckBandwidth and nFwdFtpFlows arguments
+// take comma separated lists. For example,
+//
+// ./waf --run "drive-sweep --topology=ParkingLot --rttp=0.01,0.02,0.05
+//              --tcpVariants=TcpReno,TcpNewReno --jobs=8 --fileName=rttp"
+//
+// runs six simulations on eight worker processes and writes the results
+// to rttp.TcpReno and rttp.TcpNewReno.
+
+#include <sstream>
+
+#include "ns3/core-module.h"
+#include "ns3/configure-topology.h"
+#include "ns3/traffic-parameters.h"
+#include "ns3/parameter-sweep.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpEvalSweepExample");
+
+// Splits a comma separated list into its items
+static std::vector<std::string>
+SplitList (std::string list)
+{
+  std::vector<std::string> items;
+  std::istringstream stream (list);
+  std::string item;
+  while (std::getline (stream, item, ','))
+    {
+      if (!item.empty ())
+        {
+          items.push_back (item);
+        }
+    }
+  return items;
+}
+
+template <typename T>
+static T
+FromString (std::string item)
+{
+  T value;
+  std::istringstream stream (item);
+  stream >> value;
+  return value;
+}
+
+int
+main (int argc, char *argv[])
+{
+  // Set default values for topology
+  std::string   topology = "Dumbbell";
+  double        rttDiff = 0.0;
+  double        crsLinkDelay = 0.01;
+  Time          rttDifference;
+  Time          crossLinkDelay;
+
+  // Set default values for traffic
+  uint32_t      nRevFtpFlows = 5;
+  uint32_t      nCrossFtpFlows = 5;
+  uint32_t      nVoiceFlows = 5;
+  uint32_t      nFwdStreamingFlows = 5;
+  uint32_t      nRevStreamingFlows = 5;
+  double        streamingRate = 640;
+  double        simTime = 100;
+  double        samplingInterval = 1;
+  uint32_t      streamingPacketSize = 840;
+  bool          useAqm = false;
+  Time          simulationTime;
+
+  // Swept parameters. Empty lists keep the default value.
+  std::string   tcpVariants = "TcpNewReno";
+  std::string   rttps = "";
+  std::string   bottleneckBandwidths = "";
+  std::string   nFwdFtpFlows = "";
+
+  // Number of simulations run at the same time, 0 for one per processor
+  uint32_t      jobs = 0;
+
+  // Default filename prefix to store results
+  std::string fileName = "TcpEvalSweep";
+
+  ConfigureTopology::SetDefaults ();
+
+  // Allow the user to change values by command line arguments
+  CommandLine cmd;
+  cmd.AddValue ("topology", "Topology to simulate (Dumbbell or ParkingLot)", topology);
+  cmd.AddValue ("tcpVariants", "Comma separated list of TCP variants", tcpVariants);
+  cmd.AddValue ("rttp", "Comma separated list of round trip propagation delays in seconds", rttps);
+  cmd.AddValue ("bottleneckBandwidth", "Comma separated list of bottleneck bandwidths in Mbps", bottleneckBandwidths);
+  cmd.AddValue ("nFwdFtpFlows", "Comma separated list of numbers of FTP flows on forward path", nFwdFtpFlows);
+  cmd.AddValue ("rttDifference", "Flow RTT difference in seconds", rttDiff);
+  cmd.AddValue ("nRevFtpFlows", "Number of FTP flows on reverse path", nRevFtpFlows);
+  cmd.AddValue ("nCrossFtpFlows", "Number of cross FTP flows", nCrossFtpFlows);
+  cmd.AddValue ("nVoiceFlows", "Number of two-way voice flows", nVoiceFlows);
+  cmd.AddValue ("nFwdStreamingFlows", "Number of streaming flows on forward path", nFwdStreamingFlows);
+  cmd.AddValue ("nRevStreamingFlows", "Number of streaming flows on reverse path", nRevStreamingFlows);
+  cmd.AddValue ("streamingRate", "Bit rate of streaming flows in Kbps", streamingRate);
+  cmd.AddValue ("streamingPacketSize", "Packet size of streaming flows in bytes", streamingPacketSize);
+  cmd.AddValue ("useAqm", "Enable or disable AQM in routers", useAqm);
+  cmd.AddValue ("crossLinkDelay", "Cross link delay in seconds", crsLinkDelay);
+  cmd.AddValue ("simulationTime", "Total simulation time in seconds", simTime);
+  cmd.AddValue ("samplingInterval", "Interval in seconds at which bottleneck metrics are sampled", samplingInterval);
+  cmd.AddValue ("jobs", "Number of simulations run in parallel, 0 for one per processor", jobs);
+  cmd.AddValue ("fileName", "Prefix of the files to store the results", fileName);
+  cmd.Parse (argc, argv);
+
+  // Convert time from double to seconds
+  rttDifference = Time::FromDouble (rttDiff, Time::S);
+  simulationTime = Time::FromDouble (simTime, Time::S);
+  crossLinkDelay = Time::FromDouble (crsLinkDelay, Time::S);
+
+  // Set topology parameters
+  Config::SetDefault ("ns3::ConfigureTopology::RttDiff", TimeValue (rttDifference));
+  Config::SetDefault ("ns3::ParkingLotTopology::CrossLinkDelay", TimeValue (crossLinkDelay));
+
+  // Set traffic parameters
+  Config::SetDefault ("ns3::TrafficParameters::RevFtpFlows", UintegerValue (nRevFtpFlows));
+  Config::SetDefault ("ns3::TrafficParameters::CrossFtpFlows", UintegerValue (nCrossFtpFlows));
+  Config::SetDefault ("ns3::TrafficParameters::NumOfVoiceFlows", UintegerValue (nVoiceFlows));
+  Config::SetDefault ("ns3::TrafficParameters::FwdStreamingFlows", UintegerValue (nFwdStreamingFlows));
+  Config::SetDefault ("ns3::TrafficParameters::RevStreamingFlows", UintegerValue (nRevStreamingFlows));
+  Config::SetDefault ("ns3::TrafficParameters::StreamingRate", DoubleValue (streamingRate));
+  Config::SetDefault ("ns3::TrafficParameters::StreamingPacketSize", UintegerValue (streamingPacketSize));
+  Config::SetDefault ("ns3::TrafficParameters::UseAqm", BooleanValue (useAqm));
+  Config::SetDefault ("ns3::TrafficParameters::SimulationTime", TimeValue (simulationTime));
+
+  // Set statistics parameters
+  Config::SetDefault ("ns3::EvalStats::SamplingInterval", TimeValue (Time::FromDouble (samplingInterval, Time::S)));
+
+  Ptr<ParameterSweep> sweep = CreateObject<ParameterSweep> ();
+  sweep->SetAttribute ("Topology", StringValue (topology));
+  sweep->SetAttribute ("MaxJobs", UintegerValue (jobs));
+
+  std::vector<std::string> items = SplitList (tcpVariants);
+  for (uint32_t i = 0; i < items.size (); ++i)
+    {
+      sweep->AddTcpVariant (items[i]);
+    }
+  items = SplitList (rttps);
+  for (uint32_t i = 0; i < items.size (); ++i)
+    {
+      sweep->AddRttp (Time::FromDouble (FromString<double> (items[i]), Time::S));
+    }
+  items = SplitList (bottleneckBandwidths);
+  for (uint32_t i = 0; i < items.size (); ++i)
+    {
+      sweep->AddBottleneckBandwidth (FromString<double> (items[i]));
+    }
+  items = SplitList (nFwdFtpFlows);
+  for (uint32_t i = 0; i < items.size (); ++i)
+    {
+      sweep->AddNumOfFwdFtpFlows (FromString<uint32_t> (items[i]));
+    }
+
+  uint32_t nFailed = sweep->Run (fileName);
+  if (nFailed > 0)
+    {
+      NS_LOG_DEBUG (nFailed << " simulations did not complete");
+      return 1;
+    }
+
+  return 0;
+}
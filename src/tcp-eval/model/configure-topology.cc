@@ -24,6 +24,8 @@
 #include "configure-topology.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/internet-module.h"
+#include "ns3/mpi-interface.h"
 
 namespace ns3 {
 
@@ -56,6 +58,11 @@ ConfigureTopology::GetTypeId (void)
                    TimeValue (Seconds (0)),
                    MakeTimeAccessor (&ConfigureTopology::m_rttDifference),
                    MakeTimeChecker ())
+    .AddAttribute ("FlowStatsFileName",
+                   "File to store the per-flow statistics of FTP flows. Empty disables them",
+                   StringValue (""),
+                   MakeStringAccessor (&ConfigureTopology::m_flowStatsFileName),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -108,6 +115,73 @@ ConfigureTopology::SetRedParameters ()
   Config::SetDefault ("ns3::RedQueue::QueueLimit", UintegerValue (m_bottleneckBuffer));
 }
 
+bool
+ConfigureTopology::SetTcpVariant (std::string tcpVariant)
+{
+  if (tcpVariant.compare ("TcpTahoe") == 0)
+    {
+      Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpTahoe::GetTypeId ()));
+    }
+  else if (tcpVariant.compare ("TcpReno") == 0)
+    {
+      Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpReno::GetTypeId ()));
+    }
+  else if (tcpVariant.compare ("TcpNewReno") == 0)
+    {
+      Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpNewReno::GetTypeId ()));
+    }
+  else if (tcpVariant.compare ("TcpWestwood") == 0)
+    { // the default protocol type in ns3::TcpWestwood is WESTWOOD
+      Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpWestwood::GetTypeId ()));
+      Config::SetDefault ("ns3::TcpWestwood::ProtocolType", EnumValue (TcpWestwood::WESTWOOD));
+      Config::SetDefault ("ns3::TcpWestwood::FilterType", EnumValue (TcpWestwood::TUSTIN));
+    }
+  else if (tcpVariant.compare ("TcpWestwoodPlus") == 0)
+    {
+      Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpWestwood::GetTypeId ()));
+      Config::SetDefault ("ns3::TcpWestwood::ProtocolType", EnumValue (TcpWestwood::WESTWOODPLUS));
+      Config::SetDefault ("ns3::TcpWestwood::FilterType", EnumValue (TcpWestwood::TUSTIN));
+    }
+  else
+    {
+      return false;
+    }
+  return true;
+}
+
+void
+ConfigureTopology::SetDefaults (void)
+{
+  Config::SetDefault ("ns3::Ipv4L3Protocol::RouteCache", BooleanValue (true));
+}
+
+bool
+ConfigureTopology::IsLocal (Ptr<Node> node)
+{
+  return !MpiInterface::IsEnabled () || node->GetSystemId () == MpiInterface::GetSystemId ();
+}
+
+bool
+ConfigureTopology::IsPartitioned (void)
+{
+  return MpiInterface::IsEnabled () && MpiInterface::GetSize () > 1;
+}
+
+uint32_t
+ConfigureTopology::GetSystemCount (void)
+{
+  if (MpiInterface::IsEnabled ())
+    {
+      return MpiInterface::GetSize ();
+    }
+  UintegerValue threadCount;
+  if (Simulator::GetImplementation ()->GetAttributeFailSafe ("ThreadCount", threadCount))
+    {
+      return threadCount.Get ();
+    }
+  return 1;
+}
+
 void
 ConfigureTopology::SetBottleneckBandwidth (double bottleneckBandwidth)
 {
@@ -73,6 +73,57 @@ public:
    */
   void SetRedParameters ();
 
+  /**
+   * \brief Sets the TCP variant used by all TCP sockets created afterwards.
+   *
+   * Valid variants are TcpTahoe, TcpReno, TcpNewReno, TcpWestwood and
+   * TcpWestwoodPlus.
+   *
+   * \param tcpVariant Name of the TCP variant
+   * \return false if the TCP variant is unknown, true otherwise
+   */
+  static bool SetTcpVariant (std::string tcpVariant);
+
+  /**
+   * \brief Sets the attribute defaults shared by the tcp-eval simulations.
+   *
+   * The routers forward with the routes they cached, since the global
+   * routes do not change. This is called before parsing the command
+   * line, so that the defaults can be overridden, e.g., with
+   * --ns3::Ipv4L3Protocol::RouteCache=false.
+   */
+  static void SetDefaults (void);
+
+  /**
+   * \brief Checks whether a node is simulated by this process.
+   *
+   * In a distributed simulation, the topologies are partitioned across
+   * systems (MPI ranks) and every process only installs applications
+   * and statistics on the nodes of its own system.
+   *
+   * \param node The node
+   * \return false if the simulation is distributed and the node belongs
+   *         to another system, true otherwise
+   */
+  static bool IsLocal (Ptr<Node> node);
+
+  /**
+   * \brief Checks whether the simulation is distributed across several systems.
+   *
+   * \return true if MPI is enabled with more than one system
+   */
+  static bool IsPartitioned (void);
+
+  /**
+   * \brief Get the number of systems the topologies are partitioned across.
+   *
+   * These are the MPI ranks of a distributed simulation, or the threads of
+   * MultithreadedSimulatorImpl, whose nodes are assigned by system id.
+   *
+   * \return the number of systems, 1 for a sequential simulation
+   */
+  static uint32_t GetSystemCount (void);
+
   /**
    * \brief Set the bandwidth of bottleneck links in Mbps
    *
@@ -183,6 +234,7 @@ protected:
   Time     m_nonBottleneckDelay;        //!< Delay of non-bottleneck link in seconds
   uint32_t m_nonBottleneckBuffer;       //!< Size of the non-bottleneck buffer
   double   m_bottleneckBufferBdp;       //!< Bandwidth-Delay Product for the bottleneck link
+  std::string m_flowStatsFileName;      //!< File to store per-flow statistics, empty to disable
 };
 }
 
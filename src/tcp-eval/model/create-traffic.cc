@@ -24,6 +24,7 @@
 #include <iostream>
 
 #include "create-traffic.h"
+#include "configure-topology.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/core-module.h"
@@ -39,6 +40,27 @@ NS_LOG_COMPONENT_DEFINE ("CreateTraffic");
 
 NS_OBJECT_ENSURE_REGISTERED (CreateTraffic);
 
+/**
+ * \brief Install an application on a node simulated by this process
+ *
+ * In a distributed simulation, applications are only installed on the
+ * nodes of the local system, so that every flow is generated once.
+ *
+ * \param helper The application helper
+ * \param node The node
+ * \return the application, or an empty container if the node is remote
+ */
+template <typename T>
+static ApplicationContainer
+InstallOnLocalNode (const T &helper, Ptr<Node> node)
+{
+  if (!ConfigureTopology::IsLocal (node))
+    {
+      return ApplicationContainer ();
+    }
+  return helper.Install (node);
+}
+
 TypeId
 CreateTraffic::GetTypeId (void)
 {
@@ -66,6 +88,12 @@ CreateTraffic::GetRandomValue (void) const
   return m_randVar->GetValue ();
 }
 
+void
+CreateTraffic::SetFlowStats (Ptr<FlowStats> flowStats)
+{
+  m_flowStats = flowStats;
+}
+
 void
 CreateTraffic::CreateFwdFtpTraffic (PointToPointDumbbellHelper dumbbell, uint32_t flows,
                                     uint32_t offset, Ptr<TrafficParameters> traffic)
@@ -84,20 +112,27 @@ CreateTraffic::CreateFwdFtpTraffic (PointToPointDumbbellHelper dumbbell, uint32_
       BulkSendHelper ftp ("ns3::TcpSocketFactory", Address ());
       ftp.SetAttribute ("Remote", remoteAddress);
       ftp.SetAttribute ("MaxBytes", UintegerValue (0));
+      ftp.SetAttribute ("VirtualPayload", BooleanValue (true));
 
       // Both source and sink apps are added to a single ApplicationContainer.
       // This is done to avoid the case when source starts before sink or
       // vice-versa due to random time generation.
       ApplicationContainer sourceAndSinkApp;
-      sourceAndSinkApp.Add (ftp.Install (dumbbell.GetLeft (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (ftp, dumbbell.GetLeft (i)));
 
       PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (dumbbell.GetRightIpv4Address (i), port1));
 
       sinkHelper.SetAttribute ("Protocol", TypeIdValue (TcpSocketFactory::GetTypeId ()));
-      sourceAndSinkApp.Add (sinkHelper.Install (dumbbell.GetRight (i)));
+      sinkHelper.SetAttribute ("VirtualPayload", BooleanValue (true));
+      sourceAndSinkApp.Add (InstallOnLocalNode (sinkHelper, dumbbell.GetRight (i)));
 
       sourceAndSinkApp.Start (Seconds (GetRandomValue ()));
       sourceAndSinkApp.Stop (traffic->GetSimulationTime ());
+
+      if (m_flowStats != 0)
+        {
+          m_flowStats->AddFlow (sourceAndSinkApp.Get (0), sourceAndSinkApp.Get (1));
+        }
     }
 }
 
@@ -119,20 +154,27 @@ CreateTraffic::CreateRevFtpTraffic (PointToPointDumbbellHelper dumbbell, uint32_
       BulkSendHelper ftp ("ns3::TcpSocketFactory", Address ());
       ftp.SetAttribute ("Remote", remoteAddress);
       ftp.SetAttribute ("MaxBytes", UintegerValue (0));
+      ftp.SetAttribute ("VirtualPayload", BooleanValue (true));
 
       // Both source and sink apps are added to a single ApplicationContainer.
       // This is done to avoid the case when source starts before sink or
       // vice-versa due to random time generation.
       ApplicationContainer sourceAndSinkApp;
-      sourceAndSinkApp.Add (ftp.Install (dumbbell.GetRight (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (ftp, dumbbell.GetRight (i)));
 
       PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (dumbbell.GetLeftIpv4Address (i), port1));
 
       sinkHelper.SetAttribute ("Protocol", TypeIdValue (TcpSocketFactory::GetTypeId ()));
-      sourceAndSinkApp.Add (sinkHelper.Install (dumbbell.GetLeft (i)));
+      sinkHelper.SetAttribute ("VirtualPayload", BooleanValue (true));
+      sourceAndSinkApp.Add (InstallOnLocalNode (sinkHelper, dumbbell.GetLeft (i)));
 
       sourceAndSinkApp.Start (Seconds (GetRandomValue ()));
       sourceAndSinkApp.Stop (traffic->GetSimulationTime ());
+
+      if (m_flowStats != 0)
+        {
+          m_flowStats->AddFlow (sourceAndSinkApp.Get (0), sourceAndSinkApp.Get (1));
+        }
     }
 }
 
@@ -154,10 +196,10 @@ CreateTraffic::CreateVoiceTraffic (PointToPointDumbbellHelper dumbbell, uint32_t
       voiceFwd.SetAttribute ("OffTime",StringValue ("ns3::ConstantRandomVariable[Constant=1.35]"));
 
       ApplicationContainer sourceAndSinkAppFwd;
-      sourceAndSinkAppFwd.Add (voiceFwd.Install (dumbbell.GetLeft (i)));
+      sourceAndSinkAppFwd.Add (InstallOnLocalNode (voiceFwd, dumbbell.GetLeft (i)));
 
       PacketSinkHelper packetSinkFwd ("ns3::UdpSocketFactory",InetSocketAddress (dumbbell.GetRightIpv4Address (i), port1));
-      sourceAndSinkAppFwd.Add (packetSinkFwd.Install (dumbbell.GetRight (i)));
+      sourceAndSinkAppFwd.Add (InstallOnLocalNode (packetSinkFwd, dumbbell.GetRight (i)));
 
       sourceAndSinkAppFwd.Start (Seconds (GetRandomValue ()));
       sourceAndSinkAppFwd.Stop (traffic->GetSimulationTime ());
@@ -168,10 +210,10 @@ CreateTraffic::CreateVoiceTraffic (PointToPointDumbbellHelper dumbbell, uint32_t
       voiceRev.SetAttribute ("OffTime",StringValue ("ns3::ConstantRandomVariable[Constant=1.35]"));
 
       ApplicationContainer sourceAndSinkAppRev;
-      sourceAndSinkAppRev.Add (voiceRev.Install (dumbbell.GetRight (i)));
+      sourceAndSinkAppRev.Add (InstallOnLocalNode (voiceRev, dumbbell.GetRight (i)));
 
       PacketSinkHelper packetSinkRev ("ns3::UdpSocketFactory",InetSocketAddress (dumbbell.GetLeftIpv4Address (i), port2));
-      sourceAndSinkAppRev.Add (packetSinkRev.Install (dumbbell.GetLeft (i)));
+      sourceAndSinkAppRev.Add (InstallOnLocalNode (packetSinkRev, dumbbell.GetLeft (i)));
 
       sourceAndSinkAppRev.Start (Seconds (GetRandomValue ()));
       sourceAndSinkAppRev.Stop (traffic->GetSimulationTime ());
@@ -197,10 +239,10 @@ CreateTraffic::CreateFwdStreamingTraffic (PointToPointDumbbellHelper dumbbell, u
       streaming.SetAttribute ("DataRate", DataRateValue (DataRate (streamingDataRate)));
 
       ApplicationContainer sourceAndSinkApp;
-      sourceAndSinkApp.Add (streaming.Install (dumbbell.GetLeft (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (streaming, dumbbell.GetLeft (i)));
 
       PacketSinkHelper packetSink ("ns3::UdpSocketFactory",InetSocketAddress (dumbbell.GetRightIpv4Address (i), port1));
-      sourceAndSinkApp.Add (packetSink.Install (dumbbell.GetRight (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (packetSink, dumbbell.GetRight (i)));
 
       sourceAndSinkApp.Start (Seconds (GetRandomValue ()));
       sourceAndSinkApp.Stop (traffic->GetSimulationTime ());
@@ -226,10 +268,10 @@ CreateTraffic::CreateRevStreamingTraffic (PointToPointDumbbellHelper dumbbell, u
       streaming.SetAttribute ("DataRate", DataRateValue (DataRate (streamingDataRate)));
 
       ApplicationContainer sourceAndSinkApp;
-      sourceAndSinkApp.Add (streaming.Install (dumbbell.GetRight (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (streaming, dumbbell.GetRight (i)));
 
       PacketSinkHelper packetSink ("ns3::UdpSocketFactory",InetSocketAddress (dumbbell.GetLeftIpv4Address (i), port1));
-      sourceAndSinkApp.Add (packetSink.Install (dumbbell.GetLeft (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (packetSink, dumbbell.GetLeft (i)));
 
       sourceAndSinkApp.Start (Seconds (GetRandomValue ()));
       sourceAndSinkApp.Stop (traffic->GetSimulationTime ());
@@ -254,20 +296,27 @@ CreateTraffic::CreateFwdFtpTrafficParking (PointToPointParkingLotHelper parkingL
       BulkSendHelper ftp ("ns3::TcpSocketFactory", Address ());
       ftp.SetAttribute ("Remote", remoteAddress);
       ftp.SetAttribute ("MaxBytes", UintegerValue (0));
+      ftp.SetAttribute ("VirtualPayload", BooleanValue (true));
 
       // Both source and sink apps are added to a single ApplicationContainer.
       // This is done to avoid the case when source starts before sink or
       // vice-versa due to random time generation.
       ApplicationContainer sourceAndSinkApp;
-      sourceAndSinkApp.Add (ftp.Install (parkingLot.GetLeft (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (ftp, parkingLot.GetLeft (i)));
 
       PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (parkingLot.GetRightIpv4Address (i), port1));
 
       sinkHelper.SetAttribute ("Protocol", TypeIdValue (TcpSocketFactory::GetTypeId ()));
-      sourceAndSinkApp.Add (sinkHelper.Install (parkingLot.GetRight (i)));
+      sinkHelper.SetAttribute ("VirtualPayload", BooleanValue (true));
+      sourceAndSinkApp.Add (InstallOnLocalNode (sinkHelper, parkingLot.GetRight (i)));
 
       sourceAndSinkApp.Start (Seconds (GetRandomValue ()));
       sourceAndSinkApp.Stop (traffic->GetSimulationTime ());
+
+      if (m_flowStats != 0)
+        {
+          m_flowStats->AddFlow (sourceAndSinkApp.Get (0), sourceAndSinkApp.Get (1));
+        }
     }
 }
 
@@ -289,20 +338,27 @@ CreateTraffic::CreateRevFtpTrafficParking (PointToPointParkingLotHelper parkingL
       BulkSendHelper ftp ("ns3::TcpSocketFactory", Address ());
       ftp.SetAttribute ("Remote", remoteAddress);
       ftp.SetAttribute ("MaxBytes", UintegerValue (0));
+      ftp.SetAttribute ("VirtualPayload", BooleanValue (true));
 
       // Both source and sink apps are added to a single ApplicationContainer.
       // This is done to avoid the case when source starts before sink or
       // vice-versa due to random time generation.
       ApplicationContainer sourceAndSinkApp;
-      sourceAndSinkApp.Add (ftp.Install (parkingLot.GetRight (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (ftp, parkingLot.GetRight (i)));
 
       PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (parkingLot.GetLeftIpv4Address (i), port1));
 
       sinkHelper.SetAttribute ("Protocol", TypeIdValue (TcpSocketFactory::GetTypeId ()));
-      sourceAndSinkApp.Add (sinkHelper.Install (parkingLot.GetLeft (i)));
+      sinkHelper.SetAttribute ("VirtualPayload", BooleanValue (true));
+      sourceAndSinkApp.Add (InstallOnLocalNode (sinkHelper, parkingLot.GetLeft (i)));
 
       sourceAndSinkApp.Start (Seconds (GetRandomValue ()));
       sourceAndSinkApp.Stop (traffic->GetSimulationTime ());
+
+      if (m_flowStats != 0)
+        {
+          m_flowStats->AddFlow (sourceAndSinkApp.Get (0), sourceAndSinkApp.Get (1));
+        }
     }
 }
 
@@ -324,10 +380,10 @@ CreateTraffic::CreateVoiceTrafficParking (PointToPointParkingLotHelper parkingLo
       voiceFwd.SetAttribute ("OffTime",StringValue ("ns3::ConstantRandomVariable[Constant=1.35]"));
 
       ApplicationContainer sourceAndSinkAppFwd;
-      sourceAndSinkAppFwd.Add (voiceFwd.Install (parkingLot.GetLeft (i)));
+      sourceAndSinkAppFwd.Add (InstallOnLocalNode (voiceFwd, parkingLot.GetLeft (i)));
 
       PacketSinkHelper packetSinkFwd ("ns3::UdpSocketFactory",InetSocketAddress (parkingLot.GetRightIpv4Address (i), port1));
-      sourceAndSinkAppFwd.Add (packetSinkFwd.Install (parkingLot.GetRight (i)));
+      sourceAndSinkAppFwd.Add (InstallOnLocalNode (packetSinkFwd, parkingLot.GetRight (i)));
 
       sourceAndSinkAppFwd.Start (Seconds (GetRandomValue ()));
       sourceAndSinkAppFwd.Stop (traffic->GetSimulationTime ());
@@ -337,10 +393,10 @@ CreateTraffic::CreateVoiceTrafficParking (PointToPointParkingLotHelper parkingLo
       voiceRev.SetAttribute ("DataRate", DataRateValue (DataRate ("64kb/s")));
       voiceRev.SetAttribute ("OffTime",StringValue ("ns3::ConstantRandomVariable[Constant=1.35]"));
       ApplicationContainer sourceAndSinkAppRev;
-      sourceAndSinkAppRev.Add (voiceRev.Install (parkingLot.GetRight (i)));
+      sourceAndSinkAppRev.Add (InstallOnLocalNode (voiceRev, parkingLot.GetRight (i)));
 
       PacketSinkHelper packetSinkRev ("ns3::UdpSocketFactory",InetSocketAddress (parkingLot.GetLeftIpv4Address (i), port2));
-      sourceAndSinkAppRev.Add (packetSinkRev.Install (parkingLot.GetLeft (i)));
+      sourceAndSinkAppRev.Add (InstallOnLocalNode (packetSinkRev, parkingLot.GetLeft (i)));
 
       sourceAndSinkAppRev.Start (Seconds (GetRandomValue ()));
       sourceAndSinkAppRev.Stop (traffic->GetSimulationTime ());
@@ -366,10 +422,10 @@ CreateTraffic::CreateFwdStreamingTrafficParking (PointToPointParkingLotHelper pa
       streaming.SetAttribute ("DataRate", DataRateValue (DataRate (streamingDataRate)));
 
       ApplicationContainer sourceAndSinkApp;
-      sourceAndSinkApp.Add (streaming.Install (parkingLot.GetLeft (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (streaming, parkingLot.GetLeft (i)));
 
       PacketSinkHelper packetSink ("ns3::UdpSocketFactory",InetSocketAddress (parkingLot.GetRightIpv4Address (i), port1));
-      sourceAndSinkApp.Add (packetSink.Install (parkingLot.GetRight (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (packetSink, parkingLot.GetRight (i)));
 
       sourceAndSinkApp.Start (Seconds (GetRandomValue ()));
       sourceAndSinkApp.Stop (traffic->GetSimulationTime ());
@@ -395,10 +451,10 @@ CreateTraffic::CreateRevStreamingTrafficParking (PointToPointParkingLotHelper pa
       streaming.SetAttribute ("DataRate", DataRateValue (DataRate (streamingDataRate)));
 
       ApplicationContainer sourceAndSinkApp;
-      sourceAndSinkApp.Add (streaming.Install (parkingLot.GetRight (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (streaming, parkingLot.GetRight (i)));
 
       PacketSinkHelper packetSink ("ns3::UdpSocketFactory",InetSocketAddress (parkingLot.GetLeftIpv4Address (i), port1));
-      sourceAndSinkApp.Add (packetSink.Install (parkingLot.GetLeft (i)));
+      sourceAndSinkApp.Add (InstallOnLocalNode (packetSink, parkingLot.GetLeft (i)));
 
       sourceAndSinkApp.Start (Seconds (GetRandomValue ()));
       sourceAndSinkApp.Stop (traffic->GetSimulationTime ());
@@ -421,17 +477,24 @@ CreateTraffic::CreateCrossFtpTrafficParking (PointToPointParkingLotHelper parkin
           BulkSendHelper ftp ("ns3::TcpSocketFactory", Address ());
           ftp.SetAttribute ("Remote", remoteAddress);
           ftp.SetAttribute ("MaxBytes", UintegerValue (0));
+          ftp.SetAttribute ("VirtualPayload", BooleanValue (true));
 
           ApplicationContainer sourceAndSinkApp;
-          sourceAndSinkApp.Add (ftp.Install (parkingLot.GetCrossSource (i,j)));
+          sourceAndSinkApp.Add (InstallOnLocalNode (ftp, parkingLot.GetCrossSource (i,j)));
 
           PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (parkingLot.GetCrossSinkIpv4Address (i, j), port1));
 
           sinkHelper.SetAttribute ("Protocol", TypeIdValue (TcpSocketFactory::GetTypeId ()));
-          sourceAndSinkApp.Add (sinkHelper.Install (parkingLot.GetCrossSink (i,j)));
+          sinkHelper.SetAttribute ("VirtualPayload", BooleanValue (true));
+          sourceAndSinkApp.Add (InstallOnLocalNode (sinkHelper, parkingLot.GetCrossSink (i,j)));
 
           sourceAndSinkApp.Start (Seconds (GetRandomValue ()));
           sourceAndSinkApp.Stop (traffic->GetSimulationTime ());
+
+          if (m_flowStats != 0)
+            {
+              m_flowStats->AddFlow (sourceAndSinkApp.Get (0), sourceAndSinkApp.Get (1));
+            }
         }
     }
 }
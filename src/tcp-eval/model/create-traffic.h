@@ -27,6 +27,7 @@
 #include <stdint.h>
 
 #include "traffic-parameters.h"
+#include "flow-stats.h"
 #include "ns3/object.h"
 #include "ns3/network-module.h"
 #include "ns3/internet-module.h"
@@ -73,6 +74,15 @@ public:
    */
   double GetRandomValue (void) const;
 
+  /**
+   * \brief Set the collector of per-flow statistics
+   *
+   * When set, every FTP flow created afterwards is added to it.
+   *
+   * \param flowStats Object of FlowStats class, or 0 to stop collecting
+   */
+  void SetFlowStats (Ptr<FlowStats> flowStats);
+
   /**
    * \brief Create forward FTP traffic for dumbbell topology
    *
@@ -206,6 +216,7 @@ public:
 
 private:
   Ptr<UniformRandomVariable> m_randVar;         //!< Random variable to randomize the start time for traffic flows
+  Ptr<FlowStats>             m_flowStats;       //!< Collector of per-flow statistics of FTP flows
 
 };
 
@@ -28,8 +28,10 @@
 
 #include "dumbbell-topology.h"
 #include "eval-stats.h"
+#include "flow-stats.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/abort.h"
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
 #include "ns3/internet-module.h"
@@ -106,9 +108,16 @@ DumbbellTopology::CreateDumbbellTopology (Ptr<TrafficParameters> traffic, std::s
   uint32_t nLeftLeaf = nFwdFtpFlow + nRevFtpFlow + nVoiceFlow + nFwdStreamingFlow + nRevStreamingFlow;
   uint32_t nRightLeaf = nLeftLeaf;
 
+  // In a distributed or multithreaded simulation, the left side of the
+  // dumbbell is simulated by the first system and the right side by the
+  // second one, so that the bottleneck link crosses systems
+  uint32_t leftSystemId = 0;
+  uint32_t rightSystemId = (GetSystemCount () > 1) ? 1 : 0;
+
   PointToPointDumbbellHelper dumbbell (nLeftLeaf, pointToPointLeaf,
                                        nRightLeaf, pointToPointLeaf,
-                                       pointToPointRouter);
+                                       pointToPointRouter,
+                                       leftSystemId, rightSystemId);
 
   // Install Stack
   InternetStackHelper stack;
@@ -123,6 +132,16 @@ DumbbellTopology::CreateDumbbellTopology (Ptr<TrafficParameters> traffic, std::s
   // the nodes created for a particular traffic
   uint32_t offset = 0;
   Ptr<CreateTraffic> createTraffic = CreateObject<CreateTraffic> ();
+
+  // Collect per-flow statistics of FTP flows if a file is given
+  Ptr<FlowStats> flowStats;
+  if (!m_flowStatsFileName.empty ())
+    {
+      // The source and the sink of a flow are simulated by different systems
+      NS_ABORT_MSG_IF (IsPartitioned (), "Per-flow statistics are not supported in distributed simulations");
+      flowStats = CreateObject<FlowStats> (m_flowStatsFileName);
+      createTraffic->SetFlowStats (flowStats);
+    }
   if (nFwdFtpFlow > 0)
     {
       // Create forward FTP traffic
@@ -157,10 +176,14 @@ DumbbellTopology::CreateDumbbellTopology (Ptr<TrafficParameters> traffic, std::s
 
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 
-  // Push the stats of left most router to a file
+  // Push the stats of left most router to a file, from the system simulating it
   Ptr<Node> left = dumbbell.GetLeft ();
-  Ptr<EvalStats> evalStats = CreateObject<EvalStats> (m_bottleneckBandwidth, m_rttp , fileName);
-  evalStats->Install (left, traffic);
+  Ptr<EvalStats> evalStats;
+  if (IsLocal (left))
+    {
+      evalStats = CreateObject<EvalStats> (m_bottleneckBandwidth, m_rttp , fileName);
+      evalStats->Install (left, traffic);
+    }
 
   Simulator::Stop (Time::FromDouble (((traffic->GetSimulationTime ()).ToDouble (Time::S) + 5), Time::S));
   Simulator::Run ();
@@ -22,10 +22,42 @@
 
 // Implement an object that collects statistics at the bottleneck router.
 
+#include <cstdio>
+
 #include "eval-stats.h"
 
 namespace ns3 {
 
+NS_LOG_COMPONENT_DEFINE ("EvalStats");
+
+NS_OBJECT_ENSURE_REGISTERED (EvalStats);
+
+TypeId
+EvalStats::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::EvalStats")
+    .SetParent<Object> ()
+    .SetGroupName ("TcpEvaluationSuite")
+    .AddAttribute ("SamplingInterval",
+                   "Time between two samples of the bottleneck metrics",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&EvalStats::m_samplingInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("TimeSeriesFileName",
+                   "File where every sample of the bottleneck metrics is streamed. "
+                   "Empty disables the time series",
+                   StringValue (""),
+                   MakeStringAccessor (&EvalStats::m_timeSeriesFileName),
+                   MakeStringChecker ())
+    .AddAttribute ("TimeSeriesBufferSize",
+                   "Number of bytes of samples buffered before they are written to the time series file",
+                   UintegerValue (1 << 20),
+                   MakeUintegerAccessor (&EvalStats::m_timeSeriesBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
 EvalStats::EvalStats (uint32_t bandwidth, Time rttp, std::string fileName)
 {
   m_totalUtilization = 0;
@@ -35,21 +67,34 @@ EvalStats::EvalStats (uint32_t bandwidth, Time rttp, std::string fileName)
   m_bytesOut = 0;
   m_sumQueueLength = 0;
   m_nthSampleInInterval = 0;
+  m_lastDroppedPackets = 0;
   this->m_bandwidth = bandwidth;
   this->m_rttp = rttp;
+  m_samplingTimer = CreateObject<SamplingTimer> ();
 }
 
 EvalStats::~EvalStats ()
 {
   InsertIntoFile ();
   m_evalStatsFile.close ();
+
+  if (m_timeSeriesFile.is_open ())
+    {
+      m_timeSeriesFile.write (m_timeSeriesBuffer.data (), m_timeSeriesBuffer.size ());
+      m_timeSeriesFile.close ();
+    }
 }
 
 // Computes link utilization and mean queue size
 void
 EvalStats::ComputeMetrics ()
 {
-  m_totalUtilization += (double) m_bytesOut * 8.0 / ( m_bandwidth * 1000 * 1000 );
+  if (m_timeSeriesFile.is_open ())
+    {
+      InsertIntoTimeSeries ();
+    }
+
+  m_totalUtilization += (double) m_bytesOut * 8.0 / ( m_bandwidth * 1000 * 1000 ) / m_samplingInterval.ToDouble (Time::S);
   m_bytesOut = 0;
 
   UintegerValue queueSize;
@@ -77,7 +122,9 @@ EvalStats::InsertIntoFile ()
 
   m_evalStatsFile.open (m_evalStatsFileName.c_str (), std::ios::app);
   m_evalStatsFile << m_bandwidth << std::setw (15) << m_rttp.GetSeconds () << std::setw (15) << m_numFtpFlows;
-  m_evalStatsFile << std::setw (15) << (m_totalUtilization / (m_simulationTime.ToDouble (Time::S)) * 100);
+  // Metrics are averaged over the number of samples taken
+  double nSamples = std::max<uint32_t> (m_samplingTimer->GetNumOfSamples (), 1);
+  m_evalStatsFile << std::setw (15) << (m_totalUtilization / nSamples * 100);
 
   UintegerValue queueSize;
   if (m_bottleneckQueue.compare ("RED") == 0)
@@ -88,12 +135,34 @@ EvalStats::InsertIntoFile ()
     {
       m_queue->GetAttribute ("MaxPackets", queueSize);
     }
-  m_evalStatsFile << std::setw (15) << m_totalQueueSize / (m_simulationTime.ToDouble (Time::S));
+  m_evalStatsFile << std::setw (15) << m_totalQueueSize / nSamples;
   m_evalStatsFile << std::setw (15) << m_totalDroppedPacketRate;
 
   m_evalStatsFile << std::endl;
 }
 
+// Appends one row with the metrics of the interval that just ended.
+// Rows are accumulated in a buffer, so the file is written in large chunks.
+void
+EvalStats::InsertIntoTimeSeries ()
+{
+  uint32_t droppedPackets = m_queue->GetTotalDroppedPackets ();
+  double meanQueueLength = (m_nthSampleInInterval == 0) ? 0 : ((double) m_sumQueueLength / m_nthSampleInInterval);
+
+  char row[96];
+  int length = std::snprintf (row, sizeof (row), "%.9g,%u,%.3f,%u\n",
+                              Simulator::Now ().GetSeconds (), m_bytesOut,
+                              meanQueueLength, droppedPackets - m_lastDroppedPackets);
+  m_timeSeriesBuffer.append (row, length);
+  m_lastDroppedPackets = droppedPackets;
+
+  if (m_timeSeriesBuffer.size () >= m_timeSeriesBufferSize)
+    {
+      m_timeSeriesFile.write (m_timeSeriesBuffer.data (), m_timeSeriesBuffer.size ());
+      m_timeSeriesBuffer.clear ();
+    }
+}
+
 // Called during the PhyTxBegin event at the netdevice.
 // Gets the size of the packet and stores it in bytesOut variable.
 void
@@ -134,9 +203,16 @@ EvalStats::Install (Ptr<Node> node, Ptr<TrafficParameters> traffic)
   m_netDevice->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&EvalStats::AggregateOverInterval, this));
   m_queue->TraceConnectWithoutContext ("Enqueue", MakeCallback (&EvalStats::AggregateQueue, this));
 
-  for (uint32_t i = 1; i <= m_simulationTime.ToInteger (Time::S); ++i)
+  if (!m_timeSeriesFileName.empty ())
     {
-      Simulator::Schedule (Seconds (i), &EvalStats::ComputeMetrics, this);
+      m_timeSeriesFile.open (m_timeSeriesFileName.c_str (), std::ios::out | std::ios::trunc);
+      m_timeSeriesFile << "time,bytesOut,meanQueueLength,drops" << std::endl;
+      m_timeSeriesBuffer.reserve (m_timeSeriesBufferSize + 96);
     }
+
+  // Only the next sample is kept in the scheduler
+  m_samplingTimer->SetInterval (m_samplingInterval);
+  m_samplingTimer->SetFunction (MakeCallback (&EvalStats::ComputeMetrics, this));
+  m_samplingTimer->Start (m_simulationTime);
 }
 }
@@ -35,6 +35,7 @@
 #include "ns3/network-module.h"
 #include "ns3/internet-module.h"
 #include "ns3/traffic-parameters.h"
+#include "ns3/sampling-timer.h"
 
 #include "ns3/point-to-point-module.h"
 #include "ns3/point-to-point-layout-module.h"
@@ -46,11 +47,21 @@ namespace ns3 {
  * \brief Calculates the bottleneck metrics and outputs it to files.
  *
  *  When installed on a node, it computes metrics such as link utilization,
- *  mean queue length and packet drop rate.
+ *  mean queue length and packet drop rate. The metrics are sampled every
+ *  SamplingInterval and averaged over all the samples of the simulation.
+ *
+ *  If TimeSeriesFileName is set, every sample is also streamed to that file
+ *  as a CSV row (time, bytes out, mean queue length, drops in the interval).
+ *  Rows are buffered in memory and written in large chunks.
  */
 class EvalStats : public Object
 {
 public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
 
   /**
    * \brief Constructor
@@ -67,9 +78,9 @@ public:
   ~EvalStats ();
 
   /**
-   * \brief Calculates metrics every second.
+   * \brief Calculates metrics every sampling interval.
    *
-   * Computes metrics such as link utilization, queue size every second and
+   * Computes metrics such as link utilization, queue size every sampling interval and
    * stores the value so the overall utilization and queue size can be computed later
    */
   void ComputeMetrics ();
@@ -102,6 +113,14 @@ public:
    */
   void InsertIntoFile ();
 
+  /**
+   * \brief Appends the metrics of the current interval to the time series.
+   *
+   * Called from ComputeMetrics when TimeSeriesFileName is set. The buffered
+   * rows are written to the file once they exceed TimeSeriesBufferSize.
+   */
+  void InsertIntoTimeSeries ();
+
   /**
     * \brief Connects the Trace Source of the node passed, to the callback functions
     *
@@ -116,7 +135,7 @@ public:
   void Install (Ptr<Node> node, Ptr<TrafficParameters> traffic);
 
 private:
-  uint32_t                    m_bytesOut;		//!< Number of bytes sent per second
+  uint32_t                    m_bytesOut;		//!< Number of bytes sent in the current interval
   uint32_t                    m_bandwidth;		//!< Bandwidth of bottleneck link in Mbps
   uint32_t                    m_sumQueueLength;		//!< Sum of sampled queue lengths
   uint32_t                    m_nthSampleInInterval;	//!< Number of samples for queue lengths
@@ -131,6 +150,13 @@ private:
   Ptr<Queue>                  m_queue;			//!< The queue of the node from which stats are collected
   std::string                 m_evalStatsFileName;	//!< Name of file where the output is stored
   std::ofstream               m_evalStatsFile;		//!< The file for storing the output
+  Time                        m_samplingInterval;	//!< Time between two samples of the metrics
+  Ptr<SamplingTimer>          m_samplingTimer;		//!< Timer invoking ComputeMetrics
+  std::string                 m_timeSeriesFileName;	//!< Name of file where the samples are streamed
+  std::ofstream               m_timeSeriesFile;		//!< The file for streaming the samples
+  std::string                 m_timeSeriesBuffer;	//!< Samples not yet written to the file
+  uint32_t                    m_timeSeriesBufferSize;	//!< Size in bytes at which the samples are written
+  uint32_t                    m_lastDroppedPackets;	//!< Dropped packets at the previous sample
 };
 
 }
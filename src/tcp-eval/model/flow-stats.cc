@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Implement an object that collects per-flow statistics of the FTP flows.
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include "flow-stats.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/socket.h"
+#include "ns3/bulk-send-application.h"
+#include "ns3/packet-sink.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowStats");
+
+NS_OBJECT_ENSURE_REGISTERED (FlowStats);
+
+TypeId
+FlowStats::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FlowStats")
+    .SetParent<Object> ()
+    .SetGroupName ("TcpEvaluationSuite")
+    .AddAttribute ("HistorySize",
+                   "Number of RTT samples kept per flow to compute the 99th percentile",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&FlowStats::m_historySize),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+FlowStats::FlowStats (std::string fileName)
+{
+  m_flowStatsFileName.assign (fileName);
+}
+
+FlowStats::~FlowStats ()
+{
+  InsertIntoFile ();
+}
+
+void
+FlowStats::AddFlow (Ptr<Application> source, Ptr<Application> sink)
+{
+  NS_ABORT_MSG_UNLESS (DynamicCast<BulkSendApplication> (source), "Source of a flow must be a BulkSendApplication");
+  NS_ABORT_MSG_UNLESS (DynamicCast<PacketSink> (sink), "Sink of a flow must be a PacketSink");
+
+  uint32_t flowId = m_flows.size ();
+  Flow flow;
+  flow.m_source = source;
+  flow.m_rxBytes = 0;
+  flow.m_connected = false;
+  flow.m_nRtt = 0;
+  flow.m_sumRtt = 0;
+  flow.m_rttHistory.resize (m_historySize, 0);
+  flow.m_nCwnd = 0;
+  flow.m_sumCwnd = 0;
+  m_flows.push_back (flow);
+
+  source->TraceConnectWithoutContext ("Tx", MakeCallback (&FlowStats::SourceTx, this).Bind (flowId));
+  sink->TraceConnectWithoutContext ("Rx", MakeCallback (&FlowStats::SinkRx, this).Bind (flowId));
+}
+
+uint32_t
+FlowStats::GetNumOfFlows (void) const
+{
+  return m_flows.size ();
+}
+
+// BulkSendApplication creates its socket when the application starts,
+// so the socket trace sources are connected when the first packet is sent.
+void
+FlowStats::SourceTx (uint32_t flowId, Ptr<const Packet> packet)
+{
+  Flow &flow = m_flows[flowId];
+  if (flow.m_connected)
+    {
+      return;
+    }
+  flow.m_connected = true;
+
+  Ptr<Socket> socket = DynamicCast<BulkSendApplication> (flow.m_source)->GetSocket ();
+  socket->TraceConnectWithoutContext ("CongestionWindow", MakeCallback (&FlowStats::CwndChange, this).Bind (flowId));
+  socket->TraceConnectWithoutContext ("RTT", MakeCallback (&FlowStats::RttChange, this).Bind (flowId));
+}
+
+void
+FlowStats::CwndChange (uint32_t flowId, uint32_t oldCwnd, uint32_t newCwnd)
+{
+  Flow &flow = m_flows[flowId];
+  flow.m_sumCwnd += newCwnd;
+  flow.m_nCwnd++;
+}
+
+void
+FlowStats::RttChange (uint32_t flowId, Time oldRtt, Time newRtt)
+{
+  Flow &flow = m_flows[flowId];
+  double rtt = newRtt.GetSeconds ();
+  flow.m_rttHistory[flow.m_nRtt % flow.m_rttHistory.size ()] = rtt;
+  flow.m_sumRtt += rtt;
+  flow.m_nRtt++;
+}
+
+void
+FlowStats::SinkRx (uint32_t flowId, Ptr<const Packet> packet, const Address &from)
+{
+  Flow &flow = m_flows[flowId];
+  if (flow.m_rxBytes == 0)
+    {
+      flow.m_startTime = Simulator::Now ();
+    }
+  flow.m_rxBytes += packet->GetSize ();
+  flow.m_lastRxTime = Simulator::Now ();
+}
+
+double
+FlowStats::GetGoodput (uint32_t flowId) const
+{
+  const Flow &flow = m_flows[flowId];
+  double duration = (flow.m_lastRxTime - flow.m_startTime).GetSeconds ();
+  if (duration <= 0)
+    {
+      return 0;
+    }
+  return flow.m_rxBytes * 8.0 / duration / (1000 * 1000);
+}
+
+double
+FlowStats::GetJainFairnessIndex (void) const
+{
+  double sum = 0;
+  double sumOfSquares = 0;
+  for (uint32_t i = 0; i < m_flows.size (); ++i)
+    {
+      double goodput = GetGoodput (i);
+      sum += goodput;
+      sumOfSquares += goodput * goodput;
+    }
+  if (sumOfSquares == 0)
+    {
+      return 0;
+    }
+  return sum * sum / (m_flows.size () * sumOfSquares);
+}
+
+double
+FlowStats::GetRttPercentile99 (const Flow &flow) const
+{
+  uint32_t nSamples = std::min<uint64_t> (flow.m_nRtt, flow.m_rttHistory.size ());
+  if (nSamples == 0)
+    {
+      return 0;
+    }
+  std::vector<double> samples (flow.m_rttHistory.begin (), flow.m_rttHistory.begin () + nSamples);
+  uint32_t rank = (uint32_t) (0.99 * (nSamples - 1));
+  std::nth_element (samples.begin (), samples.begin () + rank, samples.end ());
+  return samples[rank];
+}
+
+// Writes one row per flow: flow index, goodput (Mbps), mean RTT (s),
+// 99th percentile of RTT (s) and mean congestion window (bytes),
+// followed by Jain's fairness index of the goodputs.
+void
+FlowStats::InsertIntoFile ()
+{
+  if (m_flows.empty ())
+    {
+      return;
+    }
+
+  std::ofstream flowStatsFile (m_flowStatsFileName.c_str (), std::ios::app);
+  for (uint32_t i = 0; i < m_flows.size (); ++i)
+    {
+      const Flow &flow = m_flows[i];
+      flowStatsFile << i;
+      flowStatsFile << std::setw (15) << GetGoodput (i);
+      flowStatsFile << std::setw (15) << ((flow.m_nRtt == 0) ? 0 : flow.m_sumRtt / flow.m_nRtt);
+      flowStatsFile << std::setw (15) << GetRttPercentile99 (flow);
+      flowStatsFile << std::setw (15) << ((flow.m_nCwnd == 0) ? 0 : flow.m_sumCwnd / flow.m_nCwnd);
+      flowStatsFile << std::endl;
+    }
+  flowStatsFile << "# Jain's fairness index " << GetJainFairnessIndex () << std::endl;
+}
+
+}
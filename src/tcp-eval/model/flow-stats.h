@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Define an object that collects per-flow statistics of the FTP flows.
+
+#ifndef FLOW_STATS_H
+#define FLOW_STATS_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/address.h"
+#include "ns3/packet.h"
+#include "ns3/application.h"
+
+namespace ns3 {
+
+/**
+ * \brief Calculates per-flow metrics of the FTP flows and outputs them to a file.
+ *
+ *  For every flow added, it follows the CongestionWindow and RTT trace sources
+ *  of the sender's TCP socket and the Rx trace source of the PacketSink. The
+ *  goodput, mean RTT and mean congestion window are computed from running sums.
+ *  The 99th percentile of the RTT is computed from a ring buffer holding the
+ *  last HistorySize samples of each flow, so memory does not grow with the
+ *  simulation time. Jain's fairness index of the goodputs is written at the end.
+ */
+class FlowStats : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Constructor
+   *
+   * \param fileName The file to which the per-flow metrics are stored.
+   */
+  FlowStats (std::string fileName);
+
+  /**
+   * \brief Destructor
+   *
+   * Writes the per-flow metrics into the file.
+   */
+  ~FlowStats ();
+
+  /**
+   * \brief Starts collecting the metrics of a flow
+   *
+   * The socket trace sources are connected when the source sends its first
+   * packet, since BulkSendApplication creates its socket only when it starts.
+   *
+   * \param source BulkSendApplication sending the flow
+   * \param sink PacketSink receiving the flow
+   */
+  void AddFlow (Ptr<Application> source, Ptr<Application> sink);
+
+  /**
+   * \brief Get the number of flows added
+   *
+   * \return the number of flows added
+   */
+  uint32_t GetNumOfFlows (void) const;
+
+  /**
+   * \brief Get the goodput of a flow
+   *
+   * \param flowId Index of the flow, in the order it was added
+   * \return the goodput in Mbps
+   */
+  double GetGoodput (uint32_t flowId) const;
+
+  /**
+   * \brief Get Jain's fairness index of the goodputs of all flows
+   *
+   * \return Jain's fairness index, between 1/n and 1
+   */
+  double GetJainFairnessIndex (void) const;
+
+  /**
+   * \brief Writes the metrics into a file.
+   *
+   * One row per flow is written, followed by Jain's fairness index.
+   */
+  void InsertIntoFile ();
+
+private:
+  /**
+   * \brief Metrics of a single flow
+   */
+  struct Flow
+  {
+    Ptr<Application>    m_source;       //!< BulkSendApplication sending the flow
+    Time                m_startTime;    //!< Time of the first packet received
+    Time                m_lastRxTime;   //!< Time of the last packet received
+    uint64_t            m_rxBytes;      //!< Number of bytes received by the sink
+    bool                m_connected;    //!< Whether the socket trace sources are connected
+    uint64_t            m_nRtt;         //!< Number of RTT samples
+    double              m_sumRtt;       //!< Sum of RTT samples in seconds
+    std::vector<double> m_rttHistory;   //!< Ring buffer of the last RTT samples in seconds
+    uint64_t            m_nCwnd;        //!< Number of congestion window samples
+    double              m_sumCwnd;      //!< Sum of congestion window samples in bytes
+  };
+
+  /**
+   * \brief Connects the socket trace sources of a flow on its first packet
+   *
+   * \param flowId Index of the flow
+   * \param packet The packet sent
+   */
+  void SourceTx (uint32_t flowId, Ptr<const Packet> packet);
+
+  /**
+   * \brief Records a congestion window sample
+   *
+   * \param flowId Index of the flow
+   * \param oldCwnd Previous congestion window
+   * \param newCwnd New congestion window
+   */
+  void CwndChange (uint32_t flowId, uint32_t oldCwnd, uint32_t newCwnd);
+
+  /**
+   * \brief Records a RTT sample
+   *
+   * \param flowId Index of the flow
+   * \param oldRtt Previous RTT sample
+   * \param newRtt New RTT sample
+   */
+  void RttChange (uint32_t flowId, Time oldRtt, Time newRtt);
+
+  /**
+   * \brief Records a packet received by the sink
+   *
+   * \param flowId Index of the flow
+   * \param packet The packet received
+   * \param from The address of the sender
+   */
+  void SinkRx (uint32_t flowId, Ptr<const Packet> packet, const Address &from);
+
+  /**
+   * \brief Computes the 99th percentile of the RTT samples in the ring buffer
+   *
+   * \param flow The flow
+   * \return the 99th percentile of the RTT in seconds
+   */
+  double GetRttPercentile99 (const Flow &flow) const;
+
+  std::vector<Flow>   m_flows;            //!< Metrics of every flow
+  uint32_t            m_historySize;      //!< Number of RTT samples kept per flow
+  std::string         m_flowStatsFileName; //!< Name of file where the output is stored
+};
+
+}
+
+#endif /* FLOW_STATS_H */
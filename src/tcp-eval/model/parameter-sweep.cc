@@ -0,0 +1,302 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Implement an object to run a parameter sweep of tcp-eval simulations in parallel.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "parameter-sweep.h"
+#include "configure-topology.h"
+#include "traffic-parameters.h"
+#include "dumbbell-topology.h"
+#include "parking-lot-topology.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/core-module.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ParameterSweep");
+
+NS_OBJECT_ENSURE_REGISTERED (ParameterSweep);
+
+TypeId
+ParameterSweep::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ParameterSweep")
+    .SetParent<Object> ()
+    .SetGroupName ("TcpEvaluationSuite")
+    .AddAttribute ("Topology",
+                   "Topology to be simulated at every point of the sweep",
+                   EnumValue (DUMBBELL),
+                   MakeEnumAccessor (&ParameterSweep::m_topology),
+                   MakeEnumChecker (DUMBBELL, "Dumbbell",
+                                    PARKING_LOT, "ParkingLot"))
+    .AddAttribute ("MaxJobs",
+                   "Maximum number of simulations running at the same time. "
+                   "0 means one per online processor",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ParameterSweep::m_maxJobs),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+ParameterSweep::ParameterSweep (void)
+{
+}
+
+ParameterSweep::~ParameterSweep (void)
+{
+}
+
+void
+ParameterSweep::AddTcpVariant (std::string tcpVariant)
+{
+  m_tcpVariants.push_back (tcpVariant);
+}
+
+void
+ParameterSweep::AddRttp (Time rttp)
+{
+  m_rttps.push_back (rttp);
+}
+
+void
+ParameterSweep::AddBottleneckBandwidth (double bottleneckBandwidth)
+{
+  m_bottleneckBandwidths.push_back (bottleneckBandwidth);
+}
+
+void
+ParameterSweep::AddNumOfFwdFtpFlows (uint32_t nFwdFtpFlows)
+{
+  m_nFwdFtpFlows.push_back (nFwdFtpFlows);
+}
+
+uint32_t
+ParameterSweep::GetNumOfPoints (void) const
+{
+  return std::max<uint32_t> (m_tcpVariants.size (), 1)
+         * std::max<uint32_t> (m_rttps.size (), 1)
+         * std::max<uint32_t> (m_bottleneckBandwidths.size (), 1)
+         * std::max<uint32_t> (m_nFwdFtpFlows.size (), 1);
+}
+
+std::vector<ParameterSweep::SweepPoint>
+ParameterSweep::GetPoints (std::string fileName) const
+{
+  // Empty lists contribute the defaults in effect, which are read back
+  // from freshly created objects
+  Ptr<ConfigureTopology> topology = CreateObject<ConfigureTopology> ();
+  Ptr<TrafficParameters> traffic = CreateObject<TrafficParameters> ();
+
+  std::vector<std::string> tcpVariants = m_tcpVariants;
+  std::vector<Time> rttps = m_rttps;
+  std::vector<double> bottleneckBandwidths = m_bottleneckBandwidths;
+  std::vector<uint32_t> nFwdFtpFlows = m_nFwdFtpFlows;
+
+  if (tcpVariants.empty ())
+    {
+      tcpVariants.push_back ("TcpNewReno");
+    }
+  if (rttps.empty ())
+    {
+      rttps.push_back (topology->GetRttp ());
+    }
+  if (bottleneckBandwidths.empty ())
+    {
+      bottleneckBandwidths.push_back (topology->GetBottleneckBandwidth ());
+    }
+  if (nFwdFtpFlows.empty ())
+    {
+      nFwdFtpFlows.push_back (traffic->GetNumOfFwdFtpFlows ());
+    }
+
+  // Points are ordered the same way as the loops of the vary_* scripts:
+  // TCP variant first, then the swept parameters.
+  std::vector<SweepPoint> points;
+  for (uint32_t v = 0; v < tcpVariants.size (); ++v)
+    {
+      for (uint32_t r = 0; r < rttps.size (); ++r)
+        {
+          for (uint32_t b = 0; b < bottleneckBandwidths.size (); ++b)
+            {
+              for (uint32_t f = 0; f < nFwdFtpFlows.size (); ++f)
+                {
+                  SweepPoint point;
+                  point.tcpVariant = tcpVariants[v];
+                  point.rttp = rttps[r];
+                  point.bottleneckBandwidth = bottleneckBandwidths[b];
+                  point.nFwdFtpFlows = nFwdFtpFlows[f];
+                  point.fileName = fileName + "." + tcpVariants[v];
+
+                  std::ostringstream partFileName;
+                  partFileName << point.fileName << ".part" << points.size ();
+                  point.partFileName = partFileName.str ();
+
+                  points.push_back (point);
+                }
+            }
+        }
+    }
+  return points;
+}
+
+void
+ParameterSweep::RunPoint (const SweepPoint &point) const
+{
+  ConfigureTopology::SetTcpVariant (point.tcpVariant);
+  Config::SetDefault ("ns3::ConfigureTopology::RTTP", TimeValue (point.rttp));
+  Config::SetDefault ("ns3::ConfigureTopology::BottleneckBandwidth", DoubleValue (point.bottleneckBandwidth));
+  Config::SetDefault ("ns3::TrafficParameters::FwdFtpFlows", UintegerValue (point.nFwdFtpFlows));
+
+  Ptr<TrafficParameters> trafficParams = CreateObject<TrafficParameters> ();
+  if (m_topology == PARKING_LOT)
+    {
+      Ptr<ParkingLotTopology> parkingLot = CreateObject<ParkingLotTopology> ();
+      parkingLot->CreateParkingLotTopology (trafficParams, point.partFileName);
+    }
+  else
+    {
+      Ptr<DumbbellTopology> dumbbell = CreateObject<DumbbellTopology> ();
+      dumbbell->CreateDumbbellTopology (trafficParams, point.partFileName);
+    }
+}
+
+void
+ParameterSweep::MergePoint (const SweepPoint &point) const
+{
+  std::ifstream partFile (point.partFileName.c_str ());
+  std::ofstream evalStatsFile (point.fileName.c_str (), std::ios::app);
+  if (partFile.peek () != std::ifstream::traits_type::eof ())
+    {
+      evalStatsFile << partFile.rdbuf ();
+    }
+  partFile.close ();
+  std::remove (point.partFileName.c_str ());
+}
+
+uint32_t
+ParameterSweep::Run (std::string fileName)
+{
+  for (uint32_t i = 0; i < m_tcpVariants.size (); ++i)
+    {
+      NS_ABORT_MSG_UNLESS (ConfigureTopology::SetTcpVariant (m_tcpVariants[i]),
+                           "Invalid TCP version " << m_tcpVariants[i]);
+    }
+
+  uint32_t maxJobs = m_maxJobs;
+  if (maxJobs == 0)
+    {
+      long nProcessors = sysconf (_SC_NPROCESSORS_ONLN);
+      maxJobs = (nProcessors > 0) ? nProcessors : 1;
+    }
+
+  std::vector<SweepPoint> points = GetPoints (fileName);
+  std::vector<bool> finished (points.size (), false);
+  std::vector<bool> failed (points.size (), false);
+  std::map<pid_t, uint32_t> running;
+  uint32_t nextToStart = 0;
+  uint32_t nextToMerge = 0;
+  uint32_t nFailed = 0;
+
+  NS_LOG_INFO ("Running " << points.size () << " simulations on " << maxJobs << " worker processes");
+
+  while (nextToMerge < points.size ())
+    {
+      // Keep the pool of workers full
+      while (nextToStart < points.size () && running.size () < maxJobs)
+        {
+          std::remove (points[nextToStart].partFileName.c_str ());
+
+          // Buffered output would otherwise be written once more by the child
+          std::cout.flush ();
+          std::cerr.flush ();
+
+          pid_t pid = fork ();
+          NS_ABORT_MSG_IF (pid < 0, "fork failed: " << std::strerror (errno));
+          if (pid == 0)
+            {
+              RunPoint (points[nextToStart]);
+              std::cout.flush ();
+              _exit (0);
+            }
+          running[pid] = nextToStart;
+          ++nextToStart;
+        }
+
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          NS_ABORT_MSG_UNLESS (errno == EINTR, "waitpid failed: " << std::strerror (errno));
+          continue;
+        }
+
+      std::map<pid_t, uint32_t>::iterator it = running.find (pid);
+      if (it == running.end ())
+        {
+          continue;
+        }
+      uint32_t index = it->second;
+      running.erase (it);
+      finished[index] = true;
+
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          NS_LOG_WARN ("Simulation of " << points[index].tcpVariant
+                       << " with rttp " << points[index].rttp.GetSeconds ()
+                       << "s, bandwidth " << points[index].bottleneckBandwidth
+                       << "Mbps and " << points[index].nFwdFtpFlows
+                       << " forward FTP flows did not complete");
+          failed[index] = true;
+          ++nFailed;
+        }
+
+      // Rows are merged in sweep order, so that each result file is
+      // written by a single process and never interleaved
+      while (nextToMerge < points.size () && finished[nextToMerge])
+        {
+          if (failed[nextToMerge])
+            {
+              std::remove (points[nextToMerge].partFileName.c_str ());
+            }
+          else
+            {
+              MergePoint (points[nextToMerge]);
+            }
+          NS_LOG_INFO ("Finished simulation " << nextToMerge + 1 << " of " << points.size ());
+          ++nextToMerge;
+        }
+    }
+
+  return nFailed;
+}
+
+}
@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Define an object to run a parameter sweep of tcp-eval simulations in parallel.
+
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \brief Runs a sweep of dumbbell or parking-lot simulations on a pool of
+ * worker processes.
+ *
+ * The sweep is the cross product of the TCP variants, RTTP values,
+ * bottleneck bandwidths and forward FTP flow counts added to it. A list
+ * that is left empty contributes the current default of the corresponding
+ * attribute. All other parameters are taken from the defaults in effect
+ * when Run () is called, so they can be set with Config::SetDefault as in
+ * the drive-dumbbell and drive-parking-lot examples.
+ *
+ * Each point is simulated in a forked child process, with at most MaxJobs
+ * children alive at a time. A child writes its EvalStats row to a private
+ * part file; the parent appends the part files to fileName.<TcpVariant> in
+ * sweep order, so the result files are identical to the ones written by
+ * running the points one after another.
+ */
+class ParameterSweep : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Topologies that can be swept
+   */
+  enum TopologyType
+  {
+    DUMBBELL,
+    PARKING_LOT
+  };
+
+  /**
+   * \brief Constructor
+   */
+  ParameterSweep (void);
+
+  /**
+   * \brief Destructor
+   */
+  ~ParameterSweep (void);
+
+  /**
+   * \brief Add a TCP variant to the sweep
+   *
+   * \param tcpVariant Name of the TCP variant, as accepted by ConfigureTopology::SetTcpVariant
+   */
+  void AddTcpVariant (std::string tcpVariant);
+
+  /**
+   * \brief Add a round trip propagation delay to the sweep
+   *
+   * \param rttp Round trip propagation delay
+   */
+  void AddRttp (Time rttp);
+
+  /**
+   * \brief Add a bottleneck bandwidth to the sweep
+   *
+   * \param bottleneckBandwidth Bandwidth of bottleneck link in Mbps
+   */
+  void AddBottleneckBandwidth (double bottleneckBandwidth);
+
+  /**
+   * \brief Add a number of forward FTP flows to the sweep
+   *
+   * \param nFwdFtpFlows Number of forward FTP flows
+   */
+  void AddNumOfFwdFtpFlows (uint32_t nFwdFtpFlows);
+
+  /**
+   * \brief Get the number of simulations in the sweep
+   *
+   * \return the number of simulations in the sweep
+   */
+  uint32_t GetNumOfPoints (void) const;
+
+  /**
+   * \brief Runs all the simulations of the sweep
+   *
+   * Blocks until every worker process has finished and its results have
+   * been merged.
+   *
+   * \param fileName Prefix of the files where stats are dumped. The stats of
+   *                 each TCP variant are appended to fileName.<TcpVariant>
+   * \return the number of simulations that did not complete
+   */
+  uint32_t Run (std::string fileName);
+
+private:
+  /**
+   * \brief A single simulation of the sweep
+   */
+  struct SweepPoint
+  {
+    std::string tcpVariant;             //!< TCP variant
+    Time        rttp;                   //!< Round trip propagation delay
+    double      bottleneckBandwidth;    //!< Bandwidth of bottleneck link in Mbps
+    uint32_t    nFwdFtpFlows;           //!< Number of forward FTP flows
+    std::string fileName;               //!< File where the stats of this point are merged
+    std::string partFileName;           //!< File where the worker writes the stats
+  };
+
+  /**
+   * \brief Expands the sweep lists into the ordered list of points
+   *
+   * \param fileName Prefix of the files where stats are dumped
+   * \return the points of the sweep, in the order their rows are merged
+   */
+  std::vector<SweepPoint> GetPoints (std::string fileName) const;
+
+  /**
+   * \brief Simulates one point. Called in the worker process.
+   *
+   * \param point The point to be simulated
+   */
+  void RunPoint (const SweepPoint &point) const;
+
+  /**
+   * \brief Appends the stats of a finished point to its result file
+   *
+   * \param point The point whose part file is merged and removed
+   */
+  void MergePoint (const SweepPoint &point) const;
+
+  TopologyType              m_topology;             //!< Topology to be simulated
+  uint32_t                  m_maxJobs;              //!< Maximum number of worker processes
+  std::vector<std::string>  m_tcpVariants;          //!< TCP variants in the sweep
+  std::vector<Time>         m_rttps;                //!< RTTP values in the sweep
+  std::vector<double>       m_bottleneckBandwidths; //!< Bottleneck bandwidths in the sweep
+  std::vector<uint32_t>     m_nFwdFtpFlows;         //!< Forward FTP flow counts in the sweep
+};
+
+}
+
+#endif /* PARAMETER_SWEEP_H */
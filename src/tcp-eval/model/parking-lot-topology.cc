@@ -25,11 +25,14 @@
 #include <cstdlib>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "parking-lot-topology.h"
 #include "eval-stats.h"
+#include "flow-stats.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/abort.h"
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
 #include "ns3/internet-module.h"
@@ -129,10 +132,23 @@ ParkingLotTopology::CreateParkingLotTopology (Ptr<TrafficParameters> trafficPara
 
   uint32_t nCrossFtpFlow = trafficParams->GetNumOfCrossFtpFlows ();
 
+  // In a distributed or multithreaded simulation, consecutive routers, with
+  // the leaf nodes attached to them, are simulated by the same system. With
+  // as many systems as routers, every router segment is simulated by its
+  // own system, and every bottleneck link crosses systems.
+  uint32_t nRouters = BottleneckCount () + 1;
+  uint32_t nSystems = GetSystemCount ();
+  std::vector<uint32_t> routerSystemIds;
+  for (uint32_t i = 0; i < nRouters; ++i)
+    {
+      routerSystemIds.push_back ((uint64_t) i * nSystems / nRouters);
+    }
+
   PointToPointParkingLotHelper parkingLot (nLeftLeaf, pointToPointLeaf,
                                            nRightLeaf, pointToPointLeaf,
                                            BottleneckCount (), nCrossFtpFlow,
-                                           pointToPointCrossLinks, pointToPointRouter);
+                                           pointToPointCrossLinks, pointToPointRouter,
+                                           routerSystemIds);
 
   // Install Stack
   InternetStackHelper stack;
@@ -150,6 +166,16 @@ ParkingLotTopology::CreateParkingLotTopology (Ptr<TrafficParameters> trafficPara
   uint32_t offset = 0;
   Ptr<CreateTraffic> createTraffic = CreateObject<CreateTraffic> ();
 
+  // Collect per-flow statistics of FTP flows if a file is given
+  Ptr<FlowStats> flowStats;
+  if (!m_flowStatsFileName.empty ())
+    {
+      // The source and the sink of a flow are simulated by different systems
+      NS_ABORT_MSG_IF (IsPartitioned (), "Per-flow statistics are not supported in distributed simulations");
+      flowStats = CreateObject<FlowStats> (m_flowStatsFileName);
+      createTraffic->SetFlowStats (flowStats);
+    }
+
   if (nFwdFtpFlow > 0)
     {
       // Create forward FTP traffic
@@ -191,10 +217,14 @@ ParkingLotTopology::CreateParkingLotTopology (Ptr<TrafficParameters> trafficPara
 
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 
-  // Push the stats of left most router to a file
+  // Push the stats of left most router to a file, from the system simulating it
   Ptr<Node> left = parkingLot.GetRouter (0);
-  Ptr<EvalStats> evalStats = CreateObject<EvalStats> (m_bottleneckBandwidth, m_rttp , fileName);
-  evalStats->Install (left, trafficParams);
+  Ptr<EvalStats> evalStats;
+  if (IsLocal (left))
+    {
+      evalStats = CreateObject<EvalStats> (m_bottleneckBandwidth, m_rttp , fileName);
+      evalStats->Install (left, trafficParams);
+    }
 
   Simulator::Stop (Time::FromDouble (((trafficParams->GetSimulationTime ()).ToDouble (Time::S) + 5), Time::S));
   Simulator::Run ();
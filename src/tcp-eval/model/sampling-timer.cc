@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Implement a periodic timer used by the tcp-eval statistics collectors.
+
+#include "sampling-timer.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SamplingTimer");
+
+NS_OBJECT_ENSURE_REGISTERED (SamplingTimer);
+
+TypeId
+SamplingTimer::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SamplingTimer")
+    .SetParent<Object> ()
+    .SetGroupName ("TcpEvaluationSuite")
+    .AddConstructor<SamplingTimer> ()
+    .AddAttribute ("Interval",
+                   "Time between two samples",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&SamplingTimer::m_interval),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+SamplingTimer::SamplingTimer (void)
+  : m_nSamples (0)
+{
+}
+
+SamplingTimer::~SamplingTimer (void)
+{
+  m_event.Cancel ();
+}
+
+void
+SamplingTimer::DoDispose (void)
+{
+  m_event.Cancel ();
+  m_function = MakeNullCallback<void> ();
+  Object::DoDispose ();
+}
+
+void
+SamplingTimer::SetInterval (Time interval)
+{
+  m_interval = interval;
+}
+
+Time
+SamplingTimer::GetInterval (void) const
+{
+  return m_interval;
+}
+
+void
+SamplingTimer::SetFunction (Callback<void> function)
+{
+  m_function = function;
+}
+
+void
+SamplingTimer::Start (Time stopTime)
+{
+  NS_ABORT_MSG_UNLESS (m_interval.IsStrictlyPositive (), "Sampling interval must be positive");
+  m_event.Cancel ();
+  m_stopTime = stopTime;
+  m_nSamples = 0;
+  if (Simulator::Now () + m_interval <= m_stopTime)
+    {
+      m_event = Simulator::Schedule (m_interval, &SamplingTimer::Sample, this);
+    }
+}
+
+void
+SamplingTimer::Stop (void)
+{
+  m_event.Cancel ();
+}
+
+uint32_t
+SamplingTimer::GetNumOfSamples (void) const
+{
+  return m_nSamples;
+}
+
+// Schedules the next sample before invoking the function, so that the
+// function may stop the timer.
+void
+SamplingTimer::Sample (void)
+{
+  ++m_nSamples;
+  if (Simulator::Now () + m_interval <= m_stopTime)
+    {
+      m_event = Simulator::Schedule (m_interval, &SamplingTimer::Sample, this);
+    }
+  if (!m_function.IsNull ())
+    {
+      m_function ();
+    }
+}
+
+}
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Define a periodic timer used by the tcp-eval statistics collectors.
+
+#ifndef SAMPLING_TIMER_H
+#define SAMPLING_TIMER_H
+
+#include <stdint.h>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/**
+ * \brief Invokes a function periodically until a stop time.
+ *
+ * Only the next sample is scheduled at any time; each sample schedules
+ * the following one. The number of pending events therefore does not
+ * grow with the simulation time or with the sampling rate.
+ */
+class SamplingTimer : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Constructor
+   */
+  SamplingTimer (void);
+
+  /**
+   * \brief Destructor
+   */
+  ~SamplingTimer (void);
+
+  /**
+   * \brief Set the time between two samples
+   *
+   * \param interval the time between two samples
+   */
+  void SetInterval (Time interval);
+
+  /**
+   * \brief Get the time between two samples
+   *
+   * \return the time between two samples
+   */
+  Time GetInterval (void) const;
+
+  /**
+   * \brief Set the function invoked at every sample
+   *
+   * \param function the function invoked at every sample
+   */
+  void SetFunction (Callback<void> function);
+
+  /**
+   * \brief Starts sampling
+   *
+   * The first sample is taken one interval from now, and the last one
+   * at or before stopTime.
+   *
+   * \param stopTime the absolute time after which no sample is taken
+   */
+  void Start (Time stopTime);
+
+  /**
+   * \brief Cancels the pending sample, if any
+   */
+  void Stop (void);
+
+  /**
+   * \brief Get the number of samples taken since Start
+   *
+   * \return the number of samples taken since Start
+   */
+  uint32_t GetNumOfSamples (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Invokes the sampling function and schedules the next sample
+   */
+  void Sample (void);
+
+  Time           m_interval;    //!< Time between two samples
+  Time           m_stopTime;    //!< Time after which no sample is taken
+  Callback<void> m_function;    //!< Function invoked at every sample
+  EventId        m_event;       //!< The pending sample
+  uint32_t       m_nSamples;    //!< Number of samples taken since Start
+};
+
+}
+
+#endif /* SAMPLING_TIMER_H */
@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/object.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * An object with a chain of N parent types, as the protocols aggregated
+ * to a Node. Each K is a separate hierarchy, so that the objects of
+ * different K can be aggregated together.
+ */
+template <int K, int N>
+class BenchObject : public BenchObject<K, N - 1>
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId (GetName ().c_str ())
+      .SetParent<BenchObject<K, N - 1> > ()
+    ;
+    return tid;
+  }
+
+private:
+  /**
+   * \brief Get the name of the type.
+   * \return the name
+   */
+  static std::string GetName (void)
+  {
+    std::ostringstream oss;
+    oss << "ns3::BenchObject<" << K << "," << N << ">";
+    return oss.str ();
+  }
+};
+
+/** The root of a hierarchy of BenchObject types. */
+template <int K>
+class BenchObject<K, 0> : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId (GetName ().c_str ())
+      .SetParent<Object> ()
+    ;
+    return tid;
+  }
+
+private:
+  /**
+   * \brief Get the name of the type.
+   * \return the name
+   */
+  static std::string GetName (void)
+  {
+    std::ostringstream oss;
+    oss << "ns3::BenchObject<" << K << ",0>";
+    return oss.str ();
+  }
+};
+
+/** A type which is not in the aggregate. */
+class BenchMissing : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchMissing")
+      .SetParent<Object> ()
+    ;
+    return tid;
+  }
+};
+
+static Ptr<Object> g_aggregate;
+
+static void
+benchAlternate (uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (i & 1)
+        {
+          g_aggregate->GetObject<BenchObject<3, 4> > ();
+        }
+      else
+        {
+          g_aggregate->GetObject<BenchObject<4, 4> > ();
+        }
+    }
+}
+
+static void
+benchParent (uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      g_aggregate->GetObject<BenchObject<2, 0> > ();
+    }
+}
+
+static void
+benchMissing (uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      g_aggregate->GetObject<BenchMissing> ();
+    }
+}
+
+static uint64_t
+runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  (*bench) (n);
+  uint64_t deltaMs = time.End ();
+  return deltaMs;
+}
+
+
+static void
+runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      uint64_t delay = runBenchOneIteration(bench, n);
+      minDelay = std::min(minDelay, delay);
+    }
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max<uint64_t> (minDelay, 1);
+  std::cout << ps << " lookups/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the GetObject lookups in an aggregate");
+  cmd.AddValue ("n", "number of iterations", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of lookups must be specified " <<
+        "by command-line argument --n=(number of lookups)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-object with n=" << n << std::endl;
+  std::cout << "The aggregate holds 5 objects, each with 4 parent types." << std::endl;
+
+  g_aggregate = CreateObject<BenchObject<0, 4> > ();
+  g_aggregate->AggregateObject (CreateObject<BenchObject<1, 4> > ());
+  g_aggregate->AggregateObject (CreateObject<BenchObject<2, 4> > ());
+  g_aggregate->AggregateObject (CreateObject<BenchObject<3, 4> > ());
+  g_aggregate->AggregateObject (CreateObject<BenchObject<4, 4> > ());
+
+  runBench (&benchAlternate, n, minIterations, "Alternate between two objects");
+  runBench (&benchParent, n, minIterations, "Parent type of an object");
+  runBench (&benchMissing, n, minIterations, "Missing object");
+
+  g_aggregate->Dispose ();
+  g_aggregate = 0;
+  return 0;
+}
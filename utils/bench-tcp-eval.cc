@@ -0,0 +1,445 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Benchmark of the TCP evaluation suite workloads.
+//
+// Runs fixed, seeded dumbbell and parking-lot scenarios for every
+// combination of the topologies, numbers of forward FTP flows and
+// bottleneck bandwidths given on the command line, and prints one CSV
+// row per scenario on the standard output:
+//
+//   topology        dumbbell or parking-lot
+//   flows           number of forward FTP flows
+//   bandwidth_mbps  bottleneck bandwidth in Mbps
+//   sim_time_s      simulated time, in seconds
+//   setup_s         wall-clock time spent building the scenario
+//   run_s           wall-clock time spent in Simulator::Run
+//   events          number of events run
+//   events_per_s    events run per wall-clock second of Simulator::Run
+//   packets         number of packets sent on the point-to-point links
+//   packets_per_s   packets sent per wall-clock second of Simulator::Run
+//   peak_rss_kb     peak resident set size of the scenario, in KiB
+//   allocs          calls to operator new during Simulator::Run
+//   allocs_per_packet  allocs divided by packets
+//   pool_allocs_per_packet   blocks of packet memory allocated by the
+//                            PacketAllocator during Simulator::Run,
+//                            divided by packets
+//   pool_misses_per_packet   blocks of pool_allocs_per_packet which the
+//                            PacketAllocator took from operator new
+//
+// With --pcap, every point-to-point device writes a pcap trace, which
+// the ns3::PcapFileWrapper attributes may write in the background, e.g.,
+// --ns3::PcapFileWrapper::AsyncBufferSize=4194304.
+//
+// Each scenario runs in its own process, so that the peak resident set
+// size only accounts for that scenario. For example,
+//
+// ./waf --run "bench-tcp-eval --topologies=dumbbell --flows=10,100
+//              --bandwidths=10,100 --simulationTime=2"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ns3/core-module.h"
+#include "ns3/scheduler.h"
+#include "ns3/packet-allocator.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/configure-topology.h"
+#include "ns3/traffic-parameters.h"
+#include "ns3/dumbbell-topology.h"
+#include "ns3/parking-lot-topology.h"
+
+using namespace ns3;
+
+// Calls to operator new, counted by the replacements below
+static uint64_t g_allocs = 0;
+
+// Keeps the replacements of operator delete out of line: once they are
+// inlined in the callers, gcc pairs the new expressions with std::free
+// and warns of a mismatch
+#ifdef __GNUC__
+#define BENCH_NOINLINE __attribute__ ((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+void *
+operator new (std::size_t size)
+{
+  ++g_allocs;
+  void *p = std::malloc (size == 0 ? 1 : size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void *
+operator new[] (std::size_t size)
+{
+  return operator new (size);
+}
+
+BENCH_NOINLINE void
+operator delete (void *p) throw ()
+{
+  std::free (p);
+}
+
+BENCH_NOINLINE void
+operator delete[] (void *p) throw ()
+{
+  std::free (p);
+}
+
+// The sized forms, which a C++14 compiler calls instead of the above
+void
+operator delete (void *p, std::size_t) throw ()
+{
+  operator delete (p);
+}
+
+void
+operator delete[] (void *p, std::size_t) throw ()
+{
+  operator delete[] (p);
+}
+
+namespace {
+
+// Number of events run, counted by the CountingScheduler
+uint64_t g_events = 0;
+// Number of packets sent on the links
+uint64_t g_packets = 0;
+// Scheduler used by the CountingScheduler
+ObjectFactory g_schedulerFactory;
+
+/**
+ * Scheduler counting the events removed from another scheduler.
+ */
+class CountingScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  CountingScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+private:
+  Ptr<Scheduler> m_scheduler; //!< The scheduler holding the events
+};
+
+NS_OBJECT_ENSURE_REGISTERED (CountingScheduler);
+
+TypeId
+CountingScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BenchTcpEvalCountingScheduler")
+    .SetParent<Scheduler> ()
+    .AddConstructor<CountingScheduler> ()
+  ;
+  return tid;
+}
+
+CountingScheduler::CountingScheduler ()
+{
+  m_scheduler = g_schedulerFactory.Create<Scheduler> ();
+}
+
+void
+CountingScheduler::Insert (const Event &ev)
+{
+  m_scheduler->Insert (ev);
+}
+
+bool
+CountingScheduler::IsEmpty (void) const
+{
+  return m_scheduler->IsEmpty ();
+}
+
+Scheduler::Event
+CountingScheduler::PeekNext (void) const
+{
+  return m_scheduler->PeekNext ();
+}
+
+Scheduler::Event
+CountingScheduler::RemoveNext (void)
+{
+  ++g_events;
+  return m_scheduler->RemoveNext ();
+}
+
+void
+CountingScheduler::Remove (const Event &ev)
+{
+  m_scheduler->Remove (ev);
+}
+
+/** The measures of a scenario, written by the child process. */
+struct Measures
+{
+  double setup;       //!< Wall-clock seconds spent building the scenario
+  double run;         //!< Wall-clock seconds spent in Simulator::Run
+  uint64_t events;    //!< Events run
+  uint64_t packets;   //!< Packets sent on the links
+  uint64_t allocs;    //!< Calls to operator new during Simulator::Run
+  uint64_t poolAllocs; //!< Blocks allocated by the PacketAllocator
+  uint64_t poolMisses; //!< Blocks the PacketAllocator took from operator new
+};
+
+SystemWallClockMs g_clock;
+Measures g_measures;
+uint64_t g_setupEvents;
+uint64_t g_setupAllocs;
+std::string g_pcapPrefix;
+
+void
+CountPacket (Ptr<const Packet> packet)
+{
+  ++g_packets;
+}
+
+// First event of the simulation: the scenario is built, the run starts
+void
+StartRun (void)
+{
+  if (!g_pcapPrefix.empty ())
+    {
+      PointToPointHelper pointToPoint;
+      pointToPoint.EnablePcapAll (g_pcapPrefix);
+    }
+  g_measures.setup = g_clock.End () / 1000.0;
+  g_clock.Start ();
+  g_setupEvents = g_events;
+  g_setupAllocs = g_allocs;
+  PacketAllocator::ResetCounters ();
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::PointToPointNetDevice/PhyTxEnd",
+                                 MakeCallback (&CountPacket));
+}
+
+// Last event before Simulator::Destroy: the run is over
+void
+EndRun (void)
+{
+  g_measures.run = g_clock.End () / 1000.0;
+  g_measures.events = g_events - g_setupEvents;
+  g_measures.packets = g_packets;
+  g_measures.allocs = g_allocs - g_setupAllocs;
+  PacketAllocator::Counters counters = PacketAllocator::GetCounters ();
+  g_measures.poolAllocs = counters.m_allocations;
+  g_measures.poolMisses = counters.m_systemAllocations;
+}
+
+void
+RunScenario (std::string topology, uint32_t flows, double bandwidth,
+             double simTime, std::string fileName)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  Config::SetDefault ("ns3::ConfigureTopology::BottleneckBandwidth", DoubleValue (bandwidth));
+  Config::SetDefault ("ns3::TrafficParameters::FwdFtpFlows", UintegerValue (flows));
+  Config::SetDefault ("ns3::TrafficParameters::SimulationTime", TimeValue (Seconds (simTime)));
+  GlobalValue::Bind ("SchedulerType", TypeIdValue (CountingScheduler::GetTypeId ()));
+
+  g_clock.Start ();
+  Simulator::ScheduleNow (&StartRun);
+  Simulator::ScheduleDestroy (&EndRun);
+
+  Ptr<TrafficParameters> trafficParams = CreateObject<TrafficParameters> ();
+  if (topology == "parking-lot")
+    {
+      Ptr<ParkingLotTopology> parkingLot = CreateObject<ParkingLotTopology> ();
+      parkingLot->CreateParkingLotTopology (trafficParams, fileName);
+    }
+  else
+    {
+      Ptr<DumbbellTopology> dumbbell = CreateObject<DumbbellTopology> ();
+      dumbbell->CreateDumbbellTopology (trafficParams, fileName);
+    }
+}
+
+// Splits a comma separated list into its items
+template <typename T>
+std::vector<T>
+SplitList (std::string list)
+{
+  std::vector<T> items;
+  std::istringstream stream (list);
+  std::string item;
+  while (std::getline (stream, item, ','))
+    {
+      if (!item.empty ())
+        {
+          T value;
+          std::istringstream itemStream (item);
+          itemStream >> value;
+          items.push_back (value);
+        }
+    }
+  return items;
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::string topologies = "dumbbell,parking-lot";
+  std::string flows = "10,100,1000";
+  std::string bandwidths = "10,100,1000,10000";
+  std::string tcpVariant = "TcpNewReno";
+  std::string scheduler = "ns3::MapScheduler";
+  std::string fileName = "bench-tcp-eval.tmp";
+  double simTime = 1;
+  bool header = true;
+
+  ConfigureTopology::SetDefaults ();
+
+  CommandLine cmd;
+  cmd.AddValue ("topologies", "Comma separated list of topologies (dumbbell, parking-lot)", topologies);
+  cmd.AddValue ("flows", "Comma separated list of numbers of forward FTP flows", flows);
+  cmd.AddValue ("bandwidths", "Comma separated list of bottleneck bandwidths in Mbps", bandwidths);
+  cmd.AddValue ("tcpVariant", "TCP variant of the flows", tcpVariant);
+  cmd.AddValue ("scheduler", "Type of the event scheduler", scheduler);
+  cmd.AddValue ("simulationTime", "Duration of the traffic in seconds", simTime);
+  cmd.AddValue ("fileName", "Temporary file receiving the statistics of the scenarios", fileName);
+  cmd.AddValue ("header", "Print the CSV header line", header);
+  cmd.AddValue ("pcap", "Prefix of the pcap traces of all the devices, none if empty", g_pcapPrefix);
+  cmd.Parse (argc, argv);
+
+  if (!ConfigureTopology::SetTcpVariant (tcpVariant))
+    {
+      std::cerr << "Invalid TCP variant " << tcpVariant << std::endl;
+      return 1;
+    }
+  g_schedulerFactory.SetTypeId (scheduler);
+
+  std::vector<std::string> topologyList = SplitList<std::string> (topologies);
+  for (uint32_t t = 0; t < topologyList.size (); ++t)
+    {
+      if (topologyList[t] != "dumbbell" && topologyList[t] != "parking-lot")
+        {
+          std::cerr << "Invalid topology " << topologyList[t] << std::endl;
+          return 1;
+        }
+    }
+  std::vector<uint32_t> flowList = SplitList<uint32_t> (flows);
+  std::vector<double> bandwidthList = SplitList<double> (bandwidths);
+
+  if (header)
+    {
+      std::cout << "topology,flows,bandwidth_mbps,sim_time_s,setup_s,run_s,events,events_per_s,"
+                << "packets,packets_per_s,peak_rss_kb,allocs,allocs_per_packet,"
+                << "pool_allocs_per_packet,pool_misses_per_packet" << std::endl;
+    }
+
+  int status = 0;
+
+  for (uint32_t t = 0; t < topologyList.size (); ++t)
+    {
+      for (uint32_t f = 0; f < flowList.size (); ++f)
+        {
+          for (uint32_t b = 0; b < bandwidthList.size (); ++b)
+            {
+              int fds[2];
+              if (pipe (fds) != 0)
+                {
+                  std::cerr << "pipe failed: " << std::strerror (errno) << std::endl;
+                  return 1;
+                }
+
+              std::cout.flush ();
+              pid_t pid = fork ();
+              if (pid < 0)
+                {
+                  std::cerr << "fork failed: " << std::strerror (errno) << std::endl;
+                  return 1;
+                }
+              if (pid == 0)
+                {
+                  close (fds[0]);
+                  RunScenario (topologyList[t], flowList[f], bandwidthList[b], simTime, fileName);
+                  std::remove (fileName.c_str ());
+                  ssize_t written = write (fds[1], &g_measures, sizeof (g_measures));
+                  _exit (written == sizeof (g_measures) ? 0 : 1);
+                }
+              close (fds[1]);
+
+              Measures measures;
+              ssize_t nRead = read (fds[0], &measures, sizeof (measures));
+              close (fds[0]);
+
+              int childStatus;
+              struct rusage usage;
+              while (wait4 (pid, &childStatus, 0, &usage) < 0 && errno == EINTR)
+                {
+                }
+              if (nRead != sizeof (measures) || !WIFEXITED (childStatus)
+                  || WEXITSTATUS (childStatus) != 0)
+                {
+                  std::cerr << topologyList[t] << " with " << flowList[f] << " flows at "
+                            << bandwidthList[b] << " Mbps did not complete" << std::endl;
+                  status = 1;
+                  continue;
+                }
+
+              // The topologies run the simulation five seconds past the traffic
+              double run = std::max (measures.run, 1e-9);
+              double packets = std::max<double> (measures.packets, 1);
+              std::cout << topologyList[t] << ","
+                        << flowList[f] << ","
+                        << bandwidthList[b] << ","
+                        << simTime + 5 << ","
+                        << measures.setup << ","
+                        << measures.run << ","
+                        << measures.events << ","
+                        << measures.events / run << ","
+                        << measures.packets << ","
+                        << measures.packets / run << ","
+                        << usage.ru_maxrss << ","
+                        << measures.allocs << ","
+                        << measures.allocs / packets << ","
+                        << measures.poolAllocs / packets << ","
+                        << measures.poolMisses / packets << std::endl;
+            }
+        }
+    }
+
+  return status;
+}
@@ -0,0 +1,64 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 NITK Surathkal
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Print a file written by BinaryTraceFile as ascii traces, e.g.:
+//
+//   ./waf --run "binary-trace-to-ascii --input=trace.bin --output=trace.tr"
+
+#include "ns3/command-line.h"
+#include "ns3/binary-trace-file.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "The binary trace file", input);
+  cmd.AddValue ("output", "The ascii trace file, or the standard output if empty", output);
+  cmd.Parse (argc, argv);
+
+  std::ifstream is (input.c_str (), std::ios::in | std::ios::binary);
+  if (!is.is_open ())
+    {
+      std::cerr << "Unable to open " << input << std::endl;
+      return 1;
+    }
+  std::ofstream file;
+  if (!output.empty ())
+    {
+      file.open (output.c_str ());
+      if (!file.is_open ())
+        {
+          std::cerr << "Unable to open " << output << std::endl;
+          return 1;
+        }
+    }
+  std::ostream &os = output.empty () ? std::cout : file;
+  if (!BinaryTraceFile::ConvertToAscii (is, os))
+    {
+      std::cerr << input << " is not a binary trace file" << std::endl;
+      return 1;
+    }
+  return 0;
+}
@@ -53,17 +53,11 @@ while true ; do
     let "i=i+1"
 done
 
-# run a parameter change session
-# params are changing variable, scope and output file.
+# run a parameter change session. The simulations are run in parallel,
+# one per processor. params are the values of the changing variable.
 run_a_session ( ) {
 
-    for tcp_var in TcpTahoe TcpReno TcpNewReno TcpWestwood TcpWestwoodPlus
-        do
-            for var in $1  
-                do
-                    ./waf --run "drive-dumbbell --bottleneckBandwidth=$var --tcp_variant=$tcp_var --fileName=$Working_DIR/bandwidth.$tcp_var"
-            done
-    done
+    ./waf --run "drive-sweep --topology=Dumbbell --tcpVariants=TcpTahoe,TcpReno,TcpNewReno,TcpWestwood,TcpWestwoodPlus --bottleneckBandwidth=${1// /,} --fileName=$Working_DIR/bandwidth"
 }
 
 # dwaw an eps graph
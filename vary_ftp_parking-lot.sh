@@ -52,17 +52,11 @@ while true ; do
     let "i=i+1"
 done
 
-# run a parameter change session
-# params are changing variable, scope and output file.
+# run a parameter change session. The simulations are run in parallel,
+# one per processor. params are the values of the changing variable.
 run_a_session ( ) {
 
-    for tcp_var in TcpTahoe TcpReno TcpNewReno TcpWestwood TcpWestwoodPlus
-        do
-            for var in $1  
-                do
-                    ./waf --run "drive-parking-lot --nFwdFtpFlows=$var --tcp_variant=$tcp_var --fileName=$Working_DIR/ftp.$tcp_var"
-            done
-    done
+    ./waf --run "drive-sweep --topology=ParkingLot --tcpVariants=TcpTahoe,TcpReno,TcpNewReno,TcpWestwood,TcpWestwoodPlus --nFwdFtpFlows=${1// /,} --fileName=$Working_DIR/ftp"
 }
 
 # dwaw an eps graph